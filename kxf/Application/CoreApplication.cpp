@@ -7,6 +7,7 @@
 #include "kxf/EventSystem/IEventExecutor.h"
 #include "kxf/EventSystem/IdleEvent.h"
 #include "kxf/Core/Enumerator.h"
+#include "kxf/Core/Async/TimerWheel.h"
 #include "kxf/System/NativeAPI.h"
 #include "kxf/System/NtStatus.h"
 #include "kxf/System/DynamicLibrary.h"
@@ -222,6 +223,9 @@ namespace kxf
 		// the base class 'OnExit'.
 		FinalizeScheduledForDestruction();
 
+		// Stop the timer thread while it's still safe to join it
+		Async::TimerWheel::GetInstance().Stop();
+
 		if (m_NativeAppInitialized && !m_NativeAppCleanedUp)
 		{
 			if (auto app = wxAppConsole::GetInstance())
@@ -125,7 +125,25 @@ namespace kxf
 			{
 				return m_LastRead ? m_LastRead : m_Stream->LastRead();
 			}
+			void SetLastRead(DataSize lastRead) override
+			{
+				m_LastRead = lastRead;
+			}
 			IInputStream& Read(void* buffer, size_t size) override;
+			IInputStream& Read(IOutputStream& other) override
+			{
+				// Go through the decompressing 'Read' instead of forwarding to the underlying stream
+				return IInputStream::Read(other);
+			}
+			IInputStream& ReadV(std::span<const std::span<std::byte>> buffers) override
+			{
+				return IInputStream::ReadV(buffers);
+			}
+			std::span<const std::byte> ReadView(size_t size) override
+			{
+				// Decompressed data is never available as a view of the underlying stream
+				return {};
+			}
 	};
 }
 
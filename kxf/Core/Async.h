@@ -1,4 +1,6 @@
 #pragma once
 #include "Async/Common.h"
+#include "Async/Task.h"
+#include "Async/Scheduler.h"
 #include "Async/Coroutine.h"
 #include "Async/DelayedCall.h"
@@ -1,2 +1,2 @@
 #pragma once
-#include "kxf/Async/Coroutine/Coroutine.h"
+#include "Coroutine/Coroutine.h"
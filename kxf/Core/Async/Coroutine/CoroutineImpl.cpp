@@ -1,40 +1,8 @@
 #include "KxfPCH.h"
 #include "CoroutineImpl.h"
-#include "kxf/Application/ICoreApplication.h"
+#include "../Scheduler.h"
 #include <chrono>
 
-namespace kxf::Async
-{
-	void CoroutineTimer::OnNotify()
-	{
-		CoroutineBase::QueueExecution(std::move(m_Coroutine));
-	}
-
-	std::unique_ptr<CoroutineBase> CoroutineTimer::Relinquish()
-	{
-		Stop();
-		return std::move(m_Coroutine);
-	}
-	void CoroutineTimer::Wait(std::unique_ptr<CoroutineBase> coroutine, const TimeSpan& time)
-	{
-		m_Coroutine = std::move(coroutine);
-		Start(time);
-	}
-}
-
-namespace kxf::Async
-{
-	CoroutineExecutor::CoroutineExecutor(std::unique_ptr<CoroutineBase> coroutine)
-		:m_Coroutine(std::move(coroutine))
-	{
-	}
-
-	void CoroutineExecutor::Execute()
-	{
-		m_Coroutine->RunExecute(std::move(m_Coroutine));
-	}
-}
-
 namespace kxf::Async
 {
 	CoroutineBase* CoroutineBase::Run(std::unique_ptr<CoroutineBase> coroutine)
@@ -42,32 +10,44 @@ namespace kxf::Async
 		if (coroutine)
 		{
 			CoroutineBase& ref = *coroutine;
-			QueueExecution(std::move(coroutine));
+			Spawn(EventLoopScheduler::GetInstance(), RunLoop(std::move(coroutine)));
 			return &ref;
 		}
 		return nullptr;
 	}
 
-	void CoroutineBase::QueueExecution(std::unique_ptr<CoroutineBase> coroutine)
-	{
-		ICoreApplication::GetInstance()->QueueEvent(std::make_unique<CoroutineExecutor>(std::move(coroutine)));
-	}
-	void CoroutineBase::DelayExecution(std::unique_ptr<CoroutineBase> coroutine, const TimeSpan& time)
+	Task<void> CoroutineBase::RunLoop(std::unique_ptr<CoroutineBase> coroutine)
 	{
-		if (time.IsPositive())
-		{
-			CoroutineBase& ref = *coroutine;
-			ref.m_DelayTimer.Wait(std::move(coroutine), time);
-		}
-		else
+		// Each step is resumed from the batched event loop queue and delays are serviced by the shared timer wheel.
+		// The coroutine object is destroyed when the loop ends, on the main thread.
+		while (coroutine->m_Instruction.GetType() != InstructionType::Terminate)
 		{
-			QueueExecution(std::move(coroutine));
+			coroutine->BeforeExecute();
+			coroutine->m_Instruction = coroutine->Execute();
+			coroutine->AfterExecute();
+
+			switch (coroutine->m_Instruction.GetType())
+			{
+				case InstructionType::Delay:
+				{
+					if (TimeSpan delay = coroutine->m_Instruction.GetDelay(); delay.IsPositive())
+					{
+						co_await Delay(delay);
+					}
+					else
+					{
+						co_await Reschedule();
+					}
+					break;
+				}
+				case InstructionType::Continue:
+				{
+					co_await Reschedule();
+					break;
+				}
+			};
 		}
 	}
-	void CoroutineBase::AbortExecution(std::unique_ptr<CoroutineBase> coroutine)
-	{
-		wxApp::GetInstance()->ScheduleForDestruction(coroutine.release());
-	}
 
 	void CoroutineBase::BeforeExecute()
 	{
@@ -88,37 +68,6 @@ namespace kxf::Async
 	{
 		m_TimeStampAfter = GetCurrentExecutionTime();
 	}
-	void CoroutineBase::RunExecute(std::unique_ptr<CoroutineBase> coroutine)
-	{
-		if (m_Instruction.GetType() == InstructionType::Terminate)
-		{
-			AbortExecution(std::move(coroutine));
-			return;
-		}
-
-		BeforeExecute();
-		m_Instruction = Execute();
-		AfterExecute();
-
-		switch (m_Instruction.GetType())
-		{
-			case InstructionType::Delay:
-			{
-				DelayExecution(std::move(coroutine), m_Instruction.GetDelay());
-				break;
-			}
-			case InstructionType::Continue:
-			{
-				QueueExecution(std::move(coroutine));
-				break;
-			}
-			default:
-			{
-				AbortExecution(std::move(coroutine));
-				break;
-			}
-		};
-	}
 
 	TimeSpan CoroutineBase::GetCurrentExecutionTime() const
 	{
@@ -135,12 +84,8 @@ namespace kxf::Async
 
 	void CoroutineBase::Terminate()
 	{
+		// A delayed coroutine is destroyed once its delay expires
 		m_Instruction = CoroutineBase::YieldStop();
-
-		if (m_DelayTimer.IsRunning())
-		{
-			AbortExecution(m_DelayTimer.Relinquish());
-		}
 	}
 	
 	TimeSpan CoroutineBase::GetTimeDelta() const
@@ -1,7 +1,6 @@
 #pragma once
 #include "../Common.h"
-#include "kxf/EventSystem/GenericTimer.h"
-#include "kxf/EventSystem/IndirectInvocationEvent.h"
+#include "../Task.h"
 #include "YieldInstruction.h"
 #include <utility>
 #include <optional>
@@ -11,52 +10,11 @@ namespace kxf
 {
 	class Coroutine;
 }
-namespace kxf::Async
-{
-	class CoroutineBase;
-}
-
-namespace kxf::Async
-{
-	class KX_API CoroutineTimer final: public GenericTimer
-	{
-		private:
-			std::unique_ptr<CoroutineBase> m_Coroutine;
-
-		protected:
-			void OnNotify() override;
-
-		public:
-			void Wait(std::unique_ptr<CoroutineBase> coroutine, const TimeSpan& time);
-			std::unique_ptr<CoroutineBase> Relinquish();
-	};
-	class KX_API CoroutineExecutor final: public EventSystem::IndirectInvocationEvent
-	{
-		private:
-			std::unique_ptr<CoroutineBase> m_Coroutine;
-
-		public:
-			CoroutineExecutor(std::unique_ptr<CoroutineBase> coroutine);
-
-		public:
-			// IEvent
-			std::unique_ptr<IEvent> Move() noexcept override
-			{
-				return std::make_unique<CoroutineExecutor>(std::move(*this));
-			}
-
-			// IIndirectInvocationEvent
-			void Execute() override;
-	};
-}
 
 namespace kxf::Async
 {
 	class KX_API CoroutineBase: public wxObject
 	{
-		friend class CoroutineTimer;
-		friend class CoroutineExecutor;
-
 		public:
 			static CoroutineBase* Run(std::unique_ptr<CoroutineBase> coroutine);
 
@@ -81,12 +39,9 @@ namespace kxf::Async
 			}
 
 		private:
-			static void QueueExecution(std::unique_ptr<CoroutineBase> coroutine);
-			static void DelayExecution(std::unique_ptr<CoroutineBase> coroutine, const TimeSpan& time);
-			static void AbortExecution(std::unique_ptr<CoroutineBase> coroutine);
+			static Task<void> RunLoop(std::unique_ptr<CoroutineBase> coroutine);
 
 		private:
-			CoroutineTimer m_DelayTimer;
 			YieldInstruction m_Instruction;
 			TimeSpan m_TimeStampStart;
 			TimeSpan m_TimeStampBefore;
@@ -95,7 +50,6 @@ namespace kxf::Async
 		private:
 			void BeforeExecute();
 			void AfterExecute();
-			void RunExecute(std::unique_ptr<CoroutineBase> coroutine);
 
 			TimeSpan GetCurrentExecutionTime() const;
 
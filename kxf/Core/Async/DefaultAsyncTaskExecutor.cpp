@@ -44,7 +44,7 @@ namespace kxf
 				if (!shouldTerminate)
 				{
 					task = std::move(m_TaskQueue.front());
-					m_TaskQueue.pop_back();
+					m_TaskQueue.erase(m_TaskQueue.begin());
 				}
 			}
 
@@ -92,11 +92,8 @@ namespace kxf
 	}
 	bool DefaultAsyncTaskExecutor::IsRunning() const
 	{
-		if (std::unique_lock lock(m_ThreadPoolLock); m_ThreadPool.empty())
-		{
-			return true;
-		}
-		return false;
+		std::unique_lock lock(m_ThreadPoolLock);
+		return !m_ThreadPool.empty();
 	}
 
 	std::shared_ptr<IAsyncTask> DefaultAsyncTaskExecutor::QueueTask(AsyncTaskInfo task)
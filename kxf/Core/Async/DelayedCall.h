@@ -1,6 +1,7 @@
 #pragma once
 #include "Common.h"
-#include "Coroutine.h"
+#include "Task.h"
+#include "Scheduler.h"
 
 namespace kxf::Async
 {
@@ -8,23 +9,10 @@ namespace kxf::Async
 	requires(std::is_invocable_r_v<void, TCallable>)
 	static void DelayedCall(TCallable&& func, TimeSpan delay)
 	{
-		enum class State
+		Spawn(EventLoopScheduler::GetInstance(), [](std::decay_t<TCallable> func, TimeSpan delay) -> Task<void>
 		{
-			Wait,
-			Execute
-		};
-
-		Coroutine::Run([delay, func = std::forward<TCallable>(func)](Coroutine& coroutine)
-		{
-			if (coroutine.GetNextState<State::Execute>())
-			{
-				std::invoke(func);
-				return Coroutine::YieldStop();
-			}
-			else
-			{
-				return Coroutine::YieldWait(delay, State::Execute);
-			}
-		});
+			co_await Delay(delay);
+			std::invoke(func);
+		}(std::forward<TCallable>(func), delay));
 	}
 }
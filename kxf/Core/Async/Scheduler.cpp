@@ -0,0 +1,66 @@
+#include "KxfPCH.h"
+#include "Scheduler.h"
+#include "kxf/Threading/IThreadPool.h"
+#include "kxf/Application/ICoreApplication.h"
+
+namespace kxf::Async
+{
+	void ThreadPoolScheduler::Schedule(std::coroutine_handle<> handle)
+	{
+		// A stopped pool accepts tasks but never runs them, resume the coroutine right here instead of losing it
+		if (!m_ThreadPool->IsRunning() || !m_ThreadPool->AddTask([handle]()
+		{
+			handle.resume();
+		}))
+		{
+			handle.resume();
+		}
+	}
+}
+
+namespace kxf::Async
+{
+	EventLoopScheduler& EventLoopScheduler::GetInstance()
+	{
+		static EventLoopScheduler instance;
+		return instance;
+	}
+
+	void EventLoopScheduler::ProcessQueue()
+	{
+		// Coroutines scheduled while processing this batch go to the next event loop iteration
+		decltype(m_Queue) queue;
+		if (std::unique_lock lock(m_QueueLock); true)
+		{
+			queue.swap(m_Queue);
+			m_IsPosted = false;
+		}
+
+		for (std::coroutine_handle<> handle: queue)
+		{
+			handle.resume();
+		}
+	}
+
+	void EventLoopScheduler::Schedule(std::coroutine_handle<> handle)
+	{
+		bool shouldPost = false;
+		if (std::unique_lock lock(m_QueueLock); true)
+		{
+			m_Queue.push_back(handle);
+			if (!m_IsPosted)
+			{
+				m_IsPosted = true;
+				shouldPost = true;
+			}
+		}
+
+		if (shouldPost)
+		{
+			ICoreApplication::GetInstance()->CallAfter([this]()
+			{
+				ProcessQueue();
+			});
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Common.h"
+#include <coroutine>
+#include <mutex>
+
+namespace kxf
+{
+	class IThreadPool;
+}
+
+namespace kxf::Async
+{
+	class KX_API IScheduler
+	{
+		public:
+			virtual ~IScheduler() = default;
+
+		public:
+			virtual void Schedule(std::coroutine_handle<> handle) = 0;
+	};
+}
+
+namespace kxf::Async
+{
+	// Resumes coroutines on the given thread pool, or inline if the pool isn't running or refuses the task
+	class KX_API ThreadPoolScheduler final: public IScheduler
+	{
+		private:
+			std::shared_ptr<IThreadPool> m_ThreadPool;
+
+		public:
+			ThreadPoolScheduler(std::shared_ptr<IThreadPool> threadPool) noexcept
+				:m_ThreadPool(std::move(threadPool))
+			{
+			}
+
+		public:
+			void Schedule(std::coroutine_handle<> handle) override;
+
+			std::shared_ptr<IThreadPool> GetThreadPool() const noexcept
+			{
+				return m_ThreadPool;
+			}
+	};
+
+	// Resumes coroutines on the next iteration of the application event loop. All coroutines scheduled before
+	// the next iteration share a single queued event instead of posting one event per resumption.
+	class KX_API EventLoopScheduler final: public IScheduler
+	{
+		public:
+			static EventLoopScheduler& GetInstance();
+
+		private:
+			std::vector<std::coroutine_handle<>> m_Queue;
+			std::mutex m_QueueLock;
+			bool m_IsPosted = false;
+
+		private:
+			void ProcessQueue();
+
+		public:
+			EventLoopScheduler() = default;
+			EventLoopScheduler(const EventLoopScheduler&) = delete;
+
+		public:
+			void Schedule(std::coroutine_handle<> handle) override;
+
+		public:
+			EventLoopScheduler& operator=(const EventLoopScheduler&) = delete;
+	};
+}
@@ -0,0 +1,538 @@
+#pragma once
+#include "Common.h"
+#include "Scheduler.h"
+#include "TimerWheel.h"
+#include "kxf/Threading/IThreadPool.h"
+#include "kxf/IO/IStream.h"
+#include <coroutine>
+
+namespace kxf::Async
+{
+	template<class T = void>
+	class Task;
+}
+
+namespace kxf::Async::Private
+{
+	template<class TPromise>
+	IScheduler* GetPromiseScheduler(std::coroutine_handle<TPromise> handle) noexcept
+	{
+		if constexpr(requires { handle.promise().GetScheduler(); })
+		{
+			return handle.promise().GetScheduler();
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	inline void ResumeOn(IScheduler* scheduler, std::coroutine_handle<> handle)
+	{
+		if (scheduler)
+		{
+			scheduler->Schedule(handle);
+		}
+		else
+		{
+			handle.resume();
+		}
+	}
+
+	class TaskPromiseBase
+	{
+		private:
+			struct FinalAwaiter final
+			{
+				bool await_ready() const noexcept
+				{
+					return false;
+				}
+
+				template<class TPromise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept
+				{
+					if (auto continuation = handle.promise().m_Continuation)
+					{
+						return continuation;
+					}
+					return std::noop_coroutine();
+				}
+
+				void await_resume() const noexcept
+				{
+				}
+			};
+
+		protected:
+			std::coroutine_handle<> m_Continuation;
+			std::exception_ptr m_Exception;
+			IScheduler* m_Scheduler = nullptr;
+
+		protected:
+			void RethrowIfFailed() const
+			{
+				if (m_Exception)
+				{
+					std::rethrow_exception(m_Exception);
+				}
+			}
+
+		public:
+			std::suspend_always initial_suspend() const noexcept
+			{
+				return {};
+			}
+			FinalAwaiter final_suspend() const noexcept
+			{
+				return {};
+			}
+			void unhandled_exception() noexcept
+			{
+				m_Exception = std::current_exception();
+			}
+
+		public:
+			IScheduler* GetScheduler() const noexcept
+			{
+				return m_Scheduler;
+			}
+			void SetScheduler(IScheduler* scheduler) noexcept
+			{
+				m_Scheduler = scheduler;
+			}
+			void SetContinuation(std::coroutine_handle<> continuation) noexcept
+			{
+				m_Continuation = continuation;
+			}
+	};
+
+	template<class T>
+	class TaskPromise final: public TaskPromiseBase
+	{
+		private:
+			std::optional<T> m_Value;
+
+		public:
+			Task<T> get_return_object() noexcept;
+
+			template<class TValue>
+			requires(std::is_constructible_v<T, TValue>)
+			void return_value(TValue&& value)
+			{
+				m_Value.emplace(std::forward<TValue>(value));
+			}
+
+			T TakeResult()
+			{
+				RethrowIfFailed();
+				return std::move(*m_Value);
+			}
+	};
+
+	template<>
+	class TaskPromise<void> final: public TaskPromiseBase
+	{
+		public:
+			Task<void> get_return_object() noexcept;
+
+			void return_void() noexcept
+			{
+			}
+
+			void TakeResult()
+			{
+				RethrowIfFailed();
+			}
+	};
+
+	// Fire-and-forget coroutine used by 'Spawn', destroys itself when finished
+	class DetachedTask final
+	{
+		public:
+			class promise_type final
+			{
+				private:
+					IScheduler* m_Scheduler = nullptr;
+
+				public:
+					DetachedTask get_return_object() const noexcept
+					{
+						return {};
+					}
+					std::suspend_never initial_suspend() const noexcept
+					{
+						return {};
+					}
+					std::suspend_never final_suspend() const noexcept
+					{
+						return {};
+					}
+					void return_void() const noexcept
+					{
+					}
+					void unhandled_exception() const noexcept
+					{
+						// Same as an exception escaping a thread function, there's nobody to report it to
+						std::terminate();
+					}
+
+				public:
+					IScheduler* GetScheduler() const noexcept
+					{
+						return m_Scheduler;
+					}
+					void SetScheduler(IScheduler* scheduler) noexcept
+					{
+						m_Scheduler = scheduler;
+					}
+			};
+	};
+}
+
+namespace kxf::Async
+{
+	// Lazily started coroutine, it begins executing when it's awaited and inherits the scheduler of the awaiting coroutine.
+	// Use 'Spawn' to start a task from non-coroutine code.
+	template<class T>
+	class Task final
+	{
+		public:
+			using promise_type = Private::TaskPromise<T>;
+
+		private:
+			class Awaiter final
+			{
+				private:
+					std::coroutine_handle<promise_type> m_Handle;
+
+				public:
+					Awaiter(std::coroutine_handle<promise_type> handle) noexcept
+						:m_Handle(handle)
+					{
+					}
+
+				public:
+					bool await_ready() const noexcept
+					{
+						return !m_Handle || m_Handle.done();
+					}
+
+					template<class TPromise>
+					std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> caller) noexcept
+					{
+						auto& promise = m_Handle.promise();
+						promise.SetContinuation(caller);
+						promise.SetScheduler(Private::GetPromiseScheduler(caller));
+
+						return m_Handle;
+					}
+
+					T await_resume()
+					{
+						return m_Handle.promise().TakeResult();
+					}
+			};
+
+		private:
+			std::coroutine_handle<promise_type> m_Handle;
+
+		public:
+			Task() noexcept = default;
+			explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+				:m_Handle(handle)
+			{
+			}
+			Task(Task&& other) noexcept
+				:m_Handle(std::exchange(other.m_Handle, nullptr))
+			{
+			}
+			Task(const Task&) = delete;
+			~Task()
+			{
+				if (m_Handle)
+				{
+					m_Handle.destroy();
+				}
+			}
+
+		public:
+			bool IsNull() const noexcept
+			{
+				return !m_Handle;
+			}
+			bool IsCompleted() const noexcept
+			{
+				return m_Handle && m_Handle.done();
+			}
+
+		public:
+			explicit operator bool() const noexcept
+			{
+				return !IsNull();
+			}
+			bool operator!() const noexcept
+			{
+				return IsNull();
+			}
+
+			Awaiter operator co_await() const noexcept
+			{
+				return m_Handle;
+			}
+
+			Task& operator=(Task&& other) noexcept
+			{
+				if (this != &other)
+				{
+					if (m_Handle)
+					{
+						m_Handle.destroy();
+					}
+					m_Handle = std::exchange(other.m_Handle, nullptr);
+				}
+				return *this;
+			}
+			Task& operator=(const Task&) = delete;
+	};
+}
+
+namespace kxf::Async::Private
+{
+	template<class T>
+	Task<T> TaskPromise<T>::get_return_object() noexcept
+	{
+		return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+	}
+
+	inline Task<void> TaskPromise<void>::get_return_object() noexcept
+	{
+		return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+	}
+}
+
+namespace kxf::Async::Private
+{
+	class SwitchToAwaiter final
+	{
+		private:
+			IScheduler* m_Scheduler = nullptr;
+
+		public:
+			SwitchToAwaiter(IScheduler& scheduler) noexcept
+				:m_Scheduler(&scheduler)
+			{
+			}
+
+		public:
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			template<class TPromise>
+			void await_suspend(std::coroutine_handle<TPromise> handle)
+			{
+				if constexpr(requires { handle.promise().SetScheduler(m_Scheduler); })
+				{
+					handle.promise().SetScheduler(m_Scheduler);
+				}
+				m_Scheduler->Schedule(handle);
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+	};
+
+	class RescheduleAwaiter final
+	{
+		public:
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			template<class TPromise>
+			bool await_suspend(std::coroutine_handle<TPromise> handle)
+			{
+				if (auto scheduler = GetPromiseScheduler(handle))
+				{
+					scheduler->Schedule(handle);
+					return true;
+				}
+				return false;
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+	};
+
+	class DelayAwaiter final
+	{
+		private:
+			TimeSpan m_Delay;
+
+		public:
+			DelayAwaiter(TimeSpan delay) noexcept
+				:m_Delay(delay)
+			{
+			}
+
+		public:
+			bool await_ready() const noexcept
+			{
+				return !m_Delay.IsPositive();
+			}
+
+			template<class TPromise>
+			void await_suspend(std::coroutine_handle<TPromise> handle)
+			{
+				TimerWheel::GetInstance().Schedule(m_Delay, [handle, scheduler = GetPromiseScheduler(handle)]()
+				{
+					ResumeOn(scheduler, handle);
+				});
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+	};
+
+	template<class TFunc>
+	class RunOnAwaiter final
+	{
+		private:
+			using TResult = std::invoke_result_t<TFunc&>;
+			using TStorage = std::conditional_t<std::is_void_v<TResult>, std::monostate, TResult>;
+
+		private:
+			IThreadPool& m_ThreadPool;
+			TFunc m_Func;
+			std::optional<TStorage> m_Result;
+			std::exception_ptr m_Exception;
+
+		public:
+			RunOnAwaiter(IThreadPool& threadPool, TFunc func)
+				:m_ThreadPool(threadPool), m_Func(std::move(func))
+			{
+			}
+
+		private:
+			void Invoke() noexcept
+			{
+				try
+				{
+					if constexpr(std::is_void_v<TResult>)
+					{
+						std::invoke(m_Func);
+						m_Result.emplace();
+					}
+					else
+					{
+						m_Result.emplace(std::invoke(m_Func));
+					}
+				}
+				catch (...)
+				{
+					m_Exception = std::current_exception();
+				}
+			}
+
+		public:
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			template<class TPromise>
+			bool await_suspend(std::coroutine_handle<TPromise> handle)
+			{
+				// The task can resume the coroutine before 'AddTask' even returns, nothing of 'this' is touched after that
+				if (m_ThreadPool.IsRunning() && m_ThreadPool.AddTask([this, handle, scheduler = GetPromiseScheduler(handle)]()
+				{
+					Invoke();
+					ResumeOn(scheduler, handle);
+				}))
+				{
+					return true;
+				}
+
+				// A stopped pool would never run the task, call the function here and continue without suspending
+				Invoke();
+				return false;
+			}
+
+			TResult await_resume()
+			{
+				if (m_Exception)
+				{
+					std::rethrow_exception(m_Exception);
+				}
+
+				if constexpr(!std::is_void_v<TResult>)
+				{
+					return std::move(*m_Result);
+				}
+			}
+	};
+}
+
+namespace kxf::Async
+{
+	// Suspends the current coroutine and resumes it on the given scheduler which becomes
+	// the current scheduler for this coroutine and all tasks it awaits afterwards.
+	inline Private::SwitchToAwaiter SwitchTo(IScheduler& scheduler) noexcept
+	{
+		return scheduler;
+	}
+
+	// Reschedules the current coroutine on its current scheduler, does nothing if there's no scheduler
+	inline Private::RescheduleAwaiter Reschedule() noexcept
+	{
+		return {};
+	}
+
+	// Resumes the current coroutine on its current scheduler after the delay has passed, the delay is serviced
+	// by the shared timer wheel. Coroutines without a scheduler are resumed on the timer thread itself.
+	inline Private::DelayAwaiter Delay(TimeSpan delay) noexcept
+	{
+		return delay;
+	}
+
+	// Runs the function on the thread pool and resumes the current coroutine on its current scheduler once it has finished
+	template<class TFunc>
+	requires(std::is_invocable_v<std::decay_t<TFunc>&>)
+	Private::RunOnAwaiter<std::decay_t<TFunc>> RunOn(IThreadPool& threadPool, TFunc&& func)
+	{
+		return {threadPool, std::forward<TFunc>(func)};
+	}
+
+	// Blocking stream operations performed on the thread pool, the result is the amount of data actually transferred
+	inline auto Read(IThreadPool& threadPool, IInputStream& stream, void* buffer, size_t size)
+	{
+		return RunOn(threadPool, [&stream, buffer, size]()
+		{
+			return stream.Read(buffer, size).LastRead();
+		});
+	}
+	inline auto Write(IThreadPool& threadPool, IOutputStream& stream, const void* buffer, size_t size)
+	{
+		return RunOn(threadPool, [&stream, buffer, size]()
+		{
+			return stream.Write(buffer, size).LastWrite();
+		});
+	}
+
+	// Starts the task on the given scheduler without waiting for it. Unhandled exceptions terminate the process.
+	template<class T>
+	void Spawn(IScheduler& scheduler, Task<T> task)
+	{
+		[](IScheduler& scheduler, Task<T> task) -> Private::DetachedTask
+		{
+			co_await SwitchTo(scheduler);
+			co_await task;
+		}(scheduler, std::move(task));
+	}
+}
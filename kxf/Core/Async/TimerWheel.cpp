@@ -0,0 +1,161 @@
+#include "KxfPCH.h"
+#include "TimerWheel.h"
+
+namespace kxf::Async
+{
+	TimerWheel& TimerWheel::GetInstance()
+	{
+		static TimerWheel instance;
+		return instance;
+	}
+
+	uint64_t TimerWheel::GetTickNow() const noexcept
+	{
+		return static_cast<uint64_t>((TClock::now() - m_StartTime) / m_Resolution);
+	}
+	uint64_t TimerWheel::FindNextDeadline() const noexcept
+	{
+		uint64_t deadline = ms_NoDeadline;
+		for (size_t i = 0; i < m_OccupiedSlots.size(); i++)
+		{
+			for (uint64_t bits = m_OccupiedSlots[i]; bits != 0; bits &= bits - 1)
+			{
+				deadline = std::min(deadline, m_SlotDeadlines[i * 64 + std::countr_zero(bits)]);
+			}
+		}
+		return deadline;
+	}
+	void TimerWheel::ExpireSlot(size_t index, std::vector<std::move_only_function<void()>>& expired)
+	{
+		auto& slot = m_Slots[index];
+
+		uint64_t slotDeadline = ms_NoDeadline;
+		for (size_t i = 0; i < slot.size();)
+		{
+			if (slot[i].Deadline <= m_CurrentTick)
+			{
+				expired.emplace_back(std::move(slot[i].Callback));
+				slot[i] = std::move(slot.back());
+				slot.pop_back();
+				m_EntryCount--;
+			}
+			else
+			{
+				slotDeadline = std::min(slotDeadline, slot[i].Deadline);
+				i++;
+			}
+		}
+
+		m_SlotDeadlines[index] = slotDeadline;
+		if (slot.empty())
+		{
+			m_OccupiedSlots[index / 64] &= ~(uint64_t(1) << (index % 64));
+		}
+	}
+	void TimerWheel::OnThread(std::stop_token stopToken)
+	{
+		std::vector<std::move_only_function<void()>> expired;
+
+		std::unique_lock lock(m_Lock);
+		while (!stopToken.stop_requested())
+		{
+			if (m_EntryCount == 0)
+			{
+				m_Condition.wait(lock, stopToken, [&]()
+				{
+					return m_EntryCount != 0;
+				});
+				continue;
+			}
+
+			// Sleep until the earliest timer is due, 'Schedule' wakes us up if an earlier one is added
+			const uint64_t tickNow = GetTickNow();
+			if (m_NextDeadline > tickNow)
+			{
+				m_Condition.wait_until(lock, stopToken, m_StartTime + m_Resolution * m_NextDeadline, [&, deadline = m_NextDeadline]()
+				{
+					return m_NextDeadline != deadline;
+				});
+				continue;
+			}
+
+			// Advance the wheel up to the current time collecting everything that has expired,
+			// nothing can expire before the cached deadline so the ticks in between are skipped.
+			m_CurrentTick = std::max(m_CurrentTick, m_NextDeadline);
+			for (; m_CurrentTick <= tickNow && m_EntryCount != 0; m_CurrentTick++)
+			{
+				ExpireSlot(m_CurrentTick % ms_SlotCount, expired);
+			}
+			m_NextDeadline = FindNextDeadline();
+
+			if (!expired.empty())
+			{
+				lock.unlock();
+				for (auto& callback: expired)
+				{
+					std::invoke(callback);
+				}
+				expired.clear();
+				lock.lock();
+			}
+		}
+	}
+
+	TimerWheel::TimerWheel(TimeSpan resolution)
+		:m_Resolution(std::chrono::milliseconds(std::max<int64_t>(resolution.GetMilliseconds(), 1))), m_StartTime(TClock::now())
+	{
+		m_SlotDeadlines.fill(ms_NoDeadline);
+	}
+	TimerWheel::~TimerWheel()
+	{
+		Stop();
+	}
+
+	void TimerWheel::Schedule(TimeSpan delay, std::move_only_function<void()> callback)
+	{
+		const uint64_t ticks = static_cast<uint64_t>(std::max<int64_t>((std::chrono::milliseconds(delay.GetMilliseconds()) + m_Resolution - std::chrono::milliseconds(1)) / m_Resolution, 1));
+
+		if (std::unique_lock lock(m_Lock); true)
+		{
+			// The wheel doesn't advance while it's empty, catch up with the current time first
+			const uint64_t tickNow = GetTickNow();
+			if (m_EntryCount == 0)
+			{
+				m_CurrentTick = tickNow;
+			}
+
+			const uint64_t deadline = tickNow + ticks;
+			const size_t index = deadline % ms_SlotCount;
+			m_Slots[index].emplace_back(Entry{deadline, std::move(callback)});
+			m_SlotDeadlines[index] = std::min(m_SlotDeadlines[index], deadline);
+			m_OccupiedSlots[index / 64] |= uint64_t(1) << (index % 64);
+			m_NextDeadline = std::min(m_NextDeadline, deadline);
+			m_EntryCount++;
+
+			if (!m_Thread.joinable())
+			{
+				m_Thread = std::jthread([this](std::stop_token stopToken)
+				{
+					OnThread(std::move(stopToken));
+				});
+			}
+		}
+		m_Condition.notify_one();
+	}
+	void TimerWheel::Stop()
+	{
+		// Joined outside of the lock, the thread needs it to see the stop request. A 'Schedule' call in the meantime
+		// starts a new thread with its own stop token.
+		std::jthread thread;
+		if (std::unique_lock lock(m_Lock); true)
+		{
+			thread = std::move(m_Thread);
+		}
+
+		if (thread.joinable())
+		{
+			thread.request_stop();
+			thread.join();
+		}
+	}
+}
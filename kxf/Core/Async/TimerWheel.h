@@ -0,0 +1,69 @@
+#pragma once
+#include "Common.h"
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <stop_token>
+#include <condition_variable>
+
+namespace kxf::Async
+{
+	// Hashed timer wheel serviced by a single background thread. Callbacks are invoked on that thread
+	// so they should only hand the work off somewhere else (resume a coroutine on its scheduler, queue an event, etc).
+	// The thread is started by the first 'Schedule' call and has to be stopped with 'Stop' before the library is unloaded,
+	// joining it from the static destructor would deadlock on the loader lock.
+	class KX_API TimerWheel final
+	{
+		public:
+			static TimerWheel& GetInstance();
+
+		private:
+			static constexpr size_t ms_SlotCount = 512;
+			static constexpr uint64_t ms_NoDeadline = std::numeric_limits<uint64_t>::max();
+
+			using TClock = std::chrono::steady_clock;
+			struct Entry final
+			{
+				uint64_t Deadline = 0;
+				std::move_only_function<void()> Callback;
+			};
+
+		private:
+			const TClock::duration m_Resolution;
+			const TClock::time_point m_StartTime;
+
+			// Earliest deadline of each slot and a bit per non-empty slot, finding the next deadline doesn't depend on the number of timers
+			std::array<std::vector<Entry>, ms_SlotCount> m_Slots;
+			std::array<uint64_t, ms_SlotCount> m_SlotDeadlines;
+			std::array<uint64_t, ms_SlotCount / 64> m_OccupiedSlots = {};
+
+			uint64_t m_CurrentTick = 0;
+			uint64_t m_NextDeadline = ms_NoDeadline;
+			size_t m_EntryCount = 0;
+
+			std::mutex m_Lock;
+			std::condition_variable_any m_Condition;
+			std::jthread m_Thread;
+
+		private:
+			uint64_t GetTickNow() const noexcept;
+			uint64_t FindNextDeadline() const noexcept;
+			void ExpireSlot(size_t index, std::vector<std::move_only_function<void()>>& expired);
+
+			void OnThread(std::stop_token stopToken);
+
+		public:
+			TimerWheel(TimeSpan resolution = TimeSpan::Milliseconds(1));
+			TimerWheel(const TimerWheel&) = delete;
+			~TimerWheel();
+
+		public:
+			void Schedule(TimeSpan delay, std::move_only_function<void()> callback);
+
+			// Stops the service thread, pending timers are kept and the thread is started again on the next 'Schedule' call
+			void Stop();
+
+		public:
+			TimerWheel& operator=(const TimerWheel&) = delete;
+	};
+}
@@ -0,0 +1,454 @@
+#include "KxfPCH.h"
+#include "WorkStealingTaskExecutor.h"
+#include "WorkStealingAsyncTask.h"
+
+namespace
+{
+	constexpr size_t g_SpinCount = 64;
+	constexpr size_t g_MaxInjectedBatch = 32;
+	constexpr size_t g_MaxPooledTasks = 4096;
+}
+
+namespace kxf
+{
+	// Recycles task allocations (the task object and its shared pointer control block are allocated together).
+	// Freed blocks are pushed onto a lock-free stack by any thread. Only one thread at a time is allowed to pop
+	// from it which makes the stack immune to the ABA problem, other allocating threads simply fall back to
+	// the global allocator while the pop guard is taken.
+	class WorkStealingTaskExecutor::TaskPool final
+	{
+		private:
+			struct Node final
+			{
+				Node* Next = nullptr;
+			};
+
+		private:
+			std::atomic<Node*> m_FreeList = nullptr;
+			std::atomic<size_t> m_FreeCount = 0;
+			std::atomic<size_t> m_BlockSize = 0;
+			std::atomic_flag m_PopGuard;
+
+		public:
+			TaskPool() noexcept = default;
+			TaskPool(const TaskPool&) = delete;
+			~TaskPool()
+			{
+				Node* node = m_FreeList.exchange(nullptr, std::memory_order_acquire);
+				while (node)
+				{
+					Node* next = node->Next;
+					::operator delete(node);
+					node = next;
+				}
+			}
+
+		public:
+			void* Allocate(size_t size)
+			{
+				size_t blockSize = m_BlockSize.load(std::memory_order_relaxed);
+				if (blockSize == 0)
+				{
+					m_BlockSize.compare_exchange_strong(blockSize, size, std::memory_order_relaxed);
+					blockSize = m_BlockSize.load(std::memory_order_relaxed);
+				}
+
+				if (size == blockSize && !m_PopGuard.test_and_set(std::memory_order_acquire))
+				{
+					Node* node = m_FreeList.load(std::memory_order_acquire);
+					while (node && !m_FreeList.compare_exchange_weak(node, node->Next, std::memory_order_acquire, std::memory_order_acquire))
+					{
+					}
+					m_PopGuard.clear(std::memory_order_release);
+
+					if (node)
+					{
+						m_FreeCount.fetch_sub(1, std::memory_order_relaxed);
+						return node;
+					}
+				}
+				return ::operator new(std::max(size, sizeof(Node)));
+			}
+			void Deallocate(void* ptr, size_t size) noexcept
+			{
+				if (size == m_BlockSize.load(std::memory_order_relaxed) && m_FreeCount.fetch_add(1, std::memory_order_relaxed) < g_MaxPooledTasks)
+				{
+					Node* node = static_cast<Node*>(ptr);
+					node->Next = m_FreeList.load(std::memory_order_relaxed);
+					while (!m_FreeList.compare_exchange_weak(node->Next, node, std::memory_order_release, std::memory_order_relaxed))
+					{
+					}
+				}
+				else
+				{
+					if (size == m_BlockSize.load(std::memory_order_relaxed))
+					{
+						m_FreeCount.fetch_sub(1, std::memory_order_relaxed);
+					}
+					::operator delete(ptr);
+				}
+			}
+
+		public:
+			TaskPool& operator=(const TaskPool&) = delete;
+	};
+}
+
+namespace
+{
+	template<class T>
+	class TaskPoolAllocator final
+	{
+		template<class Tx>
+		friend class TaskPoolAllocator;
+
+		static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+		private:
+			std::shared_ptr<kxf::WorkStealingTaskExecutor::TaskPool> m_Pool;
+
+		public:
+			using value_type = T;
+
+		public:
+			TaskPoolAllocator(std::shared_ptr<kxf::WorkStealingTaskExecutor::TaskPool> pool) noexcept
+				:m_Pool(std::move(pool))
+			{
+			}
+
+			template<class Tx>
+			TaskPoolAllocator(const TaskPoolAllocator<Tx>& other) noexcept
+				:m_Pool(other.m_Pool)
+			{
+			}
+
+		public:
+			T* allocate(size_t count)
+			{
+				return static_cast<T*>(m_Pool->Allocate(count * sizeof(T)));
+			}
+			void deallocate(T* ptr, size_t count) noexcept
+			{
+				m_Pool->Deallocate(ptr, count * sizeof(T));
+			}
+
+		public:
+			template<class Tx>
+			bool operator==(const TaskPoolAllocator<Tx>& other) const noexcept
+			{
+				return m_Pool == other.m_Pool;
+			}
+	};
+
+	thread_local void* g_CurrentWorker = nullptr;
+
+	uint32_t NextRandom(uint32_t& state) noexcept
+	{
+		// Xorshift32
+		uint32_t value = state;
+		value ^= value << 13;
+		value ^= value >> 17;
+		value ^= value << 5;
+
+		state = value;
+		return value;
+	}
+}
+
+namespace kxf
+{
+	void WorkStealingTaskExecutor::OnQueue(WorkStealingAsyncTask& task)
+	{
+		task.m_QueueTime = TimeSpan::Now();
+		task.m_TaskExecutor = QueryInterface<IAsyncTaskExecutor>();
+	}
+	void WorkStealingTaskExecutor::OnStartup(WorkStealingAsyncTask& task)
+	{
+		task.m_StartupTime = TimeSpan::Now();
+		task.m_ExecutingThread = SystemThread::GetCurrentThread();
+	}
+	void WorkStealingTaskExecutor::OnCompleted(WorkStealingAsyncTask& task, bool terminated)
+	{
+		task.m_CompletionTime = TimeSpan::Now();
+
+		if (std::unique_lock lock(task.m_WaitLock); true)
+		{
+			task.m_IsCompleted = !terminated;
+			task.m_IsTerminated = terminated;
+			task.m_ShouldWait = false;
+		}
+		task.m_WaitCondition.notify_all();
+	}
+
+	void WorkStealingTaskExecutor::OnThread(Worker& worker)
+	{
+		g_CurrentWorker = &worker;
+
+		while (!m_ShouldTerminate)
+		{
+			if (auto task = FindTask(worker))
+			{
+				Execute(task);
+				continue;
+			}
+
+			// Spin for a little while before going to sleep, new work usually arrives in bursts
+			WorkStealingAsyncTask* task = nullptr;
+			for (size_t i = 0; i < g_SpinCount && !task && !m_ShouldTerminate; i++)
+			{
+				std::this_thread::yield();
+				task = FindTask(worker);
+			}
+
+			if (task)
+			{
+				Execute(task);
+			}
+			else if (std::unique_lock lock(m_SleepLock); true)
+			{
+				m_SleepingCount++;
+				m_SleepCondition.wait(lock, [&]()
+				{
+					return m_PendingCount != 0 || m_ShouldTerminate;
+				});
+				m_SleepingCount--;
+			}
+		}
+
+		g_CurrentWorker = nullptr;
+	}
+	void WorkStealingTaskExecutor::Execute(WorkStealingAsyncTask* task)
+	{
+		m_PendingCount--;
+
+		auto ref = std::move(task->m_QueueRef);
+		OnStartup(*task);
+		task->m_TaskResult = task->m_TaskInfo.Execute(ref);
+		OnCompleted(*task, task->m_ShouldTerminate);
+	}
+	void WorkStealingTaskExecutor::Submit(WorkStealingAsyncTask* task)
+	{
+		// Count the task before it becomes visible to the workers so the pending counter never underflows
+		m_PendingCount++;
+
+		if (auto worker = static_cast<Worker*>(g_CurrentWorker); worker && worker->Executor == this)
+		{
+			worker->Queue.Push(task);
+		}
+		else if (std::unique_lock lock(m_InjectionQueueLock); true)
+		{
+			m_InjectionQueue.push_back(task);
+			m_InjectedCount++;
+		}
+		WakeWorker();
+	}
+	void WorkStealingTaskExecutor::WakeWorker()
+	{
+		if (m_SleepingCount != 0)
+		{
+			// Taking the lock guarantees the sleeping worker is either already waiting or will see the new task
+			if (std::unique_lock lock(m_SleepLock); true)
+			{
+			}
+			m_SleepCondition.notify_one();
+		}
+	}
+	void WorkStealingTaskExecutor::Abandon(WorkStealingAsyncTask* task)
+	{
+		m_PendingCount--;
+
+		auto ref = std::move(task->m_QueueRef);
+		OnCompleted(*task, true);
+	}
+
+	WorkStealingAsyncTask* WorkStealingTaskExecutor::FindTask(Worker& worker)
+	{
+		if (auto task = worker.Queue.Pop())
+		{
+			return *task;
+		}
+		else if (auto task = TakeInjected(worker))
+		{
+			return task;
+		}
+		return StealTask(worker);
+	}
+	WorkStealingAsyncTask* WorkStealingTaskExecutor::TakeInjected(Worker& worker)
+	{
+		if (m_InjectedCount == 0)
+		{
+			return nullptr;
+		}
+
+		if (std::unique_lock lock(m_InjectionQueueLock); !m_InjectionQueue.empty())
+		{
+			WorkStealingAsyncTask* task = m_InjectionQueue.front();
+			m_InjectionQueue.pop_front();
+
+			// Grab a fair share of the remaining tasks into the local queue, so the lock is taken less often
+			// and other workers have something to steal.
+			size_t count = std::min(m_InjectionQueue.size() / m_Workers.size(), g_MaxInjectedBatch);
+			for (size_t i = 0; i < count; i++)
+			{
+				worker.Queue.Push(m_InjectionQueue.front());
+				m_InjectionQueue.pop_front();
+			}
+			m_InjectedCount -= count + 1;
+
+			return task;
+		}
+		return nullptr;
+	}
+	WorkStealingAsyncTask* WorkStealingTaskExecutor::StealTask(Worker& worker)
+	{
+		const size_t count = m_Workers.size();
+		const size_t start = NextRandom(worker.RandomState) % count;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			Worker& victim = *m_Workers[(start + i) % count];
+			if (&victim != &worker)
+			{
+				if (auto task = victim.Queue.Steal())
+				{
+					return *task;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	WorkStealingTaskExecutor::WorkStealingTaskExecutor()
+		:WorkStealingTaskExecutor(0)
+	{
+	}
+	WorkStealingTaskExecutor::WorkStealingTaskExecutor(size_t concurrency)
+		:m_TaskPool(std::make_shared<TaskPool>()), m_Concurrency(concurrency)
+	{
+		if (concurrency == 0)
+		{
+			m_Concurrency = std::thread::hardware_concurrency();
+		}
+	}
+	WorkStealingTaskExecutor::~WorkStealingTaskExecutor()
+	{
+		Terminate();
+
+		if (std::unique_lock lock(m_InjectionQueueLock); true)
+		{
+			for (WorkStealingAsyncTask* task: m_InjectionQueue)
+			{
+				Abandon(task);
+			}
+			m_InjectionQueue.clear();
+			m_InjectedCount = 0;
+		}
+	}
+
+	// IAsyncTaskExecutor
+	void WorkStealingTaskExecutor::Run()
+	{
+		if (std::unique_lock lock(m_WorkersLock); m_Workers.empty())
+		{
+			// All workers must exist before any thread starts since they will be looking at each other's queues
+			m_Workers.reserve(m_Concurrency);
+			for (size_t i = 0; i < m_Concurrency; i++)
+			{
+				auto& worker = m_Workers.emplace_back(std::make_unique<Worker>());
+				worker->Executor = this;
+				worker->Index = i;
+				worker->RandomState = static_cast<uint32_t>(i * 0x9E3779B9u + 1);
+			}
+			for (auto& worker: m_Workers)
+			{
+				worker->Thread = std::thread([this, worker = worker.get()]()
+				{
+					OnThread(*worker);
+				});
+			}
+		}
+	}
+	void WorkStealingTaskExecutor::Terminate()
+	{
+		if (std::unique_lock lock(m_WorkersLock); !m_Workers.empty())
+		{
+			m_ShouldTerminate = true;
+
+			// Wake up all threads
+			if (std::unique_lock sleepLock(m_SleepLock); true)
+			{
+			}
+			m_SleepCondition.notify_all();
+
+			// Join all threads
+			for (auto& worker: m_Workers)
+			{
+				worker->Thread.join();
+			}
+
+			// Move the tasks left in the local queues back to the injection queue, they will be picked up on the next run
+			if (std::unique_lock injectionLock(m_InjectionQueueLock); true)
+			{
+				for (auto& worker: m_Workers)
+				{
+					while (auto task = worker->Queue.Pop())
+					{
+						m_InjectionQueue.push_back(*task);
+						m_InjectedCount++;
+					}
+				}
+			}
+
+			m_Workers.clear();
+			m_ShouldTerminate = false;
+		}
+	}
+	bool WorkStealingTaskExecutor::IsRunning() const
+	{
+		std::unique_lock lock(m_WorkersLock);
+		return !m_Workers.empty();
+	}
+
+	std::shared_ptr<IAsyncTask> WorkStealingTaskExecutor::QueueTask(AsyncTaskInfo task)
+	{
+		if (task)
+		{
+			auto ptr = std::allocate_shared<WorkStealingAsyncTask>(TaskPoolAllocator<WorkStealingAsyncTask>(m_TaskPool), std::move(task));
+			OnQueue(*ptr);
+			ptr->m_QueueRef = ptr;
+
+			Submit(ptr.get());
+			return ptr;
+		}
+		return nullptr;
+	}
+
+	// IThreadPool
+	size_t WorkStealingTaskExecutor::GetConcurrency() const
+	{
+		return m_Concurrency;
+	}
+	bool WorkStealingTaskExecutor::SetConcurrency(size_t concurrency)
+	{
+		if (concurrency == 0)
+		{
+			return false;
+		}
+
+		if (std::unique_lock lock(m_WorkersLock); m_Workers.empty())
+		{
+			m_Concurrency = concurrency;
+			return true;
+		}
+		return false;
+	}
+
+	std::shared_ptr<IAsyncTask> WorkStealingTaskExecutor::AddTask(std::move_only_function<void()> task)
+	{
+		if (task)
+		{
+			return QueueTask(AsyncTaskInfo(std::move(task)));
+		}
+		return nullptr;
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Common.h"
+#include "kxf/Core/IAsyncTask.h"
+#include "kxf/Core/IAsyncTaskExecutor.h"
+#include "kxf/Threading/IThreadPool.h"
+#include "kxf/Threading/WorkStealingQueue.h"
+#include <thread>
+#include <mutex>
+#include <deque>
+
+namespace kxf
+{
+	class WorkStealingAsyncTask;
+}
+
+namespace kxf
+{
+	// Thread pool where each worker owns a work-stealing deque. Tasks queued from a worker thread go into
+	// its own deque, tasks queued from any other thread go into the shared injection queue. Idle workers
+	// steal from each other before going to sleep.
+	class KX_API WorkStealingTaskExecutor final: public RTTI::DynamicImplementation<WorkStealingTaskExecutor, IAsyncTaskExecutor, IThreadPool>
+	{
+		public:
+			class TaskPool;
+
+		private:
+			struct Worker final
+			{
+				WorkStealingTaskExecutor* Executor = nullptr;
+				WorkStealingQueue<WorkStealingAsyncTask*> Queue;
+				std::thread Thread;
+				size_t Index = 0;
+				uint32_t RandomState = 0;
+			};
+
+		private:
+			std::vector<std::unique_ptr<Worker>> m_Workers;
+			mutable std::mutex m_WorkersLock;
+
+			std::deque<WorkStealingAsyncTask*> m_InjectionQueue;
+			std::atomic<size_t> m_InjectedCount = 0;
+			std::mutex m_InjectionQueueLock;
+
+			std::atomic<size_t> m_PendingCount = 0;
+			std::atomic<size_t> m_SleepingCount = 0;
+			std::condition_variable m_SleepCondition;
+			std::mutex m_SleepLock;
+
+			std::shared_ptr<TaskPool> m_TaskPool;
+			size_t m_Concurrency = 0;
+			std::atomic<bool> m_ShouldTerminate = false;
+
+		private:
+			void OnQueue(WorkStealingAsyncTask& task);
+			void OnStartup(WorkStealingAsyncTask& task);
+			void OnCompleted(WorkStealingAsyncTask& task, bool terminated);
+
+			void OnThread(Worker& worker);
+			void Execute(WorkStealingAsyncTask* task);
+			void Submit(WorkStealingAsyncTask* task);
+			void WakeWorker();
+			void Abandon(WorkStealingAsyncTask* task);
+
+			WorkStealingAsyncTask* FindTask(Worker& worker);
+			WorkStealingAsyncTask* TakeInjected(Worker& worker);
+			WorkStealingAsyncTask* StealTask(Worker& worker);
+
+		public:
+			WorkStealingTaskExecutor();
+			WorkStealingTaskExecutor(size_t concurrency);
+			WorkStealingTaskExecutor(const WorkStealingTaskExecutor&) = delete;
+			~WorkStealingTaskExecutor();
+
+		public:
+			// IAsyncTaskExecutor
+			void Run() override;
+			void Terminate() override;
+			bool IsRunning() const override;
+
+			std::shared_ptr<IAsyncTask> QueueTask(AsyncTaskInfo task) override;
+
+			// IThreadPool
+			void* GetHandle() const override
+			{
+				return nullptr;
+			}
+			size_t GetConcurrency() const override;
+			bool SetConcurrency(size_t concurrency) override;
+
+			std::shared_ptr<IAsyncTask> AddTask(std::move_only_function<void()> task) override;
+
+		public:
+			WorkStealingTaskExecutor& operator=(const WorkStealingTaskExecutor&) = delete;
+	};
+}
@@ -0,0 +1,82 @@
+#include "KxfPCH.h"
+#include "Atom.h"
+
+namespace
+{
+	using kxf::Private::AtomEntry;
+
+	// Fixed set of buckets, each one is a singly linked list which only ever grows at its head. Readers never lock,
+	// writers publish a fully constructed entry with a single CAS, so an entry once seen stays valid and unchanged.
+	constexpr size_t g_BucketCount = 16384;
+	std::atomic<const AtomEntry*> g_Buckets[g_BucketCount];
+
+	std::atomic<const AtomEntry*>& GetBucket(size_t hash) noexcept
+	{
+		return g_Buckets[hash % g_BucketCount];
+	}
+	const AtomEntry* FindEntry(const AtomEntry* entry, const AtomEntry* last, kxf::StringView value, size_t hash) noexcept
+	{
+		for (; entry != last; entry = entry->Next)
+		{
+			if (entry->Hash == hash && entry->Value.view() == value)
+			{
+				return entry;
+			}
+		}
+		return nullptr;
+	}
+}
+
+namespace kxf
+{
+	Atom Atom::Find(StringView value) noexcept
+	{
+		if (!value.empty())
+		{
+			const size_t hash = std::hash<StringView>()(value);
+			return FindEntry(GetBucket(hash).load(std::memory_order_acquire), nullptr, value, hash);
+		}
+		return {};
+	}
+
+	Atom::Atom(StringView value)
+	{
+		if (value.empty())
+		{
+			return;
+		}
+
+		const size_t hash = std::hash<StringView>()(value);
+		auto& bucket = GetBucket(hash);
+
+		const AtomEntry* head = bucket.load(std::memory_order_acquire);
+		if (auto entry = FindEntry(head, nullptr, value, hash))
+		{
+			m_Entry = entry;
+			return;
+		}
+
+		auto entry = std::make_unique<AtomEntry>();
+		entry->Value = value;
+		entry->UTF8 = entry->Value.ToUTF8();
+		entry->Hash = hash;
+
+		while (true)
+		{
+			const AtomEntry* oldHead = head;
+			entry->Next = oldHead;
+			if (bucket.compare_exchange_weak(head, entry.get(), std::memory_order_release, std::memory_order_acquire))
+			{
+				m_Entry = entry.release();
+				return;
+			}
+
+			// Someone got in first, only the entries added since the last look need to be checked
+			if (auto existingEntry = FindEntry(head, oldHead, value, hash))
+			{
+				m_Entry = existingEntry;
+				return;
+			}
+		}
+	}
+}
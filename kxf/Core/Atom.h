@@ -0,0 +1,114 @@
+#pragma once
+#include "Common.h"
+#include "String.h"
+
+namespace kxf::Private
+{
+	struct AtomEntry final
+	{
+		String Value;
+		std::string UTF8;
+		size_t Hash = 0;
+		const AtomEntry* Next = nullptr;
+	};
+}
+
+namespace kxf
+{
+	// Interned string. Atoms made from equal strings share the same table entry, so comparing and hashing them costs nothing.
+	// Entries are never released, atoms are meant for bounded sets of identifiers (registered event IDs and such) rather than arbitrary text.
+	class KX_API Atom final
+	{
+		public:
+			// Returns an already interned atom or a null one, the table is left untouched
+			static Atom Find(StringView value) noexcept;
+
+		private:
+			const Private::AtomEntry* m_Entry = nullptr;
+
+		private:
+			Atom(const Private::AtomEntry* entry) noexcept
+				:m_Entry(entry)
+			{
+			}
+
+		public:
+			Atom() noexcept = default;
+			explicit Atom(StringView value);
+			explicit Atom(const String& value)
+				:Atom(value.view())
+			{
+			}
+			explicit Atom(const XChar* value)
+				:Atom(StringView(value))
+			{
+			}
+			explicit Atom(const char* value)
+				:Atom(String(value))
+			{
+			}
+
+		public:
+			bool IsNull() const noexcept
+			{
+				return m_Entry == nullptr;
+			}
+
+			const String& GetString() const noexcept
+			{
+				return m_Entry ? m_Entry->Value : NullString;
+			}
+			StringView GetView() const noexcept
+			{
+				return m_Entry ? m_Entry->Value.view() : StringView();
+			}
+
+			// Null-terminated UTF-8 form of the string, converted once at interning
+			std::string_view GetUTF8() const noexcept
+			{
+				return m_Entry ? std::string_view(m_Entry->UTF8) : std::string_view("", 0);
+			}
+
+			// Same as 'std::hash<String>' of the string
+			size_t GetHash() const noexcept
+			{
+				return m_Entry ? m_Entry->Hash : 0;
+			}
+
+		public:
+			explicit operator bool() const noexcept
+			{
+				return !IsNull();
+			}
+			bool operator!() const noexcept
+			{
+				return IsNull();
+			}
+
+			// Ordered by the string content to not depend on the interning order
+			std::strong_ordering operator<=>(const Atom& other) const noexcept
+			{
+				if (m_Entry == other.m_Entry)
+				{
+					return std::strong_ordering::equal;
+				}
+				return GetView() <=> other.GetView();
+			}
+			bool operator==(const Atom& other) const noexcept
+			{
+				return m_Entry == other.m_Entry;
+			}
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<kxf::Atom> final
+	{
+		size_t operator()(const kxf::Atom& atom) const noexcept
+		{
+			return atom.GetHash();
+		}
+	};
+}
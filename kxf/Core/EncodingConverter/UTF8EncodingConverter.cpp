@@ -0,0 +1,490 @@
+#include "KxfPCH.h"
+#include "UTF8EncodingConverter.h"
+#include "kxf/System/SystemInformation.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#define KXF_UTF8_X86 1
+#endif
+
+namespace
+{
+	using namespace kxf;
+
+	constexpr char32_t g_ReplacementChar = 0xFFFD;
+
+	template<class TChar>
+	constexpr bool IsUTF16() noexcept
+	{
+		static_assert(sizeof(TChar) == sizeof(char16_t) || sizeof(TChar) == sizeof(char32_t), "unsupported code unit size");
+		return sizeof(TChar) == sizeof(char16_t);
+	}
+
+	#if KXF_UTF8_X86
+	// ASCII kernels process whole blocks and stop at the first block containing anything else, the scalar code
+	// takes over from there. Nothing is written past the converted blocks.
+	template<class TChar>
+	size_t WidenASCII_SSE2(const uint8_t* data, size_t size, TChar* buffer) noexcept
+	{
+		const __m128i zero = _mm_setzero_si128();
+
+		size_t i = 0;
+		for (; size - i >= 16; i += 16)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			if (_mm_movemask_epi8(chunk) != 0)
+			{
+				break;
+			}
+
+			const __m128i low = _mm_unpacklo_epi8(chunk, zero);
+			const __m128i high = _mm_unpackhi_epi8(chunk, zero);
+			if constexpr(IsUTF16<TChar>())
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i), low);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i + 8), high);
+			}
+			else
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i), _mm_unpacklo_epi16(low, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i + 4), _mm_unpackhi_epi16(low, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i + 8), _mm_unpacklo_epi16(high, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i + 12), _mm_unpackhi_epi16(high, zero));
+			}
+		}
+		return i;
+	}
+
+	template<class TChar>
+	size_t WidenASCII_AVX2(const uint8_t* data, size_t size, TChar* buffer) noexcept
+	{
+		size_t i = 0;
+		for (; size - i >= 32; i += 32)
+		{
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			if (_mm256_movemask_epi8(chunk) != 0)
+			{
+				break;
+			}
+
+			if constexpr(IsUTF16<TChar>())
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer + i), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chunk)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chunk, 1)));
+			}
+			else
+			{
+				for (size_t j = 0; j < 32; j += 8)
+				{
+					const __m128i part = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i + j));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer + i + j), _mm256_cvtepu8_epi32(part));
+				}
+			}
+		}
+		_mm256_zeroupper();
+
+		return i;
+	}
+
+	template<class TChar>
+	size_t NarrowASCII_SSE2(const TChar* data, size_t length, uint8_t* buffer) noexcept
+	{
+		size_t i = 0;
+		for (; length - i >= 16; i += 16)
+		{
+			auto Load = [&](size_t offset)
+			{
+				return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + offset));
+			};
+
+			__m128i packed = {};
+			if constexpr(IsUTF16<TChar>())
+			{
+				const __m128i a = Load(0);
+				const __m128i b = Load(8);
+
+				const __m128i nonASCII = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonASCII, _mm_setzero_si128())) != 0xFFFF)
+				{
+					break;
+				}
+				packed = _mm_packus_epi16(a, b);
+			}
+			else
+			{
+				const __m128i a = Load(0);
+				const __m128i b = Load(4);
+				const __m128i c = Load(8);
+				const __m128i d = Load(12);
+
+				const __m128i nonASCII = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(nonASCII, _mm_setzero_si128())) != 0xFFFF)
+				{
+					break;
+				}
+				packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i), packed);
+		}
+		return i;
+	}
+
+	template<class TChar>
+	size_t NarrowASCII_AVX2(const TChar* data, size_t length, uint8_t* buffer) noexcept
+	{
+		constexpr size_t step = IsUTF16<TChar>() ? 32 : 16;
+
+		size_t i = 0;
+		for (; length - i >= step; i += step)
+		{
+			const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + step / 2));
+
+			const __m256i mask = IsUTF16<TChar>() ? _mm256_set1_epi16(static_cast<short>(0xFF80)) : _mm256_set1_epi32(static_cast<int>(0xFFFFFF80));
+			if (!_mm256_testz_si256(_mm256_or_si256(a, b), mask))
+			{
+				break;
+			}
+
+			// Packing works within 128-bit lanes, the permutation puts the 64-bit parts back in order
+			if constexpr(IsUTF16<TChar>())
+			{
+				const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0b11'01'10'00);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer + i), packed);
+			}
+			else
+			{
+				const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0b11'01'10'00);
+				const __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i), bytes);
+			}
+		}
+		_mm256_zeroupper();
+
+		return i;
+	}
+	#endif
+
+	// Converts the leading ASCII characters and returns their count. Without the buffer only counts them.
+	template<class TChar>
+	size_t WidenASCII(const uint8_t* data, size_t size, TChar* buffer) noexcept
+	{
+		size_t i = 0;
+
+		#if KXF_UTF8_X86
+		static const bool hasAVX2 = System::HasFeature(ProcessorFeature::AVX2);
+		static const bool hasSSE2 = System::HasFeature(ProcessorFeature::SSE2);
+
+		if (!buffer)
+		{
+			if (hasSSE2)
+			{
+				for (; size - i >= 16; i += 16)
+				{
+					const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+					if (const uint32_t mask = _mm_movemask_epi8(chunk); mask != 0)
+					{
+						return i + std::countr_zero(mask);
+					}
+				}
+			}
+		}
+		else
+		{
+			if (hasAVX2 && size >= 64)
+			{
+				i += WidenASCII_AVX2(data, size, buffer);
+			}
+			if (hasSSE2)
+			{
+				i += WidenASCII_SSE2(data + i, size - i, buffer + i);
+			}
+		}
+		#endif
+
+		for (; i < size && data[i] < 0x80u; i++)
+		{
+			if (buffer)
+			{
+				buffer[i] = static_cast<TChar>(data[i]);
+			}
+		}
+		return i;
+	}
+
+	template<class TChar>
+	size_t NarrowASCII(const TChar* data, size_t length, uint8_t* buffer) noexcept
+	{
+		size_t i = 0;
+
+		#if KXF_UTF8_X86
+		static const bool hasAVX2 = System::HasFeature(ProcessorFeature::AVX2);
+		static const bool hasSSE2 = System::HasFeature(ProcessorFeature::SSE2);
+
+		if (buffer)
+		{
+			if (hasAVX2 && length >= 64)
+			{
+				i += NarrowASCII_AVX2(data, length, buffer);
+			}
+			if (hasSSE2)
+			{
+				i += NarrowASCII_SSE2(data + i, length - i, buffer + i);
+			}
+		}
+		#endif
+
+		for (; i < length && static_cast<uint32_t>(data[i]) < 0x80u; i++)
+		{
+			if (buffer)
+			{
+				buffer[i] = static_cast<uint8_t>(data[i]);
+			}
+		}
+		return i;
+	}
+
+	// Without the buffer calculates the output length only
+	template<class TChar>
+	size_t DecodeUTF8(const uint8_t* data, size_t size, TChar* buffer) noexcept
+	{
+		size_t length = 0;
+		auto Put = [&](char32_t c) noexcept
+		{
+			if constexpr(IsUTF16<TChar>())
+			{
+				if (c >= 0x10000)
+				{
+					if (buffer)
+					{
+						c -= 0x10000;
+						buffer[length] = static_cast<TChar>(0xD800 + (c >> 10));
+						buffer[length + 1] = static_cast<TChar>(0xDC00 + (c & 0x3FF));
+					}
+					length += 2;
+					return;
+				}
+			}
+
+			if (buffer)
+			{
+				buffer[length] = static_cast<TChar>(c);
+			}
+			length++;
+		};
+
+		size_t i = 0;
+		while (i < size)
+		{
+			const uint8_t lead = data[i];
+			if (lead < 0x80u)
+			{
+				const size_t count = WidenASCII(data + i, size - i, buffer ? buffer + length : nullptr);
+				i += count;
+				length += count;
+
+				continue;
+			}
+
+			// Well-formed sequences as per the Unicode standard, table 3-7. The range of the second byte is narrowed
+			// for some lead bytes to exclude overlong forms, surrogates and code points above U+10FFFF.
+			size_t trailCount = 0;
+			char32_t c = 0;
+			uint8_t lower = 0x80u;
+			uint8_t upper = 0xBFu;
+
+			if (lead >= 0xC2u && lead <= 0xDFu)
+			{
+				trailCount = 1;
+				c = lead & 0x1Fu;
+			}
+			else if (lead >= 0xE0u && lead <= 0xEFu)
+			{
+				trailCount = 2;
+				c = lead & 0x0Fu;
+				if (lead == 0xE0u)
+				{
+					lower = 0xA0u;
+				}
+				else if (lead == 0xEDu)
+				{
+					upper = 0x9Fu;
+				}
+			}
+			else if (lead >= 0xF0u && lead <= 0xF4u)
+			{
+				trailCount = 3;
+				c = lead & 0x07u;
+				if (lead == 0xF0u)
+				{
+					lower = 0x90u;
+				}
+				else if (lead == 0xF4u)
+				{
+					upper = 0x8Fu;
+				}
+			}
+			else
+			{
+				Put(g_ReplacementChar);
+				i++;
+
+				continue;
+			}
+
+			// A truncated or broken sequence is replaced as a whole, decoding resumes from the offending byte
+			size_t j = 1;
+			for (; j <= trailCount && i + j < size; j++)
+			{
+				const uint8_t trail = data[i + j];
+				if (trail < lower || trail > upper)
+				{
+					break;
+				}
+
+				c = (c << 6)|(trail & 0x3Fu);
+				lower = 0x80u;
+				upper = 0xBFu;
+			}
+
+			Put(j > trailCount ? c : g_ReplacementChar);
+			i += j;
+		}
+		return length;
+	}
+
+	template<class TChar>
+	size_t EncodeUTF8(const TChar* data, size_t length, uint8_t* buffer) noexcept
+	{
+		size_t size = 0;
+		auto Put = [&](char32_t c) noexcept
+		{
+			if (c < 0x800)
+			{
+				if (buffer)
+				{
+					buffer[size] = static_cast<uint8_t>(0xC0u|(c >> 6));
+					buffer[size + 1] = static_cast<uint8_t>(0x80u|(c & 0x3Fu));
+				}
+				size += 2;
+			}
+			else if (c < 0x10000)
+			{
+				if (buffer)
+				{
+					buffer[size] = static_cast<uint8_t>(0xE0u|(c >> 12));
+					buffer[size + 1] = static_cast<uint8_t>(0x80u|((c >> 6) & 0x3Fu));
+					buffer[size + 2] = static_cast<uint8_t>(0x80u|(c & 0x3Fu));
+				}
+				size += 3;
+			}
+			else
+			{
+				if (buffer)
+				{
+					buffer[size] = static_cast<uint8_t>(0xF0u|(c >> 18));
+					buffer[size + 1] = static_cast<uint8_t>(0x80u|((c >> 12) & 0x3Fu));
+					buffer[size + 2] = static_cast<uint8_t>(0x80u|((c >> 6) & 0x3Fu));
+					buffer[size + 3] = static_cast<uint8_t>(0x80u|(c & 0x3Fu));
+				}
+				size += 4;
+			}
+		};
+
+		size_t i = 0;
+		while (i < length)
+		{
+			const char32_t c = static_cast<uint32_t>(data[i]);
+			if (c < 0x80)
+			{
+				const size_t count = NarrowASCII(data + i, length - i, buffer ? buffer + size : nullptr);
+				i += count;
+				size += count;
+
+				continue;
+			}
+
+			if (c >= 0xD800 && c <= 0xDFFF)
+			{
+				if constexpr(IsUTF16<TChar>())
+				{
+					if (c <= 0xDBFF && i + 1 < length)
+					{
+						const char32_t low = static_cast<uint32_t>(data[i + 1]);
+						if (low >= 0xDC00 && low <= 0xDFFF)
+						{
+							Put(0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00));
+							i += 2;
+
+							continue;
+						}
+					}
+				}
+
+				// Unpaired surrogate
+				Put(g_ReplacementChar);
+			}
+			else
+			{
+				Put(c <= 0x10FFFF ? c : g_ReplacementChar);
+			}
+			i++;
+		}
+		return size;
+	}
+}
+
+namespace kxf
+{
+	size_t UTF8EncodingConverter::GetWideCharLength(std::span<const std::byte> source) noexcept
+	{
+		return DecodeUTF8<wchar_t>(reinterpret_cast<const uint8_t*>(source.data()), source.size(), nullptr);
+	}
+	size_t UTF8EncodingConverter::GetMultiByteLength(std::span<const wchar_t> source) noexcept
+	{
+		return EncodeUTF8<wchar_t>(source.data(), source.size(), nullptr);
+	}
+
+	size_t UTF8EncodingConverter::Decode(std::span<const std::byte> source, wchar_t* buffer) noexcept
+	{
+		return DecodeUTF8<wchar_t>(reinterpret_cast<const uint8_t*>(source.data()), source.size(), buffer);
+	}
+	size_t UTF8EncodingConverter::Encode(std::span<const wchar_t> source, std::byte* buffer) noexcept
+	{
+		return EncodeUTF8<wchar_t>(source.data(), source.size(), reinterpret_cast<uint8_t*>(buffer));
+	}
+
+	// IEncodingConverter
+	size_t UTF8EncodingConverter::ToMultiByteBuffer(std::span<const wchar_t> source, std::span<std::byte> destination)
+	{
+		if (destination.empty())
+		{
+			return GetMultiByteLength(source);
+		}
+
+		// Only calculate the exact length when the buffer might be too small, fail in that case just like the system converter does
+		if (destination.size() < GetMaxMultiByteLength(source.size()) && destination.size() < GetMultiByteLength(source))
+		{
+			return 0;
+		}
+		return Encode(source, destination.data());
+	}
+	size_t UTF8EncodingConverter::ToWideCharBuffer(std::span<const std::byte> source, std::span<wchar_t> destination)
+	{
+		if (destination.empty())
+		{
+			return GetWideCharLength(source);
+		}
+
+		if (destination.size() < GetMaxWideCharLength(source.size()) && destination.size() < GetWideCharLength(source))
+		{
+			return 0;
+		}
+		return Decode(source, destination.data());
+	}
+
+	String UTF8EncodingConverter::GetEncodingName() const
+	{
+		return "UTF-8";
+	}
+}
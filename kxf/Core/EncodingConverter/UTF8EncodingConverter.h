@@ -0,0 +1,45 @@
+#pragma once
+#include "../Common.h"
+#include "../IEncodingConverter.h"
+
+namespace kxf
+{
+	// UTF-8 converter which doesn't go through the system one. ASCII runs are converted with SIMD, the rest is decoded
+	// and validated in place: ill-formed sequences and unpaired surrogates are replaced with U+FFFD, one replacement
+	// for each maximal invalid subpart, the same way 'MultiByteToWideChar' does it without 'MB_ERR_INVALID_CHARS'.
+	class UTF8EncodingConverter final: public IEncodingConverter
+	{
+		public:
+			// Upper bounds of the output length, these allow to convert in a single pass without calculating the exact length first
+			static constexpr size_t GetMaxWideCharLength(size_t size) noexcept
+			{
+				// Every byte produces one code unit at most
+				return size;
+			}
+			static constexpr size_t GetMaxMultiByteLength(size_t length) noexcept
+			{
+				// Three bytes for every UTF-16 unit (a surrogate pair takes four bytes) or four bytes for every UTF-32 one
+				return length * (sizeof(wchar_t) == sizeof(char16_t) ? 3 : 4);
+			}
+
+			static size_t GetWideCharLength(std::span<const std::byte> source) noexcept;
+			static size_t GetMultiByteLength(std::span<const wchar_t> source) noexcept;
+
+			// The buffer must be able to hold the maximum length of the output, returns the actual one
+			static size_t Decode(std::span<const std::byte> source, wchar_t* buffer) noexcept;
+			static size_t Encode(std::span<const wchar_t> source, std::byte* buffer) noexcept;
+
+		protected:
+			// IEncodingConverter
+			size_t ToMultiByteBuffer(std::span<const wchar_t> source, std::span<std::byte> destination) override;
+			size_t ToWideCharBuffer(std::span<const std::byte> source, std::span<wchar_t> destination) override;
+
+		public:
+			UTF8EncodingConverter() noexcept = default;
+			~UTF8EncodingConverter() = default;
+
+		public:
+			// IEncodingConverter
+			String GetEncodingName() const override;
+	};
+}
@@ -1,6 +1,7 @@
 #include "KxfPCH.h"
 #include "IEncodingConverter.h"
 #include "EncodingConverter/NativeEncodingConverter.h"
+#include "EncodingConverter/UTF8EncodingConverter.h"
 #include "EncodingConverter/WhateverWorksEncodingConverter.h"
 #include <Windows.h>
 
@@ -10,7 +11,7 @@ namespace
 
 	kxf::NativeEncodingConverter g_EncodingConverter_Local(CP_ACP);
 	kxf::NativeEncodingConverter g_EncodingConverter_ASCII(20127);
-	kxf::NativeEncodingConverter g_EncodingConverter_UTF8(CP_UTF8);
+	kxf::UTF8EncodingConverter g_EncodingConverter_UTF8;
 
 	kxf::NativeEncodingConverter g_EncodingConverter_UTF16LE(1200);
 	kxf::NativeEncodingConverter g_EncodingConverter_UTF16BE(1201);
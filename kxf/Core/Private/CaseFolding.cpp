@@ -0,0 +1,314 @@
+#include "KxfPCH.h"
+#include "CaseFolding.h"
+#include "kxf/System/SystemInformation.h"
+#include <Windows.h>
+#include <kxf/System/UndefWindows.h>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#define KXF_CASEFOLDING_X86 1
+#endif
+
+namespace
+{
+	using namespace kxf;
+
+	static_assert(sizeof(XChar) == sizeof(char16_t), "case folding table assumes UTF-16 code units");
+
+	// Built once from the system mapping so the result is exactly the same as lowercasing the whole string
+	const XChar* GetLowercaseTable() noexcept
+	{
+		static const auto table = []()
+		{
+			constexpr size_t count = std::numeric_limits<uint16_t>::max() + 1;
+
+			auto table = std::make_unique<XChar[]>(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				table[i] = static_cast<XChar>(i);
+			}
+			::CharLowerBuffW(table.get(), static_cast<DWORD>(count));
+
+			return table;
+		}();
+		return table.get();
+	}
+
+	template<class TChar>
+	constexpr uint32_t ToLowerASCII(TChar c) noexcept
+	{
+		const auto value = static_cast<std::make_unsigned_t<TChar>>(c);
+		return value >= 'A' && value <= 'Z' ? value + ('a' - 'A') : value;
+	}
+
+	#if KXF_CASEFOLDING_X86
+	// Lowercases ASCII letters of a block known to contain ASCII only. Signed comparisons are fine for that range.
+	template<class TChar>
+	__m128i ToLowerASCII(__m128i value) noexcept
+	{
+		if constexpr(sizeof(TChar) == sizeof(char))
+		{
+			const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(value, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(value, _mm_set1_epi8('Z' + 1)));
+			return _mm_or_si128(value, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+		}
+		else
+		{
+			const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi16(value, _mm_set1_epi16('A' - 1)), _mm_cmplt_epi16(value, _mm_set1_epi16('Z' + 1)));
+			return _mm_or_si128(value, _mm_and_si128(isUpper, _mm_set1_epi16(0x20)));
+		}
+	}
+
+	template<class TChar>
+	bool IsASCII(__m128i value) noexcept
+	{
+		if constexpr(sizeof(TChar) == sizeof(char))
+		{
+			return _mm_movemask_epi8(value) == 0;
+		}
+		else
+		{
+			const __m128i nonASCII = _mm_and_si128(value, _mm_set1_epi16(static_cast<short>(0xFF80)));
+			return _mm_movemask_epi8(_mm_cmpeq_epi16(nonASCII, _mm_setzero_si128())) == 0xFFFF;
+		}
+	}
+	#endif
+
+	template<class TChar>
+	size_t DoMismatchNoCaseASCII(const TChar* left, const TChar* right, size_t length) noexcept
+	{
+		size_t i = 0;
+
+		#if KXF_CASEFOLDING_X86
+		static const bool hasSSE2 = System::HasFeature(ProcessorFeature::SSE2);
+		if (hasSSE2)
+		{
+			constexpr size_t step = sizeof(__m128i) / sizeof(TChar);
+			for (; length - i >= step; i += step)
+			{
+				const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i));
+				const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i));
+				if (!IsASCII<TChar>(_mm_or_si128(a, b)) || _mm_movemask_epi8(_mm_cmpeq_epi8(ToLowerASCII<TChar>(a), ToLowerASCII<TChar>(b))) != 0xFFFF)
+				{
+					// The scalar loop below finds the exact position
+					break;
+				}
+			}
+		}
+		#endif
+
+		for (; i < length; i++)
+		{
+			const uint32_t a = static_cast<std::make_unsigned_t<TChar>>(left[i]);
+			const uint32_t b = static_cast<std::make_unsigned_t<TChar>>(right[i]);
+			if ((a|b) >= 0x80u || ToLowerASCII(a) != ToLowerASCII(b))
+			{
+				break;
+			}
+		}
+		return i;
+	}
+
+	template<bool t_RightFolded>
+	bool DoEqualsNoCase(const XChar* left, const XChar* right, size_t length, const XChar* table) noexcept
+	{
+		size_t i = 0;
+		while (i < length)
+		{
+			i += DoMismatchNoCaseASCII(left + i, right + i, length - i);
+			if (i == length)
+			{
+				break;
+			}
+
+			// Either a different character or a non-ASCII one, the latter needs the table
+			if (table[left[i]] != (t_RightFolded ? right[i] : table[right[i]]))
+			{
+				return false;
+			}
+			i++;
+		}
+		return true;
+	}
+
+	#if KXF_CASEFOLDING_X86
+	// Skips over ASCII text which can't start a match, returns the position of the first unit which either is a possible
+	// match for the first character of the pattern or isn't ASCII. Stops at 'end' or close to it.
+	size_t SkipNonCandidates_SSE2(const XChar* data, size_t i, size_t end, XChar first, XChar caseBit) noexcept
+	{
+		const __m128i firstVector = _mm_set1_epi16(static_cast<short>(first));
+		const __m128i caseBitVector = _mm_set1_epi16(static_cast<short>(caseBit));
+		const __m128i nonASCIIMask = _mm_set1_epi16(static_cast<short>(0xFF80));
+		const __m128i zero = _mm_setzero_si128();
+
+		for (; end - i >= 8; i += 8)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			const __m128i candidate = _mm_cmpeq_epi16(_mm_or_si128(chunk, caseBitVector), firstVector);
+			const __m128i nonASCII = _mm_xor_si128(_mm_cmpeq_epi16(_mm_and_si128(chunk, nonASCIIMask), zero), _mm_set1_epi8(-1));
+
+			if (const uint32_t mask = _mm_movemask_epi8(_mm_or_si128(candidate, nonASCII)); mask != 0)
+			{
+				return i + std::countr_zero(mask) / sizeof(XChar);
+			}
+		}
+		return i;
+	}
+	size_t SkipNonCandidates_AVX2(const XChar* data, size_t i, size_t end, XChar first, XChar caseBit) noexcept
+	{
+		const __m256i firstVector = _mm256_set1_epi16(static_cast<short>(first));
+		const __m256i caseBitVector = _mm256_set1_epi16(static_cast<short>(caseBit));
+		const __m256i nonASCIIMask = _mm256_set1_epi16(static_cast<short>(0xFF80));
+		const __m256i zero = _mm256_setzero_si256();
+
+		for (; end - i >= 16; i += 16)
+		{
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			const __m256i candidate = _mm256_cmpeq_epi16(_mm256_or_si256(chunk, caseBitVector), firstVector);
+			const __m256i nonASCII = _mm256_xor_si256(_mm256_cmpeq_epi16(_mm256_and_si256(chunk, nonASCIIMask), zero), _mm256_set1_epi8(-1));
+
+			if (const uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(candidate, nonASCII)); mask != 0)
+			{
+				i += std::countr_zero(mask) / sizeof(XChar);
+				break;
+			}
+		}
+		_mm256_zeroupper();
+
+		return i;
+	}
+	#endif
+
+	size_t SkipNonCandidates(const XChar* data, size_t i, size_t end, XChar first) noexcept
+	{
+		#if KXF_CASEFOLDING_X86
+		static const bool hasAVX2 = System::HasFeature(ProcessorFeature::AVX2);
+		static const bool hasSSE2 = System::HasFeature(ProcessorFeature::SSE2);
+
+		// An ASCII letter matches both of its cases, setting the case bit makes them the same. Other ASCII characters
+		// only match themselves, and non-ASCII characters are reported anyway since some of them lowercase to ASCII ones.
+		const XChar caseBit = first >= 'a' && first <= 'z' ? 0x20 : 0;
+		if (hasAVX2 && end - i >= 64)
+		{
+			i = SkipNonCandidates_AVX2(data, i, end, first, caseBit);
+		}
+		if (hasSSE2)
+		{
+			i = SkipNonCandidates_SSE2(data, i, end, first, caseBit);
+		}
+		#endif
+
+		return i;
+	}
+
+	template<bool t_PatternFolded>
+	size_t DoFindNoCase(std::wstring_view source, std::wstring_view pattern, size_t offset) noexcept
+	{
+		if (pattern.empty())
+		{
+			return offset <= source.length() ? offset : std::wstring_view::npos;
+		}
+		if (offset > source.length() || source.length() - offset < pattern.length())
+		{
+			return std::wstring_view::npos;
+		}
+
+		const XChar* table = GetLowercaseTable();
+		const XChar first = t_PatternFolded ? pattern.front() : table[pattern.front()];
+		const size_t end = source.length() - pattern.length() + 1;
+
+		size_t i = offset;
+		while (i < end)
+		{
+			i = SkipNonCandidates(source.data(), i, end, first);
+
+			// Check a few positions with the scalar code before going back to SIMD, this way non-ASCII text
+			// and frequent candidates don't cause a SIMD round trip for every character.
+			for (const size_t blockEnd = std::min(end, i + 16); i < blockEnd; i++)
+			{
+				if (table[source[i]] == first && DoEqualsNoCase<t_PatternFolded>(source.data() + i, pattern.data(), pattern.length(), table))
+				{
+					return i;
+				}
+			}
+		}
+		return std::wstring_view::npos;
+	}
+
+	template<bool t_PatternFolded>
+	size_t DoReverseFindNoCase(std::wstring_view source, std::wstring_view pattern, size_t offset) noexcept
+	{
+		if (pattern.empty())
+		{
+			return std::min(offset, source.length());
+		}
+		if (source.length() < pattern.length())
+		{
+			return std::wstring_view::npos;
+		}
+
+		const XChar* table = GetLowercaseTable();
+		const XChar first = t_PatternFolded ? pattern.front() : table[pattern.front()];
+
+		for (size_t i = std::min(offset, source.length() - pattern.length()) + 1; i-- != 0;)
+		{
+			if (table[source[i]] == first && DoEqualsNoCase<t_PatternFolded>(source.data() + i, pattern.data(), pattern.length(), table))
+			{
+				return i;
+			}
+		}
+		return std::wstring_view::npos;
+	}
+}
+
+namespace kxf::Private
+{
+	XChar FoldCase(XChar c) noexcept
+	{
+		return GetLowercaseTable()[c];
+	}
+
+	size_t MismatchNoCaseASCII(std::string_view left, std::string_view right) noexcept
+	{
+		return DoMismatchNoCaseASCII(left.data(), right.data(), std::min(left.length(), right.length()));
+	}
+	size_t MismatchNoCaseASCII(std::wstring_view left, std::wstring_view right) noexcept
+	{
+		return DoMismatchNoCaseASCII(left.data(), right.data(), std::min(left.length(), right.length()));
+	}
+
+	bool EqualsNoCase(std::wstring_view left, std::wstring_view right) noexcept
+	{
+		return left.length() == right.length() && DoEqualsNoCase<false>(left.data(), right.data(), left.length(), GetLowercaseTable());
+	}
+
+	size_t FindNoCase(std::wstring_view source, std::wstring_view pattern, size_t offset) noexcept
+	{
+		return DoFindNoCase<false>(source, pattern, offset);
+	}
+	size_t ReverseFindNoCase(std::wstring_view source, std::wstring_view pattern, size_t offset) noexcept
+	{
+		return DoReverseFindNoCase<false>(source, pattern, offset);
+	}
+}
+
+namespace kxf::Private
+{
+	CaseFoldedPattern::CaseFoldedPattern(std::wstring_view pattern)
+		:m_Pattern(pattern)
+	{
+		const XChar* table = GetLowercaseTable();
+		for (XChar& c: m_Pattern)
+		{
+			c = table[c];
+		}
+	}
+
+	size_t CaseFoldedPattern::Find(std::wstring_view source, size_t offset) const noexcept
+	{
+		return DoFindNoCase<true>(source, m_Pattern, offset);
+	}
+	size_t CaseFoldedPattern::ReverseFind(std::wstring_view source, size_t offset) const noexcept
+	{
+		return DoReverseFindNoCase<true>(source, m_Pattern, offset);
+	}
+}
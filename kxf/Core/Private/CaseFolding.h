@@ -0,0 +1,38 @@
+#pragma once
+#include "../Common.h"
+
+namespace kxf::Private
+{
+	// Lowercase mapping of a single UTF-16 code unit, the same one 'String::MakeLower' applies to the whole string
+	XChar FoldCase(XChar c) noexcept;
+
+	// Length of the common prefix of two strings compared ignoring case. Stops at the first non-ASCII character in either string,
+	// the caller is supposed to take over from there.
+	size_t MismatchNoCaseASCII(std::string_view left, std::string_view right) noexcept;
+	size_t MismatchNoCaseASCII(std::wstring_view left, std::wstring_view right) noexcept;
+
+	bool EqualsNoCase(std::wstring_view left, std::wstring_view right) noexcept;
+
+	// Case-insensitive search without making lowercase copies of the strings, follows 'std::wstring_view::find/rfind' conventions
+	size_t FindNoCase(std::wstring_view source, std::wstring_view pattern, size_t offset = 0) noexcept;
+	size_t ReverseFindNoCase(std::wstring_view source, std::wstring_view pattern, size_t offset = std::wstring_view::npos) noexcept;
+
+	// Pattern lowercased once for repeated case-insensitive searches
+	class CaseFoldedPattern final
+	{
+		private:
+			std::wstring m_Pattern;
+
+		public:
+			CaseFoldedPattern(std::wstring_view pattern);
+
+		public:
+			size_t GetLength() const noexcept
+			{
+				return m_Pattern.length();
+			}
+
+			size_t Find(std::wstring_view source, size_t offset = 0) const noexcept;
+			size_t ReverseFind(std::wstring_view source, size_t offset = std::wstring_view::npos) const noexcept;
+	};
+}
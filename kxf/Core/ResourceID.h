@@ -11,6 +11,15 @@ namespace kxf
 		private:
 			URI m_Value;
 
+			// IDs are mostly used as map keys, the hash is computed once to not rebuild it on every lookup
+			size_t m_Hash = 0;
+
+		private:
+			void Init() noexcept
+			{
+				m_Hash = std::hash<URI>()(m_Value);
+			}
+
 		public:
 			ResourceID() noexcept = default;
 
@@ -19,11 +28,13 @@ namespace kxf
 			ResourceID(T id) noexcept
 			{
 				m_Value.Create(kxf::ToString(id));
+				Init();
 			}
 
 			ResourceID(URI id) noexcept
 				:m_Value(std::move(id))
 			{
+				Init();
 			}
 			ResourceID(const String& id) noexcept
 				:ResourceID(URI(id))
@@ -72,6 +83,7 @@ namespace kxf
 			}
 			URI ToURI() && noexcept
 			{
+				m_Hash = 0;
 				return std::move(m_Value);
 			}
 
@@ -93,7 +105,7 @@ namespace kxf
 
 			bool operator==(const ResourceID& other) const noexcept
 			{
-				return this == &other || m_Value == other.m_Value;
+				return this == &other || (m_Hash == other.m_Hash && m_Value == other.m_Value);
 			}
 
 			ResourceID& operator=(const ResourceID&) = default;
@@ -108,7 +120,7 @@ namespace std
 	{
 		size_t operator()(const kxf::ResourceID& id) const noexcept
 		{
-			return std::hash<kxf::URI>()(id.m_Value);
+			return id.m_Hash;
 		}
 	};
 }
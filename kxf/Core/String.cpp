@@ -2,6 +2,8 @@
 #include "String.h"
 #include "RegEx.h"
 #include "IEncodingConverter.h"
+#include "EncodingConverter/UTF8EncodingConverter.h"
+#include "Private/CaseFolding.h"
 #include "kxf/IO/IStream.h"
 #include "kxf/Utility/Common.h"
 #include <wx/string.h>
@@ -11,14 +13,58 @@
 
 namespace
 {
+	using kxf::UTF8EncodingConverter;
+
+	// Short strings are converted straight into a buffer of the maximum size, longer ones get their exact length calculated
+	// first to not hold on to up to three or four times the memory they need
+	constexpr size_t g_SinglePassConversionLength = 1024;
+
+	std::wstring DecodeUTF8(std::string_view utf8)
+	{
+		const auto source = std::as_bytes(std::span(utf8));
+		const size_t length = source.size() <= g_SinglePassConversionLength ? UTF8EncodingConverter::GetMaxWideCharLength(source.size()) : UTF8EncodingConverter::GetWideCharLength(source);
+
+		std::wstring result;
+		result.resize_and_overwrite(length, [&](wchar_t* buffer, size_t) noexcept
+		{
+			return UTF8EncodingConverter::Decode(source, buffer);
+		});
+		return result;
+	}
+	std::string EncodeUTF8(std::wstring_view string)
+	{
+		const auto source = std::span(string);
+		const size_t size = source.size() <= g_SinglePassConversionLength ? UTF8EncodingConverter::GetMaxMultiByteLength(source.size()) : UTF8EncodingConverter::GetMultiByteLength(source);
+
+		std::string result;
+		result.resize_and_overwrite(size, [&](char* buffer, size_t) noexcept
+		{
+			return UTF8EncodingConverter::Encode(source, reinterpret_cast<std::byte*>(buffer));
+		});
+		return result;
+	}
+
 	std::strong_ordering DoCompareStrings(std::string_view left, std::string_view right, bool ignoreCase) noexcept
 	{
 		if (ignoreCase)
 		{
-			auto a = kxf::String::FromUnknownEncoding(left);
-			auto b = kxf::String::FromUnknownEncoding(right);
+			// ASCII prefix is compared in place, only the rest of the strings starting from the first non-ASCII character needs to be converted
+			const size_t pos = kxf::Private::MismatchNoCaseASCII(left, right);
+			if (pos == std::min(left.length(), right.length()))
+			{
+				return left.length() <=> right.length();
+			}
 
-			return a.MakeLower().CompareTo(b.MakeLower());
+			const auto a = static_cast<uint8_t>(left[pos]);
+			const auto b = static_cast<uint8_t>(right[pos]);
+			if (a < 0x80u && b < 0x80u)
+			{
+				return std::tolower(a) <=> std::tolower(b);
+			}
+
+			auto restA = kxf::String::FromUnknownEncoding(left.substr(pos));
+			auto restB = kxf::String::FromUnknownEncoding(right.substr(pos));
+			return restA.MakeLower().CompareTo(restB.MakeLower());
 		}
 		else
 		{
@@ -29,6 +75,19 @@ namespace
 	{
 		if (ignoreCase)
 		{
+			// 'CompareStringOrdinal' compares uppercase forms, so does the ASCII fast path
+			const size_t pos = kxf::Private::MismatchNoCaseASCII(left, right);
+			if (pos == std::min(left.length(), right.length()))
+			{
+				return left.length() <=> right.length();
+			}
+			if (left[pos] < 0x80 && right[pos] < 0x80)
+			{
+				return std::toupper(left[pos]) <=> std::toupper(right[pos]);
+			}
+			left.remove_prefix(pos);
+			right.remove_prefix(pos);
+
 			constexpr size_t maxLength = std::numeric_limits<int>::max();
 			wxASSERT_MSG(left.length() <= maxLength && right.length() <= maxLength, __FUNCTION__ ": strings are too long to be compared using 'CompareStringOrdinal'");
 
@@ -369,7 +428,7 @@ namespace kxf
 	}
 	String String::FromUTF8(CStrViewAdapter utf8)
 	{
-		return EncodingConverter_UTF8.ToWideChar(utf8.GetView());
+		return DecodeUTF8(utf8.GetView());
 	}
 	String String::FromASCII(CStrViewAdapter ascii)
 	{
@@ -381,7 +440,9 @@ namespace kxf
 	}
 	String String::FromUnknownEncoding(CStrViewAdapter unknown)
 	{
-		return EncodingConverter_WhateverWorks.ToWideChar(unknown.GetView());
+		// UTF-8 is what 'EncodingConverter_WhateverWorks' tries first and it never fails on a non-empty input since ill-formed
+		// sequences are replaced rather than rejected, so there's no need to go through the whole chain of converters.
+		return DecodeUTF8(unknown.GetView());
 	}
 	String String::FromFloatingPoint(double value, int precision)
 	{
@@ -416,17 +477,17 @@ namespace kxf
 	}
 	bool String::DoStartsWith(std::wstring_view pattern, String* rest, FlagSet<StringActionFlag> flags) const
 	{
-		if (pattern.empty())
+		if (pattern.empty() || pattern.length() > m_String.length())
 		{
 			return false;
 		}
 
-		const size_t pos = Find(pattern, flags);
-		if (pos == 0)
+		const auto prefix = view().substr(0, pattern.length());
+		if (flags & StringActionFlag::IgnoreCase ? Private::EqualsNoCase(prefix, pattern) : prefix == pattern)
 		{
 			if (rest)
 			{
-				*rest = m_String.substr(pos, pattern.length());
+				*rest = prefix;
 			}
 			return true;
 		}
@@ -440,17 +501,17 @@ namespace kxf
 	}
 	bool String::DoEndsWith(std::wstring_view pattern, String* rest, FlagSet<StringActionFlag> flags) const
 	{
-		if (pattern.empty())
+		if (pattern.empty() || pattern.length() > m_String.length())
 		{
 			return false;
 		}
 
-		const size_t pos = ReverseFind(pattern, flags);
-		if (pos == m_String.length() - pattern.length())
+		const auto suffix = view().substr(m_String.length() - pattern.length());
+		if (flags & StringActionFlag::IgnoreCase ? Private::EqualsNoCase(suffix, pattern) : suffix == pattern)
 		{
 			if (rest)
 			{
-				*rest = m_String.substr(pos, npos);
+				*rest = suffix;
 			}
 			return true;
 		}
@@ -470,7 +531,7 @@ namespace kxf
 	// Conversions
 	std::string String::ToUTF8() const
 	{
-		return EncodingConverter_UTF8.ToMultiByte(m_String);
+		return EncodeUTF8(m_String);
 	}
 	std::string String::ToASCII(char replaceWith) const
 	{
@@ -614,16 +675,13 @@ namespace kxf
 		{
 			if (flags & StringActionFlag::IgnoreCase)
 			{
-				auto sourceL = ToLower();
-				auto patternL = String(pattern).MakeLower();
-
 				if (reverse)
 				{
-					return sourceL.m_String.rfind(patternL.view(), offset);
+					return Private::ReverseFindNoCase(m_String, pattern, offset);
 				}
 				else
 				{
-					return sourceL.m_String.find(patternL.view(), offset);
+					return Private::FindNoCase(m_String, pattern, offset);
 				}
 			}
 			else
@@ -706,38 +764,28 @@ namespace kxf
 			return 0;
 		}
 
-		size_t replacementCount = 0;
-		size_t pos = wxString::npos;
-
-		String sourceL;
-		String patternL;
+		// The pattern is lowercased once and searched for directly in the string being modified
+		std::optional<Private::CaseFoldedPattern> foldedPattern;
 		if (flags & StringActionFlag::IgnoreCase)
 		{
-			sourceL = ToLower();
-			patternL = String(pattern).MakeLower();
-
-			if (reverse)
-			{
-				pos = sourceL.m_String.rfind(patternL.view(), offset);
-			}
-			else
-			{
-				pos = sourceL.m_String.find(patternL.view(), offset);
-			}
+			foldedPattern.emplace(pattern);
 		}
-		else
+
+		auto FindNext = [&](size_t pos) -> size_t
 		{
-			if (reverse)
+			if (foldedPattern)
 			{
-				pos = m_String.rfind(pattern, offset);
+				return reverse ? foldedPattern->ReverseFind(m_String, pos) : foldedPattern->Find(m_String, pos);
 			}
 			else
 			{
-				pos = m_String.find(pattern, offset);
+				return reverse ? m_String.rfind(pattern, pos) : m_String.find(pattern, pos);
 			}
-		}
+		};
 
-		while (pos != wxString::npos)
+		size_t replacementCount = 0;
+		size_t pos = FindNext(offset);
+		while (pos != npos)
 		{
 			m_String.replace(pos, patternLength, replacement.data(), replacement.length());
 			replacementCount++;
@@ -747,27 +795,15 @@ namespace kxf
 				return replacementCount;
 			}
 
-			if (flags & StringActionFlag::IgnoreCase)
+			if (reverse)
 			{
-				if (reverse)
-				{
-					pos = sourceL.m_String.rfind(patternL.view(), pos + replacementLength);
-				}
-				else
-				{
-					pos = sourceL.m_String.find(patternL.view(), pos + replacementLength);
-				}
+				// The next match has to end before this one has started, so the replacement itself is never searched.
+				// The text before the match hasn't moved, its positions are still the same.
+				pos = pos >= patternLength ? FindNext(pos - patternLength) : npos;
 			}
 			else
 			{
-				if (reverse)
-				{
-					pos = m_String.rfind(pattern, pos + replacementLength);
-				}
-				else
-				{
-					pos = m_String.find(pattern, pos + replacementLength);
-				}
+				pos = FindNext(pos + replacementLength);
 			}
 		}
 		return replacementCount;
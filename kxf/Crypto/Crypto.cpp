@@ -3,9 +3,10 @@
 #include "kxf/IO/IStream.h"
 #include "kxf/Core/String.h"
 #include "kxf/Core/DataSize.h"
-#include "kxf/Utility/ScopeGuard.h"
+#include "Private/CRC32.h"
+#include "Private/Base64.h"
+#include "Private/BLAKE3.h"
 
-#include <wx/base64.h> 
 #include <wx/regex.h> 
 #include "OpenSSL/opensslv.h"
 #include "OpenSSL/md5.h"
@@ -22,122 +23,386 @@ namespace
 
 	constexpr size_t g_StreamBlockSize = DataSize::FromKB(64).ToBytes();
 
-	template<class THashContext, size_t hashLength, class TInitFunc, class TUpdateFunc, class TFinalFunc, class TValue = uint8_t>
-	HashValue<hashLength * 8> DoCalcHash1(IInputStream& stream, TInitFunc&& initFunc, TUpdateFunc&& updateFunc, TFinalFunc&& finalFunc) noexcept
+	// Calls the function for each block read from the stream until it returns false. Streams providing
+	// direct access to their memory (including mapped files) are processed without copying.
+	template<class TFunc>
+	bool ForEachStreamBlock(IInputStream& stream, TFunc&& func) noexcept
 	{
-		THashContext hashContext;
-		if (std::invoke(initFunc, &hashContext) != 0)
+		constexpr size_t viewSize = std::numeric_limits<size_t>::max();
+		if (auto view = stream.ReadView(viewSize); !view.empty())
 		{
-			TValue buffer[g_StreamBlockSize] = {};
-			while (stream.CanRead())
+			for (; !view.empty(); view = stream.ReadView(viewSize))
 			{
-				if (stream.Read(buffer, std::size(buffer)).LastRead() != 0)
+				if (!std::invoke(func, reinterpret_cast<const uint8_t*>(view.data()), view.size()))
 				{
-					std::invoke(updateFunc, &hashContext, &buffer, stream.LastRead().ToBytes());
+					return false;
 				}
-				else
+			}
+			return true;
+		}
+
+		uint8_t buffer[g_StreamBlockSize] = {};
+		while (stream.CanRead())
+		{
+			if (stream.Read(buffer, std::size(buffer)).LastRead() != 0)
+			{
+				if (!std::invoke(func, buffer, stream.LastRead().ToBytes()))
 				{
-					break;
+					return false;
 				}
 			}
-
-			HashValue<hashLength * 8> hash;
-			if (std::invoke(finalFunc, reinterpret_cast<TValue*>(hash.data()), &hashContext) != 0)
+			else
 			{
-				return hash;
+				break;
 			}
 		}
-		return {};
+		return true;
 	}
 
-	template<size_t bitLength, class THashAlgorithm, class TValue = uint8_t>
-	HashValue<bitLength> DoCalcHash2(IInputStream& stream, THashAlgorithm&& algorithFunc) noexcept
+	template<HashAlgorithm algorithm, uint32_t(*t_Update)(uint32_t, const void*, size_t) noexcept>
+	class CRCHasher final: public IHasher
 	{
-		if (const EVP_MD* algorithm = std::invoke(algorithFunc))
-		{
-			EVP_MD_CTX* context = EVP_MD_CTX_create();
-			Utility::ScopeGuard atExit([&]()
+		private:
+			uint32_t m_InitialValue = 0;
+			uint32_t m_Value = 0;
+
+		public:
+			CRCHasher(uint32_t initialValue = 0xFFFFFFFFu) noexcept
+				:m_InitialValue(initialValue), m_Value(initialValue)
 			{
-				if (context)
+			}
+
+		public:
+			HashAlgorithm GetAlgorithm() const noexcept override
+			{
+				return algorithm;
+			}
+			size_t GetHashLength() const noexcept override
+			{
+				return sizeof(m_Value);
+			}
+
+			void Reset() noexcept override
+			{
+				m_Value = m_InitialValue;
+			}
+			bool Update(const void* data, size_t size) noexcept override
+			{
+				m_Value = t_Update(m_Value, data, size);
+				return true;
+			}
+			bool Finalize(void* buffer, size_t size) noexcept override
+			{
+				if (size == sizeof(m_Value))
 				{
-					EVP_MD_CTX_destroy(context);
+					const uint32_t value = ~m_Value;
+					std::memcpy(buffer, &value, sizeof(value));
+
+					Reset();
+					return true;
 				}
-			});
+				return false;
+			}
+			using IHasher::Update;
+			using IHasher::Finalize;
+	};
+	using CRC32Hasher = CRCHasher<HashAlgorithm::CRC32, Crypto::Private::UpdateCRC32>;
+	using CRC32CHasher = CRCHasher<HashAlgorithm::CRC32C, Crypto::Private::UpdateCRC32C>;
 
-			if (context && EVP_DigestInit_ex(context, algorithm, nullptr) == 1)
+	class EVPHasher final: public IHasher
+	{
+		private:
+			HashAlgorithm m_Algorithm = HashAlgorithm::None;
+			const EVP_MD* m_Digest = nullptr;
+			EVP_MD_CTX* m_Context = nullptr;
+			bool m_IsInitialized = false;
+
+		public:
+			EVPHasher(HashAlgorithm algorithm, const EVP_MD* digest) noexcept
+				:m_Algorithm(algorithm), m_Digest(digest), m_Context(EVP_MD_CTX_create())
+			{
+				Reset();
+			}
+			EVPHasher(const EVPHasher&) = delete;
+			~EVPHasher()
 			{
-				TValue buffer[g_StreamBlockSize] = {};
-				while (stream.CanRead())
+				if (m_Context)
 				{
-					if (stream.Read(buffer, std::size(buffer)).LastRead() != 0)
-					{
-						if (EVP_DigestUpdate(context, &buffer, stream.LastRead().ToBytes()) != 1)
-						{
-							return {};
-						}
-					}
-					else
-					{
-						break;
-					}
+					EVP_MD_CTX_destroy(m_Context);
 				}
+			}
+
+		public:
+			HashAlgorithm GetAlgorithm() const noexcept override
+			{
+				return m_Algorithm;
+			}
+			size_t GetHashLength() const noexcept override
+			{
+				return m_Digest ? EVP_MD_size(m_Digest) : 0;
+			}
+
+			void Reset() noexcept override
+			{
+				m_IsInitialized = m_Context && m_Digest && EVP_DigestInit_ex(m_Context, m_Digest, nullptr) == 1;
+			}
+			bool Update(const void* data, size_t size) noexcept override
+			{
+				return m_IsInitialized && EVP_DigestUpdate(m_Context, data, size) == 1;
+			}
+			bool Finalize(void* buffer, size_t size) noexcept override
+			{
+				unsigned int length = 0;
+				const bool result = m_IsInitialized && size == GetHashLength() && EVP_DigestFinal_ex(m_Context, static_cast<unsigned char*>(buffer), &length) == 1 && length == size;
 
-				HashValue<bitLength> hash;
-				unsigned int length = EVP_MD_size(algorithm);
+				Reset();
+				return result;
+			}
+			using IHasher::Update;
+			using IHasher::Finalize;
+
+		public:
+			EVPHasher& operator=(const EVPHasher&) = delete;
+	};
+
+	// Wraps the streaming API of one of the xxHash variants
+	template<HashAlgorithm algorithm, class TState, class THash,
+		TState*(*t_Create)(),
+		XXH_errorcode(*t_Free)(TState*),
+		XXH_errorcode(*t_Reset)(TState*),
+		XXH_errorcode(*t_Update)(TState*, const void*, size_t),
+		THash(*t_Digest)(const TState*)
+	>
+	class XXHasher final: public IHasher
+	{
+		private:
+			TState* m_State = nullptr;
+			bool m_IsInitialized = false;
 
-				if (EVP_DigestFinal_ex(context, reinterpret_cast<unsigned char*>(hash.data()), &length) == 1 && length <= hash.length())
+		public:
+			XXHasher() noexcept
+				:m_State(t_Create())
+			{
+				Reset();
+			}
+			XXHasher(const XXHasher&) = delete;
+			~XXHasher()
+			{
+				if (m_State)
 				{
-					return hash;
+					t_Free(m_State);
 				}
 			}
-		}
-		return {};
+
+		public:
+			HashAlgorithm GetAlgorithm() const noexcept override
+			{
+				return algorithm;
+			}
+			size_t GetHashLength() const noexcept override
+			{
+				return sizeof(THash);
+			}
+
+			void Reset() noexcept override
+			{
+				m_IsInitialized = m_State && t_Reset(m_State) != XXH_ERROR;
+			}
+			bool Update(const void* data, size_t size) noexcept override
+			{
+				return m_IsInitialized && t_Update(m_State, data, size) != XXH_ERROR;
+			}
+			bool Finalize(void* buffer, size_t size) noexcept override
+			{
+				if (m_IsInitialized && size == sizeof(THash))
+				{
+					const THash hash = t_Digest(m_State);
+					std::memcpy(buffer, &hash, sizeof(hash));
+
+					Reset();
+					return true;
+				}
+				return false;
+			}
+			using IHasher::Update;
+			using IHasher::Finalize;
+
+		public:
+			XXHasher& operator=(const XXHasher&) = delete;
+	};
+
+	XXH_errorcode XXH32_resetSeedless(XXH32_state_t* state) noexcept
+	{
+		return XXH32_reset(state, 0);
+	}
+	XXH_errorcode XXH64_resetSeedless(XXH64_state_t* state) noexcept
+	{
+		return XXH64_reset(state, 0);
 	}
 
-	template<size_t hashLength, class TInitFunc, class TFreeFunc, class TResetFunc, class TUpdateFunc, class TFinalFunc, class TValue = uint8_t>
-	HashValue<hashLength> DoCalcXXHash(IInputStream& stream,
-									   TInitFunc&& initFunc,
-									   TFreeFunc&& freeFunc,
-									   TResetFunc&& resetFunc,
-									   TUpdateFunc&& updateFunc,
-									   TFinalFunc&& finalFunc
-	) noexcept
+	using XXHash32Hasher = XXHasher<HashAlgorithm::xxHash_32, XXH32_state_t, XXH32_hash_t, XXH32_createState, XXH32_freeState, XXH32_resetSeedless, XXH32_update, XXH32_digest>;
+	using XXHash64Hasher = XXHasher<HashAlgorithm::xxHash_64, XXH64_state_t, XXH64_hash_t, XXH64_createState, XXH64_freeState, XXH64_resetSeedless, XXH64_update, XXH64_digest>;
+	using XXHash128Hasher = XXHasher<HashAlgorithm::xxHash_128, XXH3_state_t, XXH128_hash_t, XXH3_createState, XXH3_freeState, XXH3_128bits_reset, XXH3_128bits_update, XXH3_128bits_digest>;
+
+	class BLAKE3Hasher final: public IHasher
 	{
-		if (auto* state = std::invoke(initFunc))
-		{
-			Utility::ScopeGuard atExit = [&]()
+		private:
+			Crypto::Private::BLAKE3Hasher m_Hasher;
+
+		public:
+			HashAlgorithm GetAlgorithm() const noexcept override
 			{
-				// State can be re-used, here it's simply freed
-				std::invoke(freeFunc, state);
-			};
+				return HashAlgorithm::BLAKE3;
+			}
+			size_t GetHashLength() const noexcept override
+			{
+				return 32;
+			}
 
-			// Initialize state with selected seed (or with 0)
-			if (std::invoke(resetFunc, state, 0) != XXH_ERROR)
+			void Reset() noexcept override
 			{
-				// Feed the state with input data, any size, any number of times
-				TValue buffer[g_StreamBlockSize] = {};
-				while (stream.CanRead())
+				m_Hasher.Reset();
+			}
+			bool Update(const void* data, size_t size) noexcept override
+			{
+				m_Hasher.Update(data, size);
+				return true;
+			}
+			bool Finalize(void* buffer, size_t size) noexcept override
+			{
+				if (size == GetHashLength())
 				{
-					if (stream.Read(buffer, std::size(buffer)).LastRead() != 0)
-					{
-						if (std::invoke(updateFunc, state, buffer, stream.LastRead().ToBytes()) == XXH_ERROR)
-						{
-							break;
-						}
-					}
-					else
-					{
-						break;
-					}
+					const auto hash = m_Hasher.GetOutput().GetRootHash();
+					std::memcpy(buffer, hash.data(), hash.length());
+
+					Reset();
+					return true;
 				}
+				return false;
+			}
+			using IHasher::Update;
+			using IHasher::Finalize;
+	};
 
-				// Get the hash
-				auto hash = std::invoke(finalFunc, state);
-				return HashValue<hashLength>(&hash, sizeof(hash));
+	const EVP_MD* GetEVPDigest(HashAlgorithm algorithm) noexcept
+	{
+		switch (algorithm)
+		{
+			case HashAlgorithm::MD5:
+			{
+				return EVP_md5();
+			}
+			case HashAlgorithm::SHA1:
+			{
+				return EVP_sha1();
+			}
+			case HashAlgorithm::SHA2_224:
+			{
+				return EVP_sha224();
+			}
+			case HashAlgorithm::SHA2_256:
+			{
+				return EVP_sha256();
+			}
+			case HashAlgorithm::SHA2_384:
+			{
+				return EVP_sha384();
+			}
+			case HashAlgorithm::SHA2_512:
+			{
+				return EVP_sha512();
+			}
+			case HashAlgorithm::SHA3_224:
+			{
+				return EVP_sha3_224();
+			}
+			case HashAlgorithm::SHA3_256:
+			{
+				return EVP_sha3_256();
+			}
+			case HashAlgorithm::SHA3_384:
+			{
+				return EVP_sha3_384();
 			}
+			case HashAlgorithm::SHA3_512:
+			{
+				return EVP_sha3_512();
+			}
+		};
+		return nullptr;
+	}
+
+	template<size_t bitLength, class THasher, class... Args>
+	HashValue<bitLength> DoCalcHash(IInputStream& stream, Args&&... arg) noexcept
+	{
+		THasher hasher(std::forward<Args>(arg)...);
+		if (hasher.Update(stream))
+		{
+			return hasher.template Finalize<bitLength>();
 		}
 		return {};
 	}
+	template<size_t bitLength>
+	HashValue<bitLength> DoCalcEVPHash(IInputStream& stream, HashAlgorithm algorithm) noexcept
+	{
+		return DoCalcHash<bitLength, EVPHasher>(stream, algorithm, GetEVPDigest(algorithm));
+	}
+}
+
+namespace kxf::Crypto
+{
+	bool IHasher::Update(IInputStream& stream) noexcept
+	{
+		return ForEachStreamBlock(stream, [&](const uint8_t* data, size_t size)
+		{
+			return Update(data, size);
+		});
+	}
+
+	std::unique_ptr<IHasher> CreateHasher(HashAlgorithm algorithm)
+	{
+		switch (algorithm)
+		{
+			case HashAlgorithm::CRC32:
+			{
+				return std::make_unique<CRC32Hasher>();
+			}
+			case HashAlgorithm::CRC32C:
+			{
+				return std::make_unique<CRC32CHasher>();
+			}
+			case HashAlgorithm::xxHash_32:
+			{
+				return std::make_unique<XXHash32Hasher>();
+			}
+			case HashAlgorithm::xxHash_64:
+			{
+				return std::make_unique<XXHash64Hasher>();
+			}
+			case HashAlgorithm::xxHash_128:
+			{
+				return std::make_unique<XXHash128Hasher>();
+			}
+			case HashAlgorithm::BLAKE3:
+			{
+				return std::make_unique<BLAKE3Hasher>();
+			}
+		};
+
+		if (const EVP_MD* digest = GetEVPDigest(algorithm))
+		{
+			return std::make_unique<EVPHasher>(algorithm, digest);
+		}
+		return nullptr;
+	}
+	std::unique_ptr<IHasher> CreateCRC32Hasher(uint32_t initialValue)
+	{
+		return std::make_unique<CRC32Hasher>(initialValue);
+	}
+	std::unique_ptr<IHasher> CreateCRC32CHasher(uint32_t initialValue)
+	{
+		return std::make_unique<CRC32CHasher>(initialValue);
+	}
 }
 
 namespace kxf::Crypto
@@ -182,110 +447,64 @@ namespace kxf::Crypto
 		return count;
 	}
 
+	HashValue<32> CRC32(const void* data, size_t size, uint32_t initialValue) noexcept
+	{
+		return ~Private::UpdateCRC32(initialValue, data, size);
+	}
 	HashValue<32> CRC32(IInputStream& stream, uint32_t initialValue) noexcept
 	{
-		constexpr uint32_t table[] =
-		{
-			0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
-			0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
-			0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
-			0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
-			0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
-			0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
-			0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
-			0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
-			0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
-			0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
-			0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
-			0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-			0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
-			0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
-			0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
-			0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
-			0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
-			0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
-			0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
-			0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
-			0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
-			0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
-			0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
-			0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-			0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
-			0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
-			0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
-			0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-			0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
-			0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
-			0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
-			0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
-			0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
-			0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
-			0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
-			0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-			0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
-			0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
-			0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
-			0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
-			0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
-			0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
-			0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
-		};
-
-		uint32_t result = initialValue;
-		while (stream.CanRead())
-		{
-			uint8_t buffer[g_StreamBlockSize] = {};
-			const size_t readBytes = stream.Read(buffer, std::size(buffer)).LastRead().ToBytes();
-
-			for (size_t i = 0; i < readBytes; i++)
-			{
-				result = table[(result ^ buffer[i]) & 0xFFu] ^ (result >> 8);
-			}
-		}
-		return ~result;
+		return DoCalcHash<32, CRC32Hasher>(stream, initialValue);
+	}
+	HashValue<32> CRC32C(const void* data, size_t size, uint32_t initialValue) noexcept
+	{
+		return ~Private::UpdateCRC32C(initialValue, data, size);
+	}
+	HashValue<32> CRC32C(IInputStream& stream, uint32_t initialValue) noexcept
+	{
+		return DoCalcHash<32, CRC32CHasher>(stream, initialValue);
 	}
 	HashValue<128> MD5(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<MD5_DIGEST_LENGTH * 8>(stream, EVP_md5);
+		return DoCalcEVPHash<MD5_DIGEST_LENGTH * 8>(stream, HashAlgorithm::MD5);
 	}
 
 	HashValue<160> SHA1(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<SHA_DIGEST_LENGTH * 8>(stream, EVP_sha1);
+		return DoCalcEVPHash<SHA_DIGEST_LENGTH * 8>(stream, HashAlgorithm::SHA1);
 	}
 
 	HashValue<224> SHA2_224(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<SHA224_DIGEST_LENGTH * 8>(stream, EVP_sha224);
+		return DoCalcEVPHash<SHA224_DIGEST_LENGTH * 8>(stream, HashAlgorithm::SHA2_224);
 	}
 	HashValue<256> SHA2_256(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<SHA256_DIGEST_LENGTH * 8>(stream, EVP_sha256);
+		return DoCalcEVPHash<SHA256_DIGEST_LENGTH * 8>(stream, HashAlgorithm::SHA2_256);
 	}
 	HashValue<384> SHA2_384(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<SHA384_DIGEST_LENGTH * 8>(stream, EVP_sha384);
+		return DoCalcEVPHash<SHA384_DIGEST_LENGTH * 8>(stream, HashAlgorithm::SHA2_384);
 	}
 	HashValue<512> SHA2_512(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<SHA512_DIGEST_LENGTH * 8>(stream, EVP_sha512);
+		return DoCalcEVPHash<SHA512_DIGEST_LENGTH * 8>(stream, HashAlgorithm::SHA2_512);
 	}
 
 	HashValue<224> SHA3_224(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<224>(stream, EVP_sha3_224);
+		return DoCalcEVPHash<224>(stream, HashAlgorithm::SHA3_224);
 	}
 	HashValue<256> SHA3_256(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<256>(stream, EVP_sha3_256);
+		return DoCalcEVPHash<256>(stream, HashAlgorithm::SHA3_256);
 	}
 	HashValue<384> SHA3_384(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<384>(stream, EVP_sha3_384);
+		return DoCalcEVPHash<384>(stream, HashAlgorithm::SHA3_384);
 	}
 	HashValue<512> SHA3_512(IInputStream& stream) noexcept
 	{
-		return DoCalcHash2<512>(stream, EVP_sha3_512);
+		return DoCalcEVPHash<512>(stream, HashAlgorithm::SHA3_512);
 	}
 
 	HashValue<32> xxHash_32(const void* data, size_t size) noexcept
@@ -303,75 +522,118 @@ namespace kxf::Crypto
 	}
 	HashValue<32> xxHash_32(IInputStream& stream) noexcept
 	{
-		return DoCalcXXHash<32>(stream, XXH32_createState, XXH32_freeState, XXH32_reset, XXH32_update, XXH32_digest);
+		return DoCalcHash<32, XXHash32Hasher>(stream);
 	}
 	HashValue<64> xxHash_64(IInputStream& stream) noexcept
 	{
-		return DoCalcXXHash<64>(stream, XXH64_createState, XXH64_freeState, XXH64_reset, XXH64_update, XXH64_digest);
+		return DoCalcHash<64, XXHash64Hasher>(stream);
+	}
+	HashValue<128> xxHash_128(IInputStream& stream) noexcept
+	{
+		return DoCalcHash<128, XXHash128Hasher>(stream);
 	}
 
-	bool Base64Encode(IInputStream& inputStream, IOutputStream& outputStream)
+	HashValue<256> BLAKE3(const void* data, size_t size, IThreadPool* threadPool) noexcept
+	{
+		return Private::CalcBLAKE3(data, size, threadPool);
+	}
+	HashValue<256> BLAKE3(IInputStream& stream, IThreadPool* threadPool) noexcept
 	{
-		const size_t size = wxBase64EncodedSize(g_StreamBlockSize);
-		wxMemoryBuffer buffer(size);
+		if (threadPool)
+		{
+			return Private::CalcBLAKE3(stream, threadPool);
+		}
+		return DoCalcHash<256, BLAKE3Hasher>(stream);
+	}
 
-		uint8_t readBuffer[g_StreamBlockSize] = {};
-		while (inputStream.CanRead())
+	size_t GetBase64EncodedSize(size_t size, FlagSet<Base64Flag> flags) noexcept
+	{
+		if (flags.Contains(Base64Flag::NoPadding))
 		{
-			if (inputStream.Read(readBuffer, std::size(readBuffer)).LastRead() != 0)
-			{
-				buffer.AppendData(readBuffer, inputStream.LastRead().ToBytes());
-			}
-			else
-			{
-				break;
-			}
+			return size / 3 * 4 + (size % 3 != 0 ? size % 3 + 1 : 0);
+		}
+		return (size + 2) / 3 * 4;
+	}
+	size_t GetBase64MaxDecodedSize(size_t size) noexcept
+	{
+		return Private::Base64Decoder::GetMaxOutputSize(size);
+	}
+
+	size_t Base64Encode(std::span<const std::byte> data, std::span<char> buffer, FlagSet<Base64Flag> flags) noexcept
+	{
+		if (buffer.size() >= GetBase64EncodedSize(data.size(), flags))
+		{
+			Private::Base64Encoder encoder(flags);
+			const size_t length = encoder.Update(reinterpret_cast<const uint8_t*>(data.data()), data.size(), buffer.data());
+			return length + encoder.Finish(buffer.data() + length);
+		}
+		return 0;
+	}
+	std::optional<size_t> Base64Decode(std::span<const char> data, std::span<std::byte> buffer, FlagSet<Base64Flag> flags) noexcept
+	{
+		if (buffer.size() >= GetBase64MaxDecodedSize(data.size()))
+		{
+			Private::Base64Decoder decoder(flags);
+			auto output = reinterpret_cast<uint8_t*>(buffer.data());
 
-			if (buffer.GetDataLen() == size)
+			if (auto length = decoder.Update(data.data(), data.size(), output))
 			{
-				auto utf8 = wxBase64Encode(buffer).ToUTF8();
-				if (outputStream.WriteAll(utf8.data(), utf8.length()))
+				if (auto tail = decoder.Finish(output + *length))
 				{
-					return true;
-				}
-				else
-				{
-					break;
+					return *length + *tail;
 				}
 			}
 		}
-		return false;
+		return {};
 	}
-	bool Base64Decode(IInputStream& inputStream, IOutputStream& outputStream)
+
+	bool Base64Encode(IInputStream& inputStream, IOutputStream& outputStream, FlagSet<Base64Flag> flags)
 	{
-		const size_t size = wxBase64DecodedSize(g_StreamBlockSize);
-		wxMemoryBuffer buffer(size);
+		// Large views are encoded piece by piece to keep the output buffer bounded
+		constexpr size_t blockSize = g_StreamBlockSize / 4 * 3;
 
-		uint8_t readBuffer[g_StreamBlockSize] = {};
-		while (inputStream.CanRead())
+		Private::Base64Encoder encoder(flags);
+		std::vector<char> buffer(Private::Base64Encoder::GetMaxOutputSize(blockSize));
+
+		auto Write = [&](size_t length)
 		{
-			if (inputStream.Read(readBuffer, std::size(readBuffer)).LastRead() != 0)
-			{
-				buffer.AppendData(readBuffer, inputStream.LastRead().ToBytes());
-			}
-			else
+			return length == 0 || outputStream.WriteAll(buffer.data(), length);
+		};
+		const bool isEncoded = ForEachStreamBlock(inputStream, [&](const uint8_t* data, size_t size)
+		{
+			for (size_t offset = 0; offset < size; offset += blockSize)
 			{
-				break;
+				if (!Write(encoder.Update(data + offset, std::min(blockSize, size - offset), buffer.data())))
+				{
+					return false;
+				}
 			}
+			return true;
+		});
+		return isEncoded && Write(encoder.Finish(buffer.data()));
+	}
+	bool Base64Decode(IInputStream& inputStream, IOutputStream& outputStream, FlagSet<Base64Flag> flags)
+	{
+		constexpr size_t blockSize = g_StreamBlockSize;
+
+		Private::Base64Decoder decoder(flags);
+		std::vector<uint8_t> buffer(Private::Base64Decoder::GetMaxOutputSize(blockSize));
 
-			if (buffer.GetDataLen() == size)
+		auto Write = [&](std::optional<size_t> length)
+		{
+			return length && (*length == 0 || outputStream.WriteAll(buffer.data(), *length));
+		};
+		const bool isDecoded = ForEachStreamBlock(inputStream, [&](const uint8_t* data, size_t size)
+		{
+			for (size_t offset = 0; offset < size; offset += blockSize)
 			{
-				wxMemoryBuffer outBuffer = wxBase64Decode(reinterpret_cast<const char*>(buffer.GetData()), buffer.GetDataLen(), wxBase64DecodeMode_SkipWS);
-				if (outputStream.WriteAll(outBuffer.GetData(), outBuffer.GetDataLen()))
-				{
-					return true;
-				}
-				else
+				if (!Write(decoder.Update(reinterpret_cast<const char*>(data + offset), std::min(blockSize, size - offset), buffer.data())))
 				{
-					break;
+					return false;
 				}
 			}
-		}
-		return false;
+			return true;
+		});
+		return isDecoded && Write(decoder.Finish(buffer.data()));
 	}
 }
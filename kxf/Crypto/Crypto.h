@@ -6,6 +6,82 @@ namespace kxf
 {
 	class IInputStream;
 	class IOutputStream;
+	class IThreadPool;
+}
+
+namespace kxf::Crypto
+{
+	enum class Base64Flag: uint32_t
+	{
+		None = 0,
+
+		URLSafe = 1 << 0,
+		NoPadding = 1 << 1,
+		SkipWhitespace = 1 << 2
+	};
+}
+namespace kxf
+{
+	KxFlagSet_Declare(Crypto::Base64Flag);
+}
+
+namespace kxf::Crypto
+{
+	enum class HashAlgorithm
+	{
+		None = -1,
+
+		CRC32,
+		CRC32C,
+		MD5,
+		SHA1,
+		SHA2_224,
+		SHA2_256,
+		SHA2_384,
+		SHA2_512,
+		SHA3_224,
+		SHA3_256,
+		SHA3_384,
+		SHA3_512,
+		xxHash_32,
+		xxHash_64,
+		xxHash_128,
+		BLAKE3
+	};
+
+	// Incremental hash calculation: feed the data in any number of 'Update' calls and get the hash with 'Finalize'
+	// which also resets the hasher so it can be reused.
+	class KX_API IHasher
+	{
+		public:
+			virtual ~IHasher() = default;
+
+		public:
+			virtual HashAlgorithm GetAlgorithm() const noexcept = 0;
+			virtual size_t GetHashLength() const noexcept = 0;
+
+			virtual void Reset() noexcept = 0;
+			virtual bool Update(const void* data, size_t size) noexcept = 0;
+			virtual bool Finalize(void* buffer, size_t size) noexcept = 0;
+
+			// Feeds the rest of the stream
+			bool Update(IInputStream& stream) noexcept;
+
+			template<size_t bitLength>
+			HashValue<bitLength> Finalize() noexcept
+			{
+				HashValue<bitLength> hash;
+				if (Finalize(hash.data(), hash.length()))
+				{
+					return hash;
+				}
+				return {};
+			}
+	};
+
+	KX_API std::unique_ptr<IHasher> CreateHasher(HashAlgorithm algorithm);
+	KX_API std::unique_ptr<IHasher> CreateCRC32Hasher(uint32_t initialValue = 0xFFFFFFFFu);
+	KX_API std::unique_ptr<IHasher> CreateCRC32CHasher(uint32_t initialValue = 0xFFFFFFFFu);
 }
 
 namespace kxf::Crypto
@@ -13,7 +89,10 @@ namespace kxf::Crypto
 	KX_API size_t Rot13(String& source) noexcept;
 	KX_API size_t UwUize(String& source) noexcept;
 
+	KX_API HashValue<32> CRC32(const void* data, size_t size, uint32_t initialValue = 0xFFFFFFFFu) noexcept;
 	KX_API HashValue<32> CRC32(IInputStream& stream, uint32_t initialValue = 0xFFFFFFFFu) noexcept;
+	KX_API HashValue<32> CRC32C(const void* data, size_t size, uint32_t initialValue = 0xFFFFFFFFu) noexcept;
+	KX_API HashValue<32> CRC32C(IInputStream& stream, uint32_t initialValue = 0xFFFFFFFFu) noexcept;
 	KX_API HashValue<128> MD5(IInputStream& stream) noexcept;
 
 	KX_API HashValue<160> SHA1(IInputStream& stream) noexcept;
@@ -33,7 +112,20 @@ namespace kxf::Crypto
 	KX_API HashValue<128> xxHash_128(const void* data, size_t size) noexcept;
 	KX_API HashValue<32> xxHash_32(IInputStream& stream) noexcept;
 	KX_API HashValue<64> xxHash_64(IInputStream& stream) noexcept;
+	KX_API HashValue<128> xxHash_128(IInputStream& stream) noexcept;
+
+	// Tree hash, large inputs are hashed in parallel if a running thread pool is provided. The calling thread takes part
+	// in hashing, so it's safe to call these from the pool's own tasks.
+	KX_API HashValue<256> BLAKE3(const void* data, size_t size, IThreadPool* threadPool = nullptr) noexcept;
+	KX_API HashValue<256> BLAKE3(IInputStream& stream, IThreadPool* threadPool = nullptr) noexcept;
+
+	KX_API size_t GetBase64EncodedSize(size_t size, FlagSet<Base64Flag> flags = {}) noexcept;
+	KX_API size_t GetBase64MaxDecodedSize(size_t size) noexcept;
+
+	// The buffer must be at least 'GetBase64EncodedSize' characters for encoding and 'GetBase64MaxDecodedSize' bytes for decoding
+	KX_API size_t Base64Encode(std::span<const std::byte> data, std::span<char> buffer, FlagSet<Base64Flag> flags = {}) noexcept;
+	KX_API std::optional<size_t> Base64Decode(std::span<const char> data, std::span<std::byte> buffer, FlagSet<Base64Flag> flags = Base64Flag::SkipWhitespace) noexcept;
 
-	KX_API bool Base64Encode(IInputStream& inputStream, IOutputStream& outputStream);
-	KX_API bool Base64Decode(IInputStream& inputStream, IOutputStream& outputStream);
+	KX_API bool Base64Encode(IInputStream& inputStream, IOutputStream& outputStream, FlagSet<Base64Flag> flags = {});
+	KX_API bool Base64Decode(IInputStream& inputStream, IOutputStream& outputStream, FlagSet<Base64Flag> flags = Base64Flag::SkipWhitespace);
 };
@@ -0,0 +1,105 @@
+#include "KxfPCH.h"
+#include "HashingStream.h"
+
+namespace
+{
+	size_t GetTransferred(kxf::DataSize size) noexcept
+	{
+		return size.IsValid() ? size.ToBytes<size_t>() : 0;
+	}
+
+	template<class TBuffer, class TFunc>
+	void ForEachTransferred(std::span<const std::span<TBuffer>> buffers, size_t size, TFunc&& func) noexcept
+	{
+		for (const auto& buffer: buffers)
+		{
+			if (size == 0)
+			{
+				break;
+			}
+
+			const size_t count = std::min(size, buffer.size());
+			std::invoke(func, buffer.data(), count);
+			size -= count;
+		}
+	}
+}
+
+namespace kxf::Crypto
+{
+	void HashingInputStream::UpdateHashers(const void* data, size_t size) noexcept
+	{
+		if (size != 0)
+		{
+			for (IHasher* hasher: m_Hashers)
+			{
+				hasher->Update(data, size);
+			}
+		}
+	}
+	void HashingInputStream::UpdateHashers(std::span<const std::span<std::byte>> buffers, size_t size) noexcept
+	{
+		ForEachTransferred(buffers, size, [&](const void* data, size_t count)
+		{
+			UpdateHashers(data, count);
+		});
+	}
+
+	IInputStream& HashingInputStream::Read(void* buffer, size_t size)
+	{
+		m_Stream->Read(buffer, size);
+		UpdateHashers(buffer, GetTransferred(m_Stream->LastRead()));
+
+		return *this;
+	}
+	IInputStream& HashingInputStream::ReadV(std::span<const std::span<std::byte>> buffers)
+	{
+		m_Stream->ReadV(buffers);
+		UpdateHashers(buffers, GetTransferred(m_Stream->LastRead()));
+
+		return *this;
+	}
+	std::span<const std::byte> HashingInputStream::ReadView(size_t size)
+	{
+		auto view = m_Stream->ReadView(size);
+		UpdateHashers(view.data(), view.size());
+
+		return view;
+	}
+}
+
+namespace kxf::Crypto
+{
+	void HashingOutputStream::UpdateHashers(const void* data, size_t size) noexcept
+	{
+		if (size != 0)
+		{
+			for (IHasher* hasher: m_Hashers)
+			{
+				hasher->Update(data, size);
+			}
+		}
+	}
+	void HashingOutputStream::UpdateHashers(std::span<const std::span<const std::byte>> buffers, size_t size) noexcept
+	{
+		ForEachTransferred(buffers, size, [&](const void* data, size_t count)
+		{
+			UpdateHashers(data, count);
+		});
+	}
+
+	IOutputStream& HashingOutputStream::Write(const void* buffer, size_t size)
+	{
+		m_Stream->Write(buffer, size);
+		UpdateHashers(buffer, GetTransferred(m_Stream->LastWrite()));
+
+		return *this;
+	}
+	IOutputStream& HashingOutputStream::WriteV(std::span<const std::span<const std::byte>> buffers)
+	{
+		m_Stream->WriteV(buffers);
+		UpdateHashers(buffers, GetTransferred(m_Stream->LastWrite()));
+
+		return *this;
+	}
+}
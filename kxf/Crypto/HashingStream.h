@@ -0,0 +1,138 @@
+#pragma once
+#include "Common.h"
+#include "Crypto.h"
+#include "kxf/IO/StreamDelegate.h"
+
+namespace kxf::Crypto
+{
+	// Passes everything read from the underlying stream to the attached hashers, so any number of hashes can be
+	// calculated in a single pass over the data. Hashers aren't owned by the stream. Seeking is disabled as it would
+	// make the hashes skip or repeat parts of the data.
+	class KX_API HashingInputStream: public InputStreamDelegate
+	{
+		private:
+			std::vector<IHasher*> m_Hashers;
+
+		private:
+			void UpdateHashers(const void* data, size_t size) noexcept;
+			void UpdateHashers(std::span<const std::span<std::byte>> buffers, size_t size) noexcept;
+
+		public:
+			HashingInputStream(IInputStream& stream)
+				:InputStreamDelegate(stream)
+			{
+			}
+			HashingInputStream(std::unique_ptr<IInputStream> stream)
+				:InputStreamDelegate(std::move(stream))
+			{
+			}
+			HashingInputStream(HashingInputStream&&) noexcept = default;
+			HashingInputStream(const HashingInputStream&) = delete;
+
+		public:
+			// IStream
+			bool IsSeekable() const override
+			{
+				return false;
+			}
+
+			// IInputStream
+			IInputStream& Read(void* buffer, size_t size) override;
+			IInputStream& Read(IOutputStream& other) override
+			{
+				return IInputStream::Read(other);
+			}
+			bool ReadAll(void* buffer, size_t size) override
+			{
+				return IInputStream::ReadAll(buffer, size);
+			}
+			IInputStream& ReadV(std::span<const std::span<std::byte>> buffers) override;
+			std::span<const std::byte> ReadView(size_t size) override;
+
+			DataSize SeekI(DataSize offset, IOStreamSeek seek) override
+			{
+				return {};
+			}
+
+			// HashingInputStream
+			HashingInputStream& AddHasher(IHasher& hasher)
+			{
+				m_Hashers.emplace_back(&hasher);
+				return *this;
+			}
+			void RemoveHashers() noexcept
+			{
+				m_Hashers.clear();
+			}
+
+		public:
+			HashingInputStream& operator=(HashingInputStream&&) noexcept = default;
+			HashingInputStream& operator=(const HashingInputStream&) = delete;
+	};
+}
+
+namespace kxf::Crypto
+{
+	// Passes everything written to the underlying stream to the attached hashers. Only the data the underlying
+	// stream actually accepted is hashed.
+	class KX_API HashingOutputStream: public OutputStreamDelegate
+	{
+		private:
+			std::vector<IHasher*> m_Hashers;
+
+		private:
+			void UpdateHashers(const void* data, size_t size) noexcept;
+			void UpdateHashers(std::span<const std::span<const std::byte>> buffers, size_t size) noexcept;
+
+		public:
+			HashingOutputStream(IOutputStream& stream)
+				:OutputStreamDelegate(stream)
+			{
+			}
+			HashingOutputStream(std::unique_ptr<IOutputStream> stream)
+				:OutputStreamDelegate(std::move(stream))
+			{
+			}
+			HashingOutputStream(HashingOutputStream&&) noexcept = default;
+			HashingOutputStream(const HashingOutputStream&) = delete;
+
+		public:
+			// IStream
+			bool IsSeekable() const override
+			{
+				return false;
+			}
+
+			// IOutputStream
+			IOutputStream& Write(const void* buffer, size_t size) override;
+			IOutputStream& Write(IInputStream& other) override
+			{
+				return IOutputStream::Write(other);
+			}
+			bool WriteAll(const void* buffer, size_t size) override
+			{
+				return IOutputStream::WriteAll(buffer, size);
+			}
+			IOutputStream& WriteV(std::span<const std::span<const std::byte>> buffers) override;
+
+			DataSize SeekO(DataSize offset, IOStreamSeek seek) override
+			{
+				return {};
+			}
+
+			// HashingOutputStream
+			HashingOutputStream& AddHasher(IHasher& hasher)
+			{
+				m_Hashers.emplace_back(&hasher);
+				return *this;
+			}
+			void RemoveHashers() noexcept
+			{
+				m_Hashers.clear();
+			}
+
+		public:
+			HashingOutputStream& operator=(HashingOutputStream&&) noexcept = default;
+			HashingOutputStream& operator=(const HashingOutputStream&) = delete;
+	};
+}
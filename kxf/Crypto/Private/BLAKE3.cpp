@@ -0,0 +1,705 @@
+#include "KxfPCH.h"
+#include "BLAKE3.h"
+#include "kxf/IO/IStream.h"
+#include "kxf/Core/IAsyncTask.h"
+#include "kxf/Threading/IThreadPool.h"
+#include "kxf/Threading/Parallel.h"
+#include "kxf/System/SystemInformation.h"
+#include <deque>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#define KXF_BLAKE3_X86 1
+#endif
+
+namespace
+{
+	using namespace kxf;
+	using kxf::Crypto::HashValue;
+	using kxf::Crypto::Private::BLAKE3Hasher;
+	using ChainingValue = BLAKE3Hasher::ChainingValue;
+
+	constexpr size_t g_BlockSize = BLAKE3Hasher::BlockSize;
+	constexpr size_t g_ChunkSize = BLAKE3Hasher::ChunkSize;
+	constexpr size_t g_BlocksPerChunk = g_ChunkSize / g_BlockSize;
+
+	// Smallest subtree worth a task of its own and the subtree size used when hashing streams
+	constexpr size_t g_MinSubtreeSize = 256 * g_ChunkSize;
+	constexpr size_t g_StreamSubtreeSize = 1024 * g_ChunkSize;
+
+	constexpr ChainingValue g_IV = {0x6A09E667u, 0xBB67AE85u, 0x3C6EF372u, 0xA54FF53Au, 0x510E527Fu, 0x9B05688Cu, 0x1F83D9ABu, 0x5BE0CD19u};
+	constexpr uint8_t g_MessageSchedule[7][16] =
+	{
+		{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+		{2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+		{3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+		{10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+		{12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+		{9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+		{11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13}
+	};
+
+	enum Flag: uint32_t
+	{
+		ChunkStart = 1 << 0,
+		ChunkEnd = 1 << 1,
+		Parent = 1 << 2,
+		Root = 1 << 3
+	};
+
+	// The round function is written once for scalar words and for vectors holding the same word of several inputs
+	struct ScalarOps final
+	{
+		using T = uint32_t;
+
+		static T Add(T a, T b) noexcept
+		{
+			return a + b;
+		}
+		static T Xor(T a, T b) noexcept
+		{
+			return a ^ b;
+		}
+		template<int n>
+		static T RotateRight(T value) noexcept
+		{
+			return std::rotr(value, n);
+		}
+	};
+
+	template<class Ops, class T = typename Ops::T>
+	void G(T (&v)[16], size_t a, size_t b, size_t c, size_t d, T x, T y) noexcept
+	{
+		v[a] = Ops::Add(Ops::Add(v[a], v[b]), x);
+		v[d] = Ops::template RotateRight<16>(Ops::Xor(v[d], v[a]));
+		v[c] = Ops::Add(v[c], v[d]);
+		v[b] = Ops::template RotateRight<12>(Ops::Xor(v[b], v[c]));
+		v[a] = Ops::Add(Ops::Add(v[a], v[b]), y);
+		v[d] = Ops::template RotateRight<8>(Ops::Xor(v[d], v[a]));
+		v[c] = Ops::Add(v[c], v[d]);
+		v[b] = Ops::template RotateRight<7>(Ops::Xor(v[b], v[c]));
+	}
+
+	template<class Ops, class T = typename Ops::T>
+	void Rounds(T (&v)[16], const T (&m)[16]) noexcept
+	{
+		for (const auto& s: g_MessageSchedule)
+		{
+			G<Ops>(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+			G<Ops>(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+			G<Ops>(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+			G<Ops>(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+			G<Ops>(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+			G<Ops>(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+			G<Ops>(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+			G<Ops>(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+		}
+	}
+
+	void Compress(const ChainingValue& cv, const uint8_t* block, uint32_t blockLength, uint64_t counter, uint32_t flags, uint32_t (&state)[16]) noexcept
+	{
+		uint32_t m[16] = {};
+		std::memcpy(m, block, sizeof(m));
+
+		for (size_t i = 0; i < 8; i++)
+		{
+			state[i] = cv[i];
+		}
+		state[8] = g_IV[0];
+		state[9] = g_IV[1];
+		state[10] = g_IV[2];
+		state[11] = g_IV[3];
+		state[12] = static_cast<uint32_t>(counter);
+		state[13] = static_cast<uint32_t>(counter >> 32);
+		state[14] = blockLength;
+		state[15] = flags;
+
+		Rounds<ScalarOps>(state, m);
+	}
+	void CompressInPlace(ChainingValue& cv, const uint8_t* block, uint32_t blockLength, uint64_t counter, uint32_t flags) noexcept
+	{
+		uint32_t state[16] = {};
+		Compress(cv, block, blockLength, counter, flags, state);
+
+		for (size_t i = 0; i < 8; i++)
+		{
+			cv[i] = state[i] ^ state[i + 8];
+		}
+	}
+
+	BLAKE3Hasher::Output GetParentOutput(const ChainingValue& left, const ChainingValue& right) noexcept
+	{
+		BLAKE3Hasher::Output output;
+		output.InputCV = g_IV;
+		std::memcpy(output.Block, left.data(), sizeof(left));
+		std::memcpy(output.Block + sizeof(left), right.data(), sizeof(right));
+		output.BlockLength = g_BlockSize;
+		output.Flags = Flag::Parent;
+
+		return output;
+	}
+
+	// Chaining values of the complete subtrees are kept on a stack and two neighbours are merged as soon as they form a larger
+	// complete subtree. That's the case while the total number of subtrees of the same size is even.
+	void PushSubtree(ChainingValue* stack, size_t& stackSize, ChainingValue cv, uint64_t totalSubtrees) noexcept
+	{
+		for (; totalSubtrees % 2 == 0; totalSubtrees /= 2)
+		{
+			cv = GetParentOutput(stack[--stackSize], cv).GetChainingValue();
+		}
+		stack[stackSize++] = cv;
+	}
+	BLAKE3Hasher::Output MergeSubtrees(const ChainingValue* stack, size_t stackSize, BLAKE3Hasher::Output output) noexcept
+	{
+		while (stackSize != 0)
+		{
+			output = GetParentOutput(stack[--stackSize], output.GetChainingValue());
+		}
+		return output;
+	}
+
+	// Hashes whole chunks, one input per lane. Counter of the chunk 'i' is 'counter + i'.
+	void HashChunksScalar(const uint8_t* data, size_t count, uint64_t counter, ChainingValue* result) noexcept
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			ChainingValue cv = g_IV;
+			for (size_t j = 0; j < g_BlocksPerChunk; j++)
+			{
+				const uint32_t flags = (j == 0 ? Flag::ChunkStart : 0)|(j == g_BlocksPerChunk - 1 ? Flag::ChunkEnd : 0);
+				CompressInPlace(cv, data + i * g_ChunkSize + j * g_BlockSize, g_BlockSize, counter + i, flags);
+			}
+			result[i] = cv;
+		}
+	}
+
+	#if KXF_BLAKE3_X86
+	struct SSSE3Ops final
+	{
+		using T = __m128i;
+		static constexpr size_t Lanes = 4;
+
+		static T Add(T a, T b) noexcept
+		{
+			return _mm_add_epi32(a, b);
+		}
+		static T Xor(T a, T b) noexcept
+		{
+			return _mm_xor_si128(a, b);
+		}
+		static T Set(uint32_t value) noexcept
+		{
+			return _mm_set1_epi32(static_cast<int>(value));
+		}
+		static T Load(const uint32_t* values) noexcept
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+		}
+		static void Store(uint32_t* values, T value) noexcept
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values), value);
+		}
+
+		template<int n>
+		static T RotateRight(T value) noexcept
+		{
+			if constexpr(n == 16)
+			{
+				return _mm_shuffle_epi8(value, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+			}
+			else if constexpr(n == 8)
+			{
+				return _mm_shuffle_epi8(value, _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+			}
+			else
+			{
+				return _mm_or_si128(_mm_srli_epi32(value, n), _mm_slli_epi32(value, 32 - n));
+			}
+		}
+
+		// Loads the block at 'offset' of each input and transposes it so 'm[i]' holds the word 'i' of every input
+		static void LoadMessage(const uint8_t* data, size_t offset, T (&m)[16]) noexcept
+		{
+			for (size_t i = 0; i < 16; i += 4)
+			{
+				T r[4];
+				for (size_t lane = 0; lane < Lanes; lane++)
+				{
+					r[lane] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + lane * g_ChunkSize + offset + i * 4));
+				}
+
+				const T t0 = _mm_unpacklo_epi32(r[0], r[1]);
+				const T t1 = _mm_unpacklo_epi32(r[2], r[3]);
+				const T t2 = _mm_unpackhi_epi32(r[0], r[1]);
+				const T t3 = _mm_unpackhi_epi32(r[2], r[3]);
+				m[i + 0] = _mm_unpacklo_epi64(t0, t1);
+				m[i + 1] = _mm_unpackhi_epi64(t0, t1);
+				m[i + 2] = _mm_unpacklo_epi64(t2, t3);
+				m[i + 3] = _mm_unpackhi_epi64(t2, t3);
+			}
+		}
+	};
+
+	struct AVX2Ops final
+	{
+		using T = __m256i;
+		static constexpr size_t Lanes = 8;
+
+		static T Add(T a, T b) noexcept
+		{
+			return _mm256_add_epi32(a, b);
+		}
+		static T Xor(T a, T b) noexcept
+		{
+			return _mm256_xor_si256(a, b);
+		}
+		static T Set(uint32_t value) noexcept
+		{
+			return _mm256_set1_epi32(static_cast<int>(value));
+		}
+		static T Load(const uint32_t* values) noexcept
+		{
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+		}
+		static void Store(uint32_t* values, T value) noexcept
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(values), value);
+		}
+
+		template<int n>
+		static T RotateRight(T value) noexcept
+		{
+			if constexpr(n == 16)
+			{
+				return _mm256_shuffle_epi8(value, _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13)));
+			}
+			else if constexpr(n == 8)
+			{
+				return _mm256_shuffle_epi8(value, _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12)));
+			}
+			else
+			{
+				return _mm256_or_si256(_mm256_srli_epi32(value, n), _mm256_slli_epi32(value, 32 - n));
+			}
+		}
+
+		static void LoadMessage(const uint8_t* data, size_t offset, T (&m)[16]) noexcept
+		{
+			for (size_t i = 0; i < 16; i += 8)
+			{
+				T r[8];
+				for (size_t lane = 0; lane < Lanes; lane++)
+				{
+					r[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + lane * g_ChunkSize + offset + i * 4));
+				}
+
+				// 8x8 transpose: interleave dwords, then qwords, then swap the 128-bit halves
+				const T t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+				const T t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+				const T t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+				const T t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+				const T t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+				const T t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+				const T t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+				const T t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+				const T u0 = _mm256_unpacklo_epi64(t0, t2);
+				const T u1 = _mm256_unpackhi_epi64(t0, t2);
+				const T u2 = _mm256_unpacklo_epi64(t1, t3);
+				const T u3 = _mm256_unpackhi_epi64(t1, t3);
+				const T u4 = _mm256_unpacklo_epi64(t4, t6);
+				const T u5 = _mm256_unpackhi_epi64(t4, t6);
+				const T u6 = _mm256_unpacklo_epi64(t5, t7);
+				const T u7 = _mm256_unpackhi_epi64(t5, t7);
+
+				m[i + 0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+				m[i + 1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+				m[i + 2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+				m[i + 3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+				m[i + 4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+				m[i + 5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+				m[i + 6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+				m[i + 7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+			}
+		}
+	};
+
+	// Hashes 'Ops::Lanes' consecutive chunks at once, each lane of a vector works on its own chunk
+	template<class Ops, class T = typename Ops::T>
+	void HashChunksSIMD(const uint8_t* data, uint64_t counter, ChainingValue* result) noexcept
+	{
+		uint32_t counterLow[Ops::Lanes] = {};
+		uint32_t counterHigh[Ops::Lanes] = {};
+		for (size_t lane = 0; lane < Ops::Lanes; lane++)
+		{
+			counterLow[lane] = static_cast<uint32_t>(counter + lane);
+			counterHigh[lane] = static_cast<uint32_t>((counter + lane) >> 32);
+		}
+
+		T h[8];
+		for (size_t i = 0; i < 8; i++)
+		{
+			h[i] = Ops::Set(g_IV[i]);
+		}
+
+		for (size_t j = 0; j < g_BlocksPerChunk; j++)
+		{
+			const uint32_t flags = (j == 0 ? Flag::ChunkStart : 0)|(j == g_BlocksPerChunk - 1 ? Flag::ChunkEnd : 0);
+
+			T m[16];
+			Ops::LoadMessage(data, j * g_BlockSize, m);
+
+			T v[16] =
+			{
+				h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7],
+				Ops::Set(g_IV[0]), Ops::Set(g_IV[1]), Ops::Set(g_IV[2]), Ops::Set(g_IV[3]),
+				Ops::Load(counterLow), Ops::Load(counterHigh), Ops::Set(g_BlockSize), Ops::Set(flags)
+			};
+			Rounds<Ops>(v, m);
+
+			for (size_t i = 0; i < 8; i++)
+			{
+				h[i] = Ops::Xor(v[i], v[i + 8]);
+			}
+		}
+
+		uint32_t words[8][Ops::Lanes] = {};
+		for (size_t i = 0; i < 8; i++)
+		{
+			Ops::Store(words[i], h[i]);
+		}
+		for (size_t lane = 0; lane < Ops::Lanes; lane++)
+		{
+			for (size_t i = 0; i < 8; i++)
+			{
+				result[lane][i] = words[i][lane];
+			}
+		}
+	}
+	#endif
+
+	void HashChunks(const uint8_t* data, size_t count, uint64_t counter, ChainingValue* result) noexcept
+	{
+		#if KXF_BLAKE3_X86
+		static const bool hasAVX2 = System::HasFeature(ProcessorFeature::AVX2);
+		static const bool hasSSSE3 = System::HasFeature(ProcessorFeature::SSSE3);
+
+		if (hasAVX2)
+		{
+			for (; count >= AVX2Ops::Lanes; count -= AVX2Ops::Lanes)
+			{
+				HashChunksSIMD<AVX2Ops>(data, counter, result);
+				data += AVX2Ops::Lanes * g_ChunkSize;
+				counter += AVX2Ops::Lanes;
+				result += AVX2Ops::Lanes;
+			}
+			_mm256_zeroupper();
+		}
+		if (hasSSSE3)
+		{
+			for (; count >= SSSE3Ops::Lanes; count -= SSSE3Ops::Lanes)
+			{
+				HashChunksSIMD<SSSE3Ops>(data, counter, result);
+				data += SSSE3Ops::Lanes * g_ChunkSize;
+				counter += SSSE3Ops::Lanes;
+				result += SSSE3Ops::Lanes;
+			}
+		}
+		#endif
+
+		HashChunksScalar(data, count, counter, result);
+	}
+
+	BLAKE3Hasher::Output HashSubtree(const uint8_t* data, size_t size, uint64_t chunkCounter) noexcept
+	{
+		BLAKE3Hasher hasher(chunkCounter);
+		hasher.Update(data, size);
+		return hasher.GetOutput();
+	}
+	template<class TRange>
+	HashValue<256> MergeSubtrees(const TRange& subtrees, const BLAKE3Hasher::Output& lastSubtree) noexcept
+	{
+		ChainingValue stack[54];
+		size_t stackSize = 0;
+
+		uint64_t totalSubtrees = 0;
+		for (const ChainingValue& cv: subtrees)
+		{
+			PushSubtree(stack, stackSize, cv, ++totalSubtrees);
+		}
+		return MergeSubtrees(stack, stackSize, lastSubtree).GetRootHash();
+	}
+}
+
+namespace kxf::Crypto::Private
+{
+	auto BLAKE3Hasher::Output::GetChainingValue() const noexcept -> ChainingValue
+	{
+		ChainingValue cv = InputCV;
+		CompressInPlace(cv, Block, BlockLength, Counter, Flags);
+
+		return cv;
+	}
+	HashValue<256> BLAKE3Hasher::Output::GetRootHash() const noexcept
+	{
+		// Only the first 32 bytes of the extendable output are needed, those come from the first root block
+		uint32_t state[16] = {};
+		Compress(InputCV, Block, BlockLength, 0, Flags|Flag::Root, state);
+
+		uint32_t hash[8] = {};
+		for (size_t i = 0; i < 8; i++)
+		{
+			hash[i] = state[i] ^ state[i + 8];
+		}
+		return HashValue<256>(hash, sizeof(hash));
+	}
+
+	void BLAKE3Hasher::StartChunk(uint64_t counter) noexcept
+	{
+		m_ChunkCV = g_IV;
+		m_ChunkCounter = counter;
+		m_BlockLength = 0;
+		m_BlocksCompressed = 0;
+		std::memset(m_Block, 0, sizeof(m_Block));
+	}
+	void BLAKE3Hasher::UpdateChunk(const uint8_t* data, size_t size) noexcept
+	{
+		while (size != 0)
+		{
+			// The last block of the chunk is kept as it needs the 'ChunkEnd' flag
+			if (m_BlockLength == BlockSize)
+			{
+				CompressInPlace(m_ChunkCV, m_Block, BlockSize, m_ChunkCounter, m_BlocksCompressed == 0 ? Flag::ChunkStart : 0);
+				m_BlocksCompressed++;
+				m_BlockLength = 0;
+				std::memset(m_Block, 0, sizeof(m_Block));
+			}
+
+			const size_t count = std::min(BlockSize - m_BlockLength, size);
+			std::memcpy(m_Block + m_BlockLength, data, count);
+			m_BlockLength += count;
+			data += count;
+			size -= count;
+		}
+	}
+	auto BLAKE3Hasher::GetChunkOutput() const noexcept -> Output
+	{
+		Output output;
+		output.InputCV = m_ChunkCV;
+		std::memcpy(output.Block, m_Block, sizeof(m_Block));
+		output.Counter = m_ChunkCounter;
+		output.BlockLength = static_cast<uint32_t>(m_BlockLength);
+		output.Flags = (m_BlocksCompressed == 0 ? Flag::ChunkStart : 0)|Flag::ChunkEnd;
+
+		return output;
+	}
+
+	void BLAKE3Hasher::Reset() noexcept
+	{
+		StartChunk(m_BaseCounter);
+		m_StackSize = 0;
+	}
+	void BLAKE3Hasher::Update(const void* data, size_t size) noexcept
+	{
+		auto bytes = static_cast<const uint8_t*>(data);
+		while (size != 0)
+		{
+			// A full chunk is only closed once more input arrives, the last one needs to stay open for 'GetOutput'
+			if (GetChunkLength() == ChunkSize)
+			{
+				PushSubtree(m_Stack, m_StackSize, GetChunkOutput().GetChainingValue(), m_ChunkCounter - m_BaseCounter + 1);
+				StartChunk(m_ChunkCounter + 1);
+			}
+
+			if (GetChunkLength() == 0 && size > ChunkSize)
+			{
+				// Whole chunks followed by more input go through the SIMD kernels in batches
+				ChainingValue cvs[16];
+				const size_t count = std::min((size - 1) / ChunkSize, std::size(cvs));
+				HashChunks(bytes, count, m_ChunkCounter, cvs);
+
+				for (size_t i = 0; i < count; i++)
+				{
+					PushSubtree(m_Stack, m_StackSize, cvs[i], m_ChunkCounter - m_BaseCounter + 1);
+					m_ChunkCounter++;
+				}
+				StartChunk(m_ChunkCounter);
+
+				bytes += count * ChunkSize;
+				size -= count * ChunkSize;
+			}
+			else
+			{
+				const size_t count = std::min(ChunkSize - GetChunkLength(), size);
+				UpdateChunk(bytes, count);
+
+				bytes += count;
+				size -= count;
+			}
+		}
+	}
+	auto BLAKE3Hasher::GetOutput() const noexcept -> Output
+	{
+		return MergeSubtrees(m_Stack, m_StackSize, GetChunkOutput());
+	}
+}
+
+namespace kxf::Crypto::Private
+{
+	HashValue<256> CalcBLAKE3(const void* data, size_t size, IThreadPool* threadPool) noexcept
+	{
+		auto bytes = static_cast<const uint8_t*>(data);
+		const size_t concurrency = threadPool && threadPool->IsRunning() ? threadPool->GetConcurrency() : 1;
+
+		// Aim for a few subtrees per thread, subtree size must be a power of two number of chunks
+		const size_t chunkCount = (size + g_ChunkSize - 1) / g_ChunkSize;
+		const size_t subtreeSize = std::max(std::bit_floor(chunkCount / std::max<size_t>(concurrency * 4, 1)) * g_ChunkSize, g_MinSubtreeSize);
+		if (concurrency <= 1 || size <= subtreeSize)
+		{
+			return HashSubtree(bytes, size, 0).GetRootHash();
+		}
+
+		// Every subtree but the last one is complete so their chaining values can be computed independently
+		const size_t subtreeCount = (size + subtreeSize - 1) / subtreeSize;
+		const uint64_t subtreeChunks = subtreeSize / g_ChunkSize;
+
+		// The calling thread hashes subtrees as well, so this can't deadlock when called from one of the pool's own tasks
+		std::vector<ChainingValue> subtrees(subtreeCount - 1);
+		Parallel::For(*threadPool, 0, subtrees.size(), [&](size_t i)
+		{
+			subtrees[i] = HashSubtree(bytes + i * subtreeSize, subtreeSize, i * subtreeChunks).GetChainingValue();
+		}, 1);
+
+		const size_t lastOffset = subtrees.size() * subtreeSize;
+		const auto lastSubtree = HashSubtree(bytes + lastOffset, size - lastOffset, subtrees.size() * subtreeChunks);
+		return MergeSubtrees(subtrees, lastSubtree);
+	}
+	HashValue<256> CalcBLAKE3(IInputStream& stream, IThreadPool* threadPool) noexcept
+	{
+		// A stopped pool accepts tasks but never runs them
+		if (threadPool && !threadPool->IsRunning())
+		{
+			threadPool = nullptr;
+		}
+
+		// Streams which can give all of their content at once, like memory streams or mapped files, are hashed in place
+		auto pending = stream.ReadView(std::numeric_limits<size_t>::max());
+		if (!pending.empty() && !stream.CanRead())
+		{
+			return CalcBLAKE3(pending.data(), pending.size(), threadPool);
+		}
+
+		// Otherwise the stream is read sequentially and each complete subtree is hashed on the pool while the next one
+		// is being read. A subtree is known to be complete only after some data after it was read.
+		struct Slot final
+		{
+			std::vector<uint8_t> Buffer;
+			size_t Size = 0;
+
+			ChainingValue* Result = nullptr;
+			uint64_t Counter = 0;
+			std::shared_ptr<std::atomic<bool>> IsClaimed;
+			std::shared_ptr<IAsyncTask> Task;
+
+			void Hash() noexcept
+			{
+				*Result = HashSubtree(Buffer.data(), g_StreamSubtreeSize, Counter).GetChainingValue();
+			}
+			void Wait()
+			{
+				if (Task)
+				{
+					// Hash the subtree here if no worker has picked the task up yet. Waiting for it can otherwise
+					// never end when all workers are busy, for example when this is called from a task of the same pool.
+					if (!IsClaimed->exchange(true, std::memory_order_acq_rel))
+					{
+						Hash();
+					}
+					else
+					{
+						Task->WaitCompletion();
+					}
+					Task = nullptr;
+				}
+			}
+		};
+
+		const size_t concurrency = threadPool ? std::max<size_t>(threadPool->GetConcurrency(), 1) : 1;
+		std::vector<Slot> slots(concurrency + 1);
+		for (Slot& slot: slots)
+		{
+			slot.Buffer.resize(g_StreamSubtreeSize);
+		}
+
+		auto ReadSlot = [&](Slot& slot)
+		{
+			slot.Wait();
+			slot.Size = 0;
+
+			while (slot.Size != slot.Buffer.size())
+			{
+				const size_t free = slot.Buffer.size() - slot.Size;
+				if (!pending.empty())
+				{
+					const size_t count = std::min(pending.size(), free);
+					std::memcpy(slot.Buffer.data() + slot.Size, pending.data(), count);
+					pending = pending.subspan(count);
+					slot.Size += count;
+				}
+				else if (const DataSize read = stream.Read(slot.Buffer.data() + slot.Size, free).LastRead(); read.IsValid() && read != 0)
+				{
+					slot.Size += read.ToBytes<size_t>();
+				}
+				else
+				{
+					break;
+				}
+			}
+		};
+
+		std::deque<ChainingValue> subtrees;
+		const uint64_t subtreeChunks = g_StreamSubtreeSize / g_ChunkSize;
+
+		size_t current = 0;
+		ReadSlot(slots[current]);
+		while (true)
+		{
+			const size_t next = (current + 1) % slots.size();
+			ReadSlot(slots[next]);
+			if (slots[next].Size == 0)
+			{
+				break;
+			}
+
+			// The deque never moves its elements so the slot can keep the pointer
+			Slot& slot = slots[current];
+			slot.Result = &subtrees.emplace_back();
+			slot.Counter = (subtrees.size() - 1) * subtreeChunks;
+
+			if (threadPool)
+			{
+				// The task only touches the slot if it gets to claim it first, the slot is otherwise already reused
+				slot.IsClaimed = std::make_shared<std::atomic<bool>>(false);
+				slot.Task = threadPool->AddTask([&slot, isClaimed = slot.IsClaimed]()
+				{
+					if (!isClaimed->exchange(true, std::memory_order_acq_rel))
+					{
+						slot.Hash();
+					}
+				});
+			}
+			if (!slot.Task)
+			{
+				slot.Hash();
+			}
+			current = next;
+		}
+
+		const auto lastSubtree = HashSubtree(slots[current].Buffer.data(), slots[current].Size, subtrees.size() * subtreeChunks);
+		for (Slot& slot: slots)
+		{
+			slot.Wait();
+		}
+		return MergeSubtrees(subtrees, lastSubtree);
+	}
+}
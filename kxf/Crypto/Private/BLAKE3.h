@@ -0,0 +1,76 @@
+#pragma once
+#include "../Common.h"
+#include "../HashValue.h"
+
+namespace kxf
+{
+	class IInputStream;
+	class IThreadPool;
+}
+
+namespace kxf::Crypto::Private
+{
+	// Incremental BLAKE3 in the default hash mode. Can also hash a subtree of a larger input starting at a given chunk,
+	// the parallel functions below use that to hash independent parts of the input concurrently.
+	class BLAKE3Hasher final
+	{
+		public:
+			static constexpr size_t BlockSize = 64;
+			static constexpr size_t ChunkSize = 1024;
+
+			using ChainingValue = std::array<uint32_t, 8>;
+			struct Output final
+			{
+				ChainingValue InputCV = {};
+				uint8_t Block[BlockSize] = {};
+				uint64_t Counter = 0;
+				uint32_t BlockLength = 0;
+				uint32_t Flags = 0;
+
+				ChainingValue GetChainingValue() const noexcept;
+				HashValue<256> GetRootHash() const noexcept;
+			};
+
+		private:
+			uint64_t m_BaseCounter = 0;
+
+			// Current chunk
+			ChainingValue m_ChunkCV = {};
+			uint64_t m_ChunkCounter = 0;
+			uint8_t m_Block[BlockSize] = {};
+			size_t m_BlockLength = 0;
+			size_t m_BlocksCompressed = 0;
+
+			// Chaining values of the completed subtrees, enough for 2^64 bytes of input
+			ChainingValue m_Stack[54] = {};
+			size_t m_StackSize = 0;
+
+		private:
+			void StartChunk(uint64_t counter) noexcept;
+			void UpdateChunk(const uint8_t* data, size_t size) noexcept;
+			Output GetChunkOutput() const noexcept;
+			size_t GetChunkLength() const noexcept
+			{
+				return m_BlocksCompressed * BlockSize + m_BlockLength;
+			}
+
+		public:
+			BLAKE3Hasher(uint64_t chunkCounter = 0) noexcept
+				:m_BaseCounter(chunkCounter)
+			{
+				Reset();
+			}
+
+		public:
+			void Reset() noexcept;
+			void Update(const void* data, size_t size) noexcept;
+
+			// Output of the root node of everything hashed so far. It's the hash itself when hashing the whole input
+			// or the chaining value of the subtree otherwise.
+			Output GetOutput() const noexcept;
+	};
+
+	// Hash the input in parallel subtrees on the thread pool, sequential if there's no pool or the input is small
+	HashValue<256> CalcBLAKE3(const void* data, size_t size, IThreadPool* threadPool) noexcept;
+	HashValue<256> CalcBLAKE3(IInputStream& stream, IThreadPool* threadPool) noexcept;
+}
@@ -0,0 +1,427 @@
+#include "KxfPCH.h"
+#include "Base64.h"
+#include "kxf/System/SystemInformation.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#define KXF_BASE64_X86 1
+#endif
+
+namespace
+{
+	using namespace kxf;
+
+	constexpr char g_Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	constexpr char g_AlphabetURL[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+	template<const char(&t_Alphabet)[65]>
+	constexpr std::array<int8_t, 256> MakeDecodeTable() noexcept
+	{
+		std::array<int8_t, 256> table = {};
+		table.fill(-1);
+		for (size_t i = 0; i < 64; i++)
+		{
+			table[static_cast<uint8_t>(t_Alphabet[i])] = static_cast<int8_t>(i);
+		}
+		return table;
+	}
+	constexpr auto g_DecodeTable = MakeDecodeTable<g_Alphabet>();
+	constexpr auto g_DecodeTableURL = MakeDecodeTable<g_AlphabetURL>();
+
+	constexpr bool IsWhitespace(uint8_t c) noexcept
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+	}
+
+	void EncodeGroup(const uint8_t* data, char* buffer, const char* alphabet) noexcept
+	{
+		const uint32_t value = (uint32_t(data[0]) << 16)|(uint32_t(data[1]) << 8)|uint32_t(data[2]);
+		buffer[0] = alphabet[(value >> 18) & 0x3Fu];
+		buffer[1] = alphabet[(value >> 12) & 0x3Fu];
+		buffer[2] = alphabet[(value >> 6) & 0x3Fu];
+		buffer[3] = alphabet[value & 0x3Fu];
+	}
+
+	#if KXF_BASE64_X86
+	// SIMD kernels work on 12/24 byte groups, see "Base64 encoding and decoding at almost the speed of a memory copy"
+	// by W. Mula and D. Lemire. Both alphabets differ only in the last two characters, so those are passed in.
+	__m128i EncodeReshuffle(__m128i data) noexcept
+	{
+		// Spreads each 3 bytes over 4 bytes and moves every 6-bit group into its own byte
+		data = _mm_shuffle_epi8(data, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(data, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+		const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(data, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+		return _mm_or_si128(t0, t1);
+	}
+	__m128i EncodeTranslate(__m128i sextets, __m128i lut) noexcept
+	{
+		// 0-25 map to index 0, 26-51 to 1, 52-61 to 2-11, 62 to 12 and 63 to 13 of the offset table
+		__m128i indices = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+		indices = _mm_sub_epi8(indices, _mm_cmpgt_epi8(sextets, _mm_set1_epi8(25)));
+		return _mm_add_epi8(sextets, _mm_shuffle_epi8(lut, indices));
+	}
+	__m128i MakeEncodeLUT(const char* alphabet) noexcept
+	{
+		return _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, static_cast<char>(alphabet[62] - 62), static_cast<char>(alphabet[63] - 63), 0, 0);
+	}
+
+	size_t EncodeSSSE3(const uint8_t* data, size_t size, char* buffer, const char* alphabet) noexcept
+	{
+		// Each step loads 16 bytes and uses 12 of them
+		const __m128i lut = MakeEncodeLUT(alphabet);
+		size_t consumed = 0;
+		for (; size - consumed >= 16; consumed += 12, buffer += 16)
+		{
+			const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + consumed));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), EncodeTranslate(EncodeReshuffle(value), lut));
+		}
+		return consumed;
+	}
+	size_t EncodeAVX2(const uint8_t* data, size_t size, char* buffer, const char* alphabet) noexcept
+	{
+		const __m128i lut128 = MakeEncodeLUT(alphabet);
+		const __m256i lut = _mm256_broadcastsi128_si256(lut128);
+		const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+		size_t consumed = 0;
+		for (; size - consumed >= 32; consumed += 24, buffer += 32)
+		{
+			// Two 12 byte groups, one per lane
+			const uint8_t* source = data + consumed;
+			__m256i value = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 12)), 1);
+			value = _mm256_shuffle_epi8(value, shuffle);
+
+			const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(value, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+			const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(value, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+			const __m256i sextets = _mm256_or_si256(t0, t1);
+
+			__m256i indices = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+			indices = _mm256_sub_epi8(indices, _mm256_cmpgt_epi8(sextets, _mm256_set1_epi8(25)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), _mm256_add_epi8(sextets, _mm256_shuffle_epi8(lut, indices)));
+		}
+		_mm256_zeroupper();
+
+		return consumed;
+	}
+
+	// Maps characters to their 6-bit values, 'isValid' is false if any of them isn't in the alphabet
+	__m128i DecodeTranslate(__m128i value, const char* alphabet, bool& isValid) noexcept
+	{
+		auto InRange = [&](char first, char last)
+		{
+			return _mm_and_si128(_mm_cmpgt_epi8(value, _mm_set1_epi8(first - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(last + 1), value));
+		};
+
+		const __m128i upper = InRange('A', 'Z');
+		const __m128i lower = InRange('a', 'z');
+		const __m128i digit = InRange('0', '9');
+		const __m128i c62 = _mm_cmpeq_epi8(value, _mm_set1_epi8(alphabet[62]));
+		const __m128i c63 = _mm_cmpeq_epi8(value, _mm_set1_epi8(alphabet[63]));
+
+		const __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, c62)), c63);
+		isValid = _mm_movemask_epi8(valid) == 0xFFFF;
+
+		__m128i offset = _mm_and_si128(upper, _mm_set1_epi8(-65));
+		offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(-71)));
+		offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(4)));
+		offset = _mm_or_si128(offset, _mm_and_si128(c62, _mm_set1_epi8(static_cast<char>(62 - alphabet[62]))));
+		offset = _mm_or_si128(offset, _mm_and_si128(c63, _mm_set1_epi8(static_cast<char>(63 - alphabet[63]))));
+		return _mm_add_epi8(value, offset);
+	}
+	__m128i DecodeReshuffle(__m128i sextets) noexcept
+	{
+		// Packs four 6-bit values into 24 bits of each dword and gathers the resulting 12 bytes at the front
+		const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+		return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	}
+
+	size_t DecodeSSSE3(const uint8_t* data, size_t size, uint8_t* buffer, const char* alphabet) noexcept
+	{
+		// Each step stores 16 bytes of which 12 are used, stop early enough for the store to stay inside the output
+		size_t consumed = 0;
+		for (; size - consumed >= 32; consumed += 16, buffer += 12)
+		{
+			bool isValid = false;
+			const __m128i sextets = DecodeTranslate(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + consumed)), alphabet, isValid);
+			if (!isValid)
+			{
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), DecodeReshuffle(sextets));
+		}
+		return consumed;
+	}
+	size_t DecodeAVX2(const uint8_t* data, size_t size, uint8_t* buffer, const char* alphabet) noexcept
+	{
+		auto InRange = [](__m256i value, char first, char last)
+		{
+			return _mm256_and_si256(_mm256_cmpgt_epi8(value, _mm256_set1_epi8(first - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(last + 1), value));
+		};
+		const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+		size_t consumed = 0;
+		for (; size - consumed >= 64; consumed += 32, buffer += 24)
+		{
+			const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + consumed));
+			const __m256i upper = InRange(value, 'A', 'Z');
+			const __m256i lower = InRange(value, 'a', 'z');
+			const __m256i digit = InRange(value, '0', '9');
+			const __m256i c62 = _mm256_cmpeq_epi8(value, _mm256_set1_epi8(alphabet[62]));
+			const __m256i c63 = _mm256_cmpeq_epi8(value, _mm256_set1_epi8(alphabet[63]));
+
+			const __m256i valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, c62)), c63);
+			if (static_cast<uint32_t>(_mm256_movemask_epi8(valid)) != 0xFFFFFFFFu)
+			{
+				break;
+			}
+
+			__m256i offset = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+			offset = _mm256_or_si256(offset, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+			offset = _mm256_or_si256(offset, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+			offset = _mm256_or_si256(offset, _mm256_and_si256(c62, _mm256_set1_epi8(static_cast<char>(62 - alphabet[62]))));
+			offset = _mm256_or_si256(offset, _mm256_and_si256(c63, _mm256_set1_epi8(static_cast<char>(63 - alphabet[63]))));
+			const __m256i sextets = _mm256_add_epi8(value, offset);
+
+			__m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+			merged = _mm256_shuffle_epi8(merged, shuffle);
+			merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), merged);
+		}
+		_mm256_zeroupper();
+
+		return consumed;
+	}
+	#endif
+
+	size_t EncodeBlocks(const uint8_t* data, size_t size, char* buffer, const char* alphabet) noexcept
+	{
+		size_t consumed = 0;
+
+		#if KXF_BASE64_X86
+		static const bool hasAVX2 = System::HasFeature(ProcessorFeature::AVX2);
+		static const bool hasSSSE3 = System::HasFeature(ProcessorFeature::SSSE3);
+		if (hasAVX2)
+		{
+			consumed += EncodeAVX2(data, size, buffer, alphabet);
+		}
+		if (hasSSSE3)
+		{
+			consumed += EncodeSSSE3(data + consumed, size - consumed, buffer + consumed / 3 * 4, alphabet);
+		}
+		#endif
+
+		for (; size - consumed >= 3; consumed += 3)
+		{
+			EncodeGroup(data + consumed, buffer + consumed / 3 * 4, alphabet);
+		}
+		return consumed;
+	}
+	size_t DecodeBlocks(const uint8_t* data, size_t size, uint8_t* buffer, bool isURLSafe) noexcept
+	{
+		const char* alphabet = isURLSafe ? g_AlphabetURL : g_Alphabet;
+		const auto& table = isURLSafe ? g_DecodeTableURL : g_DecodeTable;
+		size_t consumed = 0;
+
+		#if KXF_BASE64_X86
+		static const bool hasAVX2 = System::HasFeature(ProcessorFeature::AVX2);
+		static const bool hasSSSE3 = System::HasFeature(ProcessorFeature::SSSE3);
+		if (hasAVX2)
+		{
+			consumed += DecodeAVX2(data, size, buffer, alphabet);
+		}
+		if (hasSSSE3)
+		{
+			consumed += DecodeSSSE3(data + consumed, size - consumed, buffer + consumed / 4 * 3, alphabet);
+		}
+		#endif
+
+		// Stops at the first group containing anything but the alphabet characters, the caller deals with those
+		for (; size - consumed >= 4; consumed += 4)
+		{
+			const uint8_t* group = data + consumed;
+			const int32_t a = table[group[0]];
+			const int32_t b = table[group[1]];
+			const int32_t c = table[group[2]];
+			const int32_t d = table[group[3]];
+			if ((a|b|c|d) < 0)
+			{
+				break;
+			}
+
+			const uint32_t value = (uint32_t(a) << 18)|(uint32_t(b) << 12)|(uint32_t(c) << 6)|uint32_t(d);
+			uint8_t* output = buffer + consumed / 4 * 3;
+			output[0] = static_cast<uint8_t>(value >> 16);
+			output[1] = static_cast<uint8_t>(value >> 8);
+			output[2] = static_cast<uint8_t>(value);
+		}
+		return consumed;
+	}
+}
+
+namespace kxf::Crypto::Private
+{
+	size_t Base64Encoder::Update(const uint8_t* data, size_t size, char* buffer) noexcept
+	{
+		const char* alphabet = m_IsURLSafe ? g_AlphabetURL : g_Alphabet;
+		char* output = buffer;
+
+		if (m_CarrySize != 0)
+		{
+			while (m_CarrySize != std::size(m_Carry) && size != 0)
+			{
+				m_Carry[m_CarrySize++] = *data++;
+				size--;
+			}
+			if (size == 0)
+			{
+				return 0;
+			}
+
+			const uint8_t group[3] = {m_Carry[0], m_Carry[1], *data++};
+			size--;
+			m_CarrySize = 0;
+
+			EncodeGroup(group, output, alphabet);
+			output += 4;
+		}
+
+		const size_t consumed = EncodeBlocks(data, size, output, alphabet);
+		output += consumed / 3 * 4;
+
+		m_CarrySize = size - consumed;
+		std::memcpy(m_Carry, data + consumed, m_CarrySize);
+
+		return output - buffer;
+	}
+	size_t Base64Encoder::Finish(char* buffer) noexcept
+	{
+		const char* alphabet = m_IsURLSafe ? g_AlphabetURL : g_Alphabet;
+		if (m_CarrySize == 0)
+		{
+			return 0;
+		}
+
+		// Without padding the buffer only has room for the characters that carry data, don't write the whole group there
+		const uint8_t group[3] = {m_Carry[0], m_CarrySize > 1 ? m_Carry[1] : uint8_t(0), 0};
+		char encoded[4] = {};
+		EncodeGroup(group, encoded, alphabet);
+
+		size_t length = m_CarrySize + 1;
+		if (m_IsPadded)
+		{
+			for (; length != 4; length++)
+			{
+				encoded[length] = '=';
+			}
+		}
+		std::memcpy(buffer, encoded, length);
+		m_CarrySize = 0;
+
+		return length;
+	}
+}
+
+namespace kxf::Crypto::Private
+{
+	size_t Base64Decoder::FlushGroup(uint8_t* buffer) noexcept
+	{
+		const uint32_t value = (uint32_t(m_Group[0]) << 18)|(uint32_t(m_Group[1]) << 12)|(uint32_t(m_Group[2]) << 6)|uint32_t(m_Group[3]);
+		const size_t count = m_GroupSize - 1;
+
+		buffer[0] = static_cast<uint8_t>(value >> 16);
+		if (count > 1)
+		{
+			buffer[1] = static_cast<uint8_t>(value >> 8);
+		}
+		if (count > 2)
+		{
+			buffer[2] = static_cast<uint8_t>(value);
+		}
+
+		std::memset(m_Group, 0, sizeof(m_Group));
+		m_GroupSize = 0;
+		return count;
+	}
+	void Base64Decoder::Reset() noexcept
+	{
+		std::memset(m_Group, 0, sizeof(m_Group));
+		m_GroupSize = 0;
+		m_PaddingSize = 0;
+		m_IsEnded = false;
+	}
+
+	std::optional<size_t> Base64Decoder::Update(const char* data, size_t size, uint8_t* buffer) noexcept
+	{
+		const auto& table = m_IsURLSafe ? g_DecodeTableURL : g_DecodeTable;
+		auto it = reinterpret_cast<const uint8_t*>(data);
+		auto end = it + size;
+		uint8_t* output = buffer;
+
+		while (it != end)
+		{
+			if (m_GroupSize == 0 && m_PaddingSize == 0)
+			{
+				const size_t consumed = DecodeBlocks(it, end - it, output, m_IsURLSafe);
+				it += consumed;
+				output += consumed / 4 * 3;
+
+				if (it == end)
+				{
+					break;
+				}
+			}
+
+			// Slow path for whatever the block decoder couldn't handle
+			const uint8_t c = *it++;
+			if (IsWhitespace(c))
+			{
+				if (!m_SkipWhitespace)
+				{
+					Reset();
+					return {};
+				}
+			}
+			else if (c == '=')
+			{
+				if (m_IsEnded || m_GroupSize < 2)
+				{
+					Reset();
+					return {};
+				}
+				else if (m_GroupSize + ++m_PaddingSize == 4)
+				{
+					// Mark the group as ended but keep the padding size non-zero so the data after it is rejected
+					output += FlushGroup(output);
+					m_IsEnded = true;
+				}
+			}
+			else if (const int8_t value = table[c]; value >= 0 && m_PaddingSize == 0)
+			{
+				m_Group[m_GroupSize++] = static_cast<uint8_t>(value);
+				if (m_GroupSize == 4)
+				{
+					output += FlushGroup(output);
+				}
+			}
+			else
+			{
+				Reset();
+				return {};
+			}
+		}
+		return output - buffer;
+	}
+	std::optional<size_t> Base64Decoder::Finish(uint8_t* buffer) noexcept
+	{
+		// Missing padding is fine but a single character can't encode a whole byte
+		if (m_GroupSize == 1)
+		{
+			Reset();
+			return {};
+		}
+
+		const size_t count = m_GroupSize != 0 ? FlushGroup(buffer) : 0;
+		Reset();
+		return count;
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "../Crypto.h"
+
+namespace kxf::Crypto::Private
+{
+	// Incremental Base64 encoder, bytes which don't form a complete group are carried over to the next call
+	class Base64Encoder final
+	{
+		public:
+			// Output buffer size required by 'Update' for the given input size, 'Finish' needs 4 characters at most
+			static constexpr size_t GetMaxOutputSize(size_t size) noexcept
+			{
+				return (size + 2) / 3 * 4;
+			}
+
+		private:
+			bool m_IsURLSafe = false;
+			bool m_IsPadded = true;
+
+			uint8_t m_Carry[2] = {};
+			size_t m_CarrySize = 0;
+
+		public:
+			Base64Encoder(FlagSet<Base64Flag> flags = {}) noexcept
+				:m_IsURLSafe(flags.Contains(Base64Flag::URLSafe)), m_IsPadded(!flags.Contains(Base64Flag::NoPadding))
+			{
+			}
+
+		public:
+			size_t Update(const uint8_t* data, size_t size, char* buffer) noexcept;
+			size_t Finish(char* buffer) noexcept;
+	};
+
+	// Incremental Base64 decoder. Padding is optional, whitespace is only accepted with 'Base64Flag::SkipWhitespace'.
+	class Base64Decoder final
+	{
+		public:
+			// Output buffer size required by 'Update' for the given input size, 'Finish' needs 2 bytes at most
+			static constexpr size_t GetMaxOutputSize(size_t size) noexcept
+			{
+				return (size + 3) / 4 * 3;
+			}
+
+		private:
+			bool m_IsURLSafe = false;
+			bool m_SkipWhitespace = false;
+
+			uint8_t m_Group[4] = {};
+			size_t m_GroupSize = 0;
+			size_t m_PaddingSize = 0;
+			bool m_IsEnded = false;
+
+		private:
+			size_t FlushGroup(uint8_t* buffer) noexcept;
+			void Reset() noexcept;
+
+		public:
+			Base64Decoder(FlagSet<Base64Flag> flags = {}) noexcept
+				:m_IsURLSafe(flags.Contains(Base64Flag::URLSafe)), m_SkipWhitespace(flags.Contains(Base64Flag::SkipWhitespace))
+			{
+			}
+
+		public:
+			// Both return the number of bytes written or nothing if the input isn't valid Base64
+			std::optional<size_t> Update(const char* data, size_t size, uint8_t* buffer) noexcept;
+			std::optional<size_t> Finish(uint8_t* buffer) noexcept;
+	};
+}
@@ -0,0 +1,228 @@
+#include "KxfPCH.h"
+#include "CRC32.h"
+#include "kxf/System/SystemInformation.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#define KXF_CRC32_X86 1
+#endif
+
+namespace
+{
+	using namespace kxf;
+	using CRCTables = std::array<std::array<uint32_t, 256>, 16>;
+	using TUpdateFunc = uint32_t(*)(uint32_t crc, const uint8_t* data, size_t size) noexcept;
+
+	// Table 'k' gives the CRC of a byte followed by 'k' zero bytes which lets slicing process 16 bytes per step
+	template<uint32_t polynomial>
+	constexpr CRCTables MakeCRCTables() noexcept
+	{
+		CRCTables tables = {};
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t value = i;
+			for (size_t j = 0; j < 8; j++)
+			{
+				value = (value >> 1) ^ (polynomial & (0u - (value & 1u)));
+			}
+			tables[0][i] = value;
+		}
+		for (size_t k = 1; k < tables.size(); k++)
+		{
+			for (size_t i = 0; i < 256; i++)
+			{
+				tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFFu];
+			}
+		}
+		return tables;
+	}
+
+	constexpr CRCTables g_CRC32Tables = MakeCRCTables<0xEDB88320u>();
+	constexpr CRCTables g_CRC32CTables = MakeCRCTables<0x82F63B78u>();
+	static_assert(g_CRC32Tables[0][1] == 0x77073096u && g_CRC32Tables[0][255] == 0x2D02EF8Du);
+	static_assert(g_CRC32CTables[0][1] == 0xF26B8303u && g_CRC32CTables[0][255] == 0xAD7D5351u);
+
+	uint32_t Load32(const uint8_t* data) noexcept
+	{
+		uint32_t value = 0;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	template<const CRCTables& t_Tables>
+	uint32_t UpdateSlicingBy16(uint32_t crc, const uint8_t* data, size_t size) noexcept
+	{
+		const auto& t = t_Tables;
+		for (; size >= 16; data += 16, size -= 16)
+		{
+			const uint32_t a = Load32(data) ^ crc;
+			const uint32_t b = Load32(data + 4);
+			const uint32_t c = Load32(data + 8);
+			const uint32_t d = Load32(data + 12);
+
+			crc = t[15][a & 0xFFu] ^ t[14][(a >> 8) & 0xFFu] ^ t[13][(a >> 16) & 0xFFu] ^ t[12][a >> 24] ^
+				t[11][b & 0xFFu] ^ t[10][(b >> 8) & 0xFFu] ^ t[9][(b >> 16) & 0xFFu] ^ t[8][b >> 24] ^
+				t[7][c & 0xFFu] ^ t[6][(c >> 8) & 0xFFu] ^ t[5][(c >> 16) & 0xFFu] ^ t[4][c >> 24] ^
+				t[3][d & 0xFFu] ^ t[2][(d >> 8) & 0xFFu] ^ t[1][(d >> 16) & 0xFFu] ^ t[0][d >> 24];
+		}
+		for (; size != 0; data++, size--)
+		{
+			crc = t[0][(crc ^ *data) & 0xFFu] ^ (crc >> 8);
+		}
+		return crc;
+	}
+
+	#if KXF_CRC32_X86
+	// Folds 64-byte blocks with carry-less multiplication and reduces the result with Barrett reduction.
+	// See "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" by Intel, the constants
+	// are for the bit-reflected CRC32 polynomial. Requires 'size' >= 64 and a multiple of 16.
+	uint32_t FoldCRC32(uint32_t crc, const uint8_t* data, size_t size) noexcept
+	{
+		alignas(16) static constexpr uint64_t k1k2[] = {0x0154442BD4u, 0x01C6E41596u};
+		alignas(16) static constexpr uint64_t k3k4[] = {0x01751997D0u, 0x00CCAA009Eu};
+		alignas(16) static constexpr uint64_t k5k0[] = {0x0163CD6124u, 0x0000000000u};
+		alignas(16) static constexpr uint64_t poly[] = {0x01DB710641u, 0x01F7011641u};
+
+		auto Load = [](const uint8_t* data)
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+		};
+		auto Fold = [](__m128i value, __m128i next, __m128i k)
+		{
+			const __m128i low = _mm_clmulepi64_si128(value, k, 0x00);
+			const __m128i high = _mm_clmulepi64_si128(value, k, 0x11);
+			return _mm_xor_si128(_mm_xor_si128(high, low), next);
+		};
+
+		__m128i x1 = _mm_xor_si128(Load(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+		__m128i x2 = Load(data + 16);
+		__m128i x3 = Load(data + 32);
+		__m128i x4 = Load(data + 48);
+		data += 64;
+		size -= 64;
+
+		// Four independent folds in parallel to hide the multiplication latency
+		__m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+		for (; size >= 64; data += 64, size -= 64)
+		{
+			x1 = Fold(x1, Load(data), k);
+			x2 = Fold(x2, Load(data + 16), k);
+			x3 = Fold(x3, Load(data + 32), k);
+			x4 = Fold(x4, Load(data + 48), k);
+		}
+
+		k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+		x1 = Fold(x1, x2, k);
+		x1 = Fold(x1, x3, k);
+		x1 = Fold(x1, x4, k);
+		for (; size >= 16; data += 16, size -= 16)
+		{
+			x1 = Fold(x1, Load(data), k);
+		}
+
+		// 128 to 64 bits
+		const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+		__m128i x0 = _mm_clmulepi64_si128(x1, k, 0x10);
+		x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x0);
+
+		k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+		x0 = _mm_srli_si128(x1, 4);
+		x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+		x1 = _mm_xor_si128(x1, x0);
+
+		// Barrett reduction to 32 bits
+		k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+		x0 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+		x0 = _mm_clmulepi64_si128(_mm_and_si128(x0, mask32), k, 0x00);
+		x1 = _mm_xor_si128(x1, x0);
+
+		return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+	}
+	uint32_t UpdateCRC32_CLMUL(uint32_t crc, const uint8_t* data, size_t size) noexcept
+	{
+		if (size >= 64)
+		{
+			const size_t foldSize = size & ~size_t(15);
+			crc = FoldCRC32(crc, data, foldSize);
+			data += foldSize;
+			size -= foldSize;
+		}
+		return UpdateSlicingBy16<g_CRC32Tables>(crc, data, size);
+	}
+
+	uint32_t UpdateCRC32C_SSE42(uint32_t crc, const uint8_t* data, size_t size) noexcept
+	{
+		for (; size != 0 && reinterpret_cast<uintptr_t>(data) % 8 != 0; data++, size--)
+		{
+			crc = _mm_crc32_u8(crc, *data);
+		}
+
+		#if defined(_M_X64)
+		uint64_t crc64 = crc;
+		for (; size >= 32; data += 32, size -= 32)
+		{
+			uint64_t value[4];
+			std::memcpy(value, data, sizeof(value));
+
+			crc64 = _mm_crc32_u64(crc64, value[0]);
+			crc64 = _mm_crc32_u64(crc64, value[1]);
+			crc64 = _mm_crc32_u64(crc64, value[2]);
+			crc64 = _mm_crc32_u64(crc64, value[3]);
+		}
+		for (; size >= 8; data += 8, size -= 8)
+		{
+			uint64_t value = 0;
+			std::memcpy(&value, data, sizeof(value));
+			crc64 = _mm_crc32_u64(crc64, value);
+		}
+		crc = static_cast<uint32_t>(crc64);
+		#else
+		for (; size >= 4; data += 4, size -= 4)
+		{
+			crc = _mm_crc32_u32(crc, Load32(data));
+		}
+		#endif
+
+		for (; size != 0; data++, size--)
+		{
+			crc = _mm_crc32_u8(crc, *data);
+		}
+		return crc;
+	}
+	#endif
+
+	TUpdateFunc SelectCRC32() noexcept
+	{
+		#if KXF_CRC32_X86
+		if (System::HasFeature(ProcessorFeature::PCLMULQDQ) && System::HasFeature(ProcessorFeature::SSE4_1))
+		{
+			return UpdateCRC32_CLMUL;
+		}
+		#endif
+		return UpdateSlicingBy16<g_CRC32Tables>;
+	}
+	TUpdateFunc SelectCRC32C() noexcept
+	{
+		#if KXF_CRC32_X86
+		if (System::HasFeature(ProcessorFeature::SSE4_2))
+		{
+			return UpdateCRC32C_SSE42;
+		}
+		#endif
+		return UpdateSlicingBy16<g_CRC32CTables>;
+	}
+}
+
+namespace kxf::Crypto::Private
+{
+	uint32_t UpdateCRC32(uint32_t crc, const void* data, size_t size) noexcept
+	{
+		static const TUpdateFunc func = SelectCRC32();
+		return func(crc, static_cast<const uint8_t*>(data), size);
+	}
+	uint32_t UpdateCRC32C(uint32_t crc, const void* data, size_t size) noexcept
+	{
+		static const TUpdateFunc func = SelectCRC32C();
+		return func(crc, static_cast<const uint8_t*>(data), size);
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "../Common.h"
+
+namespace kxf::Crypto::Private
+{
+	// Both functions take and return the raw CRC register (not inverted), the fastest kernel supported
+	// by the processor is selected on the first call.
+	uint32_t UpdateCRC32(uint32_t crc, const void* data, size_t size) noexcept;
+	uint32_t UpdateCRC32C(uint32_t crc, const void* data, size_t size) noexcept;
+}
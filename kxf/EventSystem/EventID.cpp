@@ -8,6 +8,24 @@ namespace
 	std::atomic<int64_t> g_SimpleEventID = 0;
 }
 
+namespace kxf::EventSystem::Private
+{
+	StringEventID::StringEventID(String id) noexcept
+		:m_Atom(Atom::Find(id.view()))
+	{
+		// Only look up the table, interning arbitrary strings (deserialized ones in particular) would grow it without bound
+		if (m_Atom)
+		{
+			m_Hash = m_Atom.GetHash();
+		}
+		else if (!id.IsEmpty())
+		{
+			m_Hash = std::hash<String>()(id);
+			m_Value = std::move(id);
+		}
+	}
+}
+
 namespace kxf
 {
 	size_t EventID::GetHash() const noexcept
@@ -26,12 +44,9 @@ namespace kxf
 				return std::hash<UniversallyUniqueID>()(*value);
 			}
 		}
-		else if (auto value = std::get_if<String>(&m_ID))
+		else if (auto value = std::get_if<EventSystem::Private::StringEventID>(&m_ID))
 		{
-			if (!value->IsEmpty())
-			{
-				return std::hash<String>()(*value);
-			}
+			return value->GetHash();
 		}
 		return 0;
 	}
@@ -55,10 +70,10 @@ namespace kxf
 			written += WriteIndex();
 			written += Serialization::WriteObject(stream, *value);
 		}
-		else if (auto value = std::get_if<String>(&m_ID))
+		else if (auto value = std::get_if<EventSystem::Private::StringEventID>(&m_ID))
 		{
 			written += WriteIndex();
-			written += Serialization::WriteObject(stream, *value);
+			written += Serialization::WriteObject(stream, value->GetString());
 		}
 		else
 		{
@@ -97,7 +112,7 @@ namespace kxf
 			{
 				String value;
 				read += Serialization::ReadObject(stream, value);
-				m_ID = std::move(value);
+				m_ID = EventSystem::Private::StringEventID(std::move(value));
 
 				break;
 			}
@@ -123,9 +138,9 @@ namespace kxf
 		{
 			return value->IsNull();
 		}
-		else if (auto value = std::get_if<String>(&m_ID))
+		else if (auto value = std::get_if<EventSystem::Private::StringEventID>(&m_ID))
 		{
-			return value->IsEmpty();
+			return value->IsNull();
 		}
 		return false;
 	}
@@ -148,12 +163,20 @@ namespace kxf
 	}
 	const String& EventID::AsString() const noexcept
 	{
-		if (auto value = std::get_if<String>(&m_ID))
+		if (auto value = std::get_if<EventSystem::Private::StringEventID>(&m_ID))
 		{
-			return *value;
+			return value->GetString();
 		}
 		return NullString;
 	}
+	Atom EventID::AsAtom() const noexcept
+	{
+		if (auto value = std::get_if<EventSystem::Private::StringEventID>(&m_ID))
+		{
+			return value->GetAtom();
+		}
+		return {};
+	}
 
 	#ifdef __WXWINDOWS__
 	bool EventID::IsWxWidgetsID() const noexcept
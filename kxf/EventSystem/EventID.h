@@ -1,6 +1,7 @@
 #pragma once
 #include "Common.h"
 #include "kxf/Core/String.h"
+#include "kxf/Core/Atom.h"
 #include "kxf/Core/UniversallyUniqueID.h"
 #include "kxf/Serialization/BinarySerializer.h"
 #include "kxf/Utility/Memory.h"
@@ -12,6 +13,62 @@ namespace kxf
 	class IEvent;
 }
 
+namespace kxf::EventSystem::Private
+{
+	// IDs made from an 'Atom' are registered ones and compare by pointer. Any other string keeps its own copy
+	// (unless it's already interned) along with the hash, so unequal IDs are rejected without comparing characters.
+	class KX_API StringEventID final
+	{
+		private:
+			Atom m_Atom;
+			String m_Value;
+			size_t m_Hash = 0;
+
+		public:
+			StringEventID(Atom id) noexcept
+				:m_Atom(std::move(id)), m_Hash(m_Atom.GetHash())
+			{
+			}
+			StringEventID(String id) noexcept;
+
+		public:
+			bool IsNull() const noexcept
+			{
+				return m_Atom.IsNull() && m_Value.IsEmpty();
+			}
+			const String& GetString() const noexcept
+			{
+				return m_Atom ? m_Atom.GetString() : m_Value;
+			}
+			Atom GetAtom() const noexcept
+			{
+				return m_Atom;
+			}
+			size_t GetHash() const noexcept
+			{
+				return m_Hash;
+			}
+
+		public:
+			std::strong_ordering operator<=>(const StringEventID& other) const noexcept
+			{
+				if (m_Atom && other.m_Atom)
+				{
+					return m_Atom <=> other.m_Atom;
+				}
+				return GetString().view() <=> other.GetString().view();
+			}
+			bool operator==(const StringEventID& other) const noexcept
+			{
+				if (m_Atom && other.m_Atom)
+				{
+					return m_Atom == other.m_Atom;
+				}
+				return m_Hash == other.m_Hash && GetString() == other.GetString();
+			}
+	};
+}
+
 namespace kxf
 {
 	class KX_API EventID final
@@ -20,7 +77,7 @@ namespace kxf
 		friend struct BinarySerializer<EventID>;
 
 		private:
-			std::variant<int64_t, UniversallyUniqueID, String> m_ID;
+			std::variant<int64_t, UniversallyUniqueID, EventSystem::Private::StringEventID> m_ID;
 			const std::type_info* m_TypeInfo = nullptr;
 
 		private:
@@ -60,17 +117,21 @@ namespace kxf
 			{
 			}
 			
-			// String
+			// String, pass an 'Atom' for registered IDs to make comparing them trivial
+			EventID(Atom id) noexcept
+				:m_ID(EventSystem::Private::StringEventID(std::move(id)))
+			{
+			}
 			EventID(String id) noexcept
-				:m_ID(std::move(id))
+				:m_ID(EventSystem::Private::StringEventID(std::move(id)))
 			{
 			}
 			EventID(const char* id) noexcept
-				:m_ID(String(id))
+				:m_ID(EventSystem::Private::StringEventID(String(id)))
 			{
 			}
 			EventID(const wchar_t* id) noexcept
-				:m_ID(String(id))
+				:m_ID(EventSystem::Private::StringEventID(String(id)))
 			{
 			}
 			
@@ -95,6 +156,7 @@ namespace kxf
 			int64_t AsInt() const noexcept;
 			UniversallyUniqueID AsUniqueID() const noexcept;
 			const String& AsString() const noexcept;
+			Atom AsAtom() const noexcept;
 
 			bool HasEventClassInfo() const noexcept
 			{
@@ -10,37 +10,16 @@ namespace
 {
 	using namespace kxf;
 
-	template<class TEventTable, class TFunc>
-	size_t SearchForBoundHandlers(TEventTable&& eventTable, const EventID& eventID, IEventExecutor& executor, TFunc&& onFound)
+	bool IsBoundHandlerMatching(const EventSystem::EventItem& item, const EventID& eventID, IEventExecutor& executor)
 	{
-		const EventSystem::EventItem dummyItem(eventID, executor);
-		const IEventExecutor& nullExecutor = EventSystem::NullEventExecutor::Get();
-
-		size_t count = 0;
-		for (auto it = std::rbegin(eventTable); it != std::rend(eventTable); ++it)
-		{
-			// 1) If 'eventID' is 'IEvent::EvtAny' unbind *all* events.
-			// 2) If 'eventID' matches our item ID and the supplied executor is a special null executor unbind all events with this ID.
-			// 3) Unbind the event if both event ID and the executor matches (See 'EventItem::IsSameAs' for details).
-			if ((eventID == IEvent::EvtAny) || (eventID == it->GetEventID() && &executor == &nullExecutor) || (it->IsSameAs(dummyItem)))
-			{
-				count++;
-				if (!std::invoke(onFound, it))
-				{
-					break;
-				}
-			}
-		}
-		return count;
-	}
-
-	template<class TEventTable>
-	size_t CountBoundHandlers(TEventTable&& eventTable, const EventID& eventID, IEventExecutor& executor)
-	{
-		return SearchForBoundHandlers(std::forward<TEventTable>(eventTable), eventID, executor, [](auto&&)
+		// 1) If 'eventID' is 'IEvent::EvtAny' match *all* events.
+		// 2) If 'eventID' matches our item ID and the supplied executor is a special null executor match all events with this ID.
+		// 3) Match the event if both event ID and the executor matches (See 'EventItem::IsSameAs' for details).
+		if (eventID == IEvent::EvtAny || (item.IsSameEventID(eventID) && &executor == &EventSystem::NullEventExecutor::Get()))
 		{
 			return true;
-		});
+		}
+		return item.IsSameAs(EventSystem::EventItem(eventID, executor));
 	}
 
 	bool IsInvalidFlagCombination(FlagSet<BindEventFlag> flags) noexcept
@@ -71,7 +50,6 @@ namespace kxf
 			Destroy();
 		}
 
-		m_EventTable = std::move(other.m_EventTable);
 		{
 			WriteLockGuard lockThis(m_EventTableLock);
 			WriteLockGuard lockOther(other.m_EventTableLock);
@@ -98,7 +76,7 @@ namespace kxf
 		DiscardPendingEvents();
 
 		WriteLockGuard lockGuard(m_EventTableLock);
-		m_EventTable.clear();
+		m_EventTable.Clear();
 	}
 
 	void EvtHandler::PrepareEvent(IEvent& event, const EventID& eventID, const UniversallyUniqueID& uuid, FlagSet<ProcessEventFlag> flags, bool isAsync)
@@ -211,122 +189,85 @@ namespace kxf
 	bool EvtHandler::SearchEventTable(IEvent& event)
 	{
 		bool executed = false;
-		size_t initialSize = 0;
-		size_t nullCount = 0;
+		bool requeued = false;
+		bool needsPurge = false;
 		LocallyUniqueID eventSlot;
 
-		if (ReadLockGuard lockGuard(m_EventTableLock); !m_EventTable.empty())
+		if (ReadLockGuard lockGuard(m_EventTableLock); !m_EventTable.IsEmpty())
 		{
-			initialSize = m_EventTable.size();
-
-			const EventID eventID = event.GetEventID();
-			for (auto it = m_EventTable.rbegin(); it != m_EventTable.rend(); ++it)
+			m_EventTable.ForEachBound(event.GetEventID(), [&](EventItem& eventItem)
 			{
-				EventItem& eventItem = *it;
-				if (eventItem.IsNull())
+				IEvtHandler* evtHandler = eventItem.GetExecutor()->GetTargetHandler();
+				if (!evtHandler)
 				{
-					// This item must have been unbound at some time in the past, so skip it now
-					// and really remove it from the event table, once we finish iterating.
-					nullCount++;
-					continue;
+					evtHandler = this;
 				}
 
-				if (eventItem.IsSameEventID(eventID))
+				// If the handler wants to be executed on the main thread, queue it, mark as queued (done in 'WasReQueued') and return.
+				const auto eventFlags = eventItem.GetFlags();
+				const bool isMainThread = wxThread::IsMain();
+				if (ShouldQueueeEvent(eventFlags, isMainThread))
 				{
-					IEvtHandler* evtHandler = eventItem.GetExecutor()->GetTargetHandler();
-					if (!evtHandler)
+					auto eventInternal = event.QueryInterface<IEventInternal>();
+					if (!eventInternal->WasReQueued() && !eventInternal->IsAsync())
 					{
-						evtHandler = this;
-					}
+						if (eventFlags.Contains(BindEventFlag::Blocking))
+						{
+							wxASSERT_MSG(!isMainThread, "Option 'BindEventFlag::Blocking' should not ever be used from main thread");
 
-					// If the handler wants to be executed on the main thread, queue it, mark as queued (done in 'WasReQueued') and return.
-					const auto eventFlags = eventItem.GetFlags();
-					const bool isMainThread = wxThread::IsMain();
-					if (ShouldQueueeEvent(eventFlags, isMainThread))
-					{
-						auto eventInternal = event.QueryInterface<IEventInternal>();
-						if (!eventInternal->WasReQueued() && !eventInternal->IsAsync())
+							// TODO: Do we need some kind of lock to ensure that our moved event won't get processed until after we call 'WaitProcessed' on it?
+							auto movedEvent = event.Move();
+							auto movedEventRef = movedEvent->QueryInterface<IEventInternal>();
+							DoQueueEvent(std::move(movedEvent));
+
+							// We need to leave the guard here so the main thread can enter this function. We're going to return right after anyway.
+							lockGuard.Unlock();
+							eventInternal->PutWaitResult(movedEventRef->WaitProcessed());
+						}
+						else
 						{
-							if (eventFlags.Contains(BindEventFlag::Blocking))
-							{
-								wxASSERT_MSG(!isMainThread, "Option 'BindEventFlag::Blocking' should not ever be used from main thread");
-
-								// TODO: Do we need some kind of lock to ensure that our moved event won't get processed until after we call 'WaitProcessed' on it?
-								auto movedEvent = event.Move();
-								auto movedEventRef = movedEvent->QueryInterface<IEventInternal>();
-								DoQueueEvent(std::move(movedEvent));
-
-								// We need to leave the guard here so the main thread can enter this function. We're going to return right after anyway.
-								lockGuard.Unlock();
-								eventInternal->PutWaitResult(movedEventRef->WaitProcessed());
-							}
-							else
-							{
-								DoQueueEvent(event.Move());
-							}
-
-							// Stop execution of this event here, it'll be restarted from the beginning in 'ProcessPendingEvents'.
-							return true;
+							DoQueueEvent(event.Move());
 						}
+
+						// Stop execution of this event here, it'll be restarted from the beginning in 'ProcessPendingEvents'.
+						requeued = true;
+						return false;
 					}
+				}
 
-					// Call the handler
-					if (ExecuteEventHandler(event, eventItem, *evtHandler))
+				// Call the handler
+				if (ExecuteEventHandler(event, eventItem, *evtHandler))
+				{
+					// If this is a one-shot event store its bind slot to unbind later
+					if (eventItem.GetFlags().Contains(BindEventFlag::OneShot))
 					{
-						// If this is a one-shot event store its bind slot to unbind later
-						const auto flags = eventItem.GetFlags();
-						if (flags.Contains(BindEventFlag::OneShot))
-						{
-							eventSlot = eventItem.GetBindSlot();
-						}
-
-						// It's important to skip clearing of the unbound event entries
-						// below because this object itself could have been deleted by
-						// the event handler making 'm_EventTable' a dangling pointer
-						// which can't be accessed any longer in the code below.
-						//
-						// In practice, it hopefully shouldn't be a problem to wait
-						// until we get an event that we don't handle before clearing
-						// because this should happen soon enough and even if it
-						// doesn't the worst possible outcome is slightly increased
-						// memory consumption while not skipping clearing can result in
-						// hard to reproduce crashes (because it requires the disconnection
-						// and deletion happen at the same time which is not always the case).
-						//
-						// Actually a user should use 'ICoreApplication::ScheduleForDestruction'
-						// to destroy 'IEvtHandler' objects instead of just calling 'delete this'.
-						// So assume we can never end up in a situation described above.
-						executed = true;
-						break;
+						eventSlot = eventItem.GetBindSlot();
 					}
+
+					// Actually a user should use 'ICoreApplication::ScheduleForDestruction'
+					// to destroy 'IEvtHandler' objects instead of just calling 'delete this'.
+					// So assume we can never end up in a situation where this object
+					// has been deleted by the event handler we've just called.
+					executed = true;
+					return false;
 				}
+				return true;
+			});
+
+			if (requeued)
+			{
+				return true;
 			}
+			needsPurge = m_EventTable.NeedsPurge();
 		}
 
-		if (nullCount != 0 || eventSlot)
+		if (eventSlot || needsPurge)
 		{
 			WriteLockGuard lockGuard(m_EventTableLock);
-			
-			// Unbind event if needed
-			if (DoUnbind(eventSlot))
-			{
-				nullCount++;
-			}
 
-			// Purge the event table
-			if (nullCount != 0)
-			{
-				Utility::Container::RemoveEachIf(m_EventTable, [](const EventItem& item)
-				{
-					return item.IsNull();
-				});
-
-				// Shrink vector only if we have deleted enough items to justify reallocation
-				if (initialSize / 2 >= nullCount)
-				{
-					m_EventTable.shrink_to_fit();
-				}
-			}
+			// Unbind event if needed and destroy the items which were unbound while we were iterating the table
+			DoUnbind(eventSlot);
+			m_EventTable.Purge();
 		}
 		return executed;
 	}
@@ -429,38 +370,15 @@ namespace kxf
 		{
 			PrepareEvent(*event, eventID, uuid, flags, true);
 
-			if (WriteLockGuard lock(m_PendingEventsLock); true)
+			// Add this event to our list of pending events. If it has a unique ID it replaces the pending event with the same ID.
+			if (m_PendingEvents.Push(std::move(event), uuid))
 			{
-				// Add this event to our list of pending events
-				if (uuid)
-				{
-					// If this event has a unique ID, search for the last posted event with the same ID and,
-					// if it'll be found, replace it with our new event, otherwise just add it at the end as usual.
-					auto it = std::find_if(m_PendingEvents.rbegin(), m_PendingEvents.rend(), [&](const auto& item)
-					{
-						return item->GetUniqueID() == uuid;
-					});
-					if (it != m_PendingEvents.rend())
-					{
-						*it = std::move(event);
-					}
-					else
-					{
-						m_PendingEvents.emplace_back(std::move(event));
-					}
-				}
-				else
-				{
-					m_PendingEvents.emplace_back(std::move(event));
-				}
-
-				// Add this event handler to the list of event handlers that have pending events
+				// Add this event handler to the list of event handlers that have pending events. We only need to do that
+				// when the queue becomes non-empty, 'ProcessPendingEvents' removes us from that list once it's drained.
+				// The lock makes sure the removal and this call don't interleave, so the handler is always in the list
+				// when it has any pending events to process.
+				WriteLockGuard lock(m_PendingEventsLock);
 				app->AddPendingEventHandler(*this);
-
-				// Only release 'm_PendingEventsLock' now because otherwise there is a race condition: we could process
-				// the event just added to 'm_PendingEvents' in our 'ProcessPendingEvents' before we had time to append
-				// this pointer to application's list; thus breaking the invariant that a handler should be in the list
-				// if and only if it has any pending events to process.
 			}
 
 			// Inform the system that new pending events are somewhere, and that these should be processed in idle time.
@@ -621,7 +539,10 @@ namespace kxf
 				WriteLockGuard lock(m_EventTableLock);
 
 				// If 'BindEventFlag::Unique' is present, refuse to bind this handler if the same handler is already bound.
-				if (flags.Contains(BindEventFlag::Unique) && CountBoundHandlers(m_EventTable, eventID, *eventItem.GetExecutor()) != 0)
+				if (flags.Contains(BindEventFlag::Unique) && m_EventTable.CountIf(eventID, [&](const EventItem& item)
+				{
+					return IsBoundHandlerMatching(item, eventID, *eventItem.GetExecutor());
+				}) != 0)
 				{
 					return {};
 				}
@@ -634,7 +555,9 @@ namespace kxf
 				}
 
 				m_EventBindSlot = nextBindSlot;
-				m_EventTable.emplace_back(std::move(eventItem)).SetBindSlot(nextBindSlot);
+				eventItem.SetBindSlot(nextBindSlot);
+				m_EventTable.Add(std::move(eventItem));
+
 				return nextBindSlot;
 			}
 		}
@@ -644,27 +567,24 @@ namespace kxf
 	{
 		if (eventID)
 		{
-			if (WriteLockGuard lock(m_EventTableLock); !m_EventTable.empty())
+			if (WriteLockGuard lock(m_EventTableLock); !m_EventTable.IsEmpty())
 			{
-				size_t unbindCount = 0;
-				SearchForBoundHandlers(m_EventTable, eventID, executor, [&](auto&& itemIt)
+				// Items are removed from the table right away, the table itself keeps them alive
+				// if they're being executed right now (when unbinding from inside an event handler).
+				auto OnFound = [&](EventItem& item)
 				{
-					// Clear the handler if derived class allows that
-					if (OnDynamicUnbind(*itemIt))
+					// Remove the handler if derived class allows that
+					if (IsBoundHandlerMatching(item, eventID, executor) && OnDynamicUnbind(item))
 					{
-						// We can't delete the entry from the vector if we're currently iterating over it.
-						// As we don't know whether we're or not, just null it for now and we will really
-						// erase it when we do finish iterating over it the next time.
-						FreeBindSlot(itemIt->GetBindSlot());
-						*itemIt = {};
-
-						unbindCount++;
+						FreeBindSlot(item.GetBindSlot());
+						return true;
 					}
-					return true;
-				});
+					return false;
+				};
+				const size_t unbindCount = eventID == IEvent::EvtAny ? m_EventTable.RemoveIf(OnFound) : m_EventTable.RemoveIf(eventID, OnFound);
 
 				// If we were asked to unbind all items (or we've deleted them all) we can free all bind slots as well
-				if (eventID == IEvent::EvtAny || unbindCount == m_EventTable.size())
+				if (eventID == IEvent::EvtAny || m_EventTable.IsEmpty())
 				{
 					FreeAllBindSlots();
 				}
@@ -677,29 +597,19 @@ namespace kxf
 	{
 		if (bindSlot)
 		{
-			if (WriteLockGuard lock(m_EventTableLock); !m_EventTable.empty())
+			if (WriteLockGuard lock(m_EventTableLock); !m_EventTable.IsEmpty())
 			{
-				size_t unbindCount = 0;
-				auto it = std::find_if(m_EventTable.rbegin(), m_EventTable.rend(), [&](const EventItem& item)
-				{
-					return item.GetBindSlot() == bindSlot;
-				});
-				if (it != m_EventTable.rend() && OnDynamicUnbind(*it))
+				if (EventItem* item = m_EventTable.Find(bindSlot); item && OnDynamicUnbind(*item))
 				{
-					// See the comment in the 'DoUnbind(EventID, IEventExecutor&)' overload above for why
-					// we just null the event item and not erase it.
 					FreeBindSlot(bindSlot);
-					*it = {};
+					m_EventTable.Remove(bindSlot);
 
-					unbindCount++;
+					if (m_EventTable.IsEmpty())
+					{
+						FreeAllBindSlots();
+					}
 					return true;
 				}
-
-				if (unbindCount == m_EventTable.size())
-				{
-					FreeAllBindSlots();
-				}
-				return unbindCount != 0;
 			}
 		}
 		return false;
@@ -715,48 +625,44 @@ namespace kxf
 			std::unique_ptr<IEvent> pendingEvent;
 
 			// This method is only called by an application if this handler does have pending events
-			if (WriteLockGuard lock(m_PendingEventsLock); !m_PendingEvents.empty())
+			if (WriteLockGuard lock(m_PendingEventsLock); !m_PendingEvents.IsEmpty())
 			{
-				// Always get the first event
-				auto pendingIt = m_PendingEvents.begin();
-
 				// If we're inside 'Yield' call, process events selectively instead
 				IEventLoop* eventLoop = app->GetActiveEventLoop();
 				if (eventLoop && eventLoop->IsYielding())
 				{
 					// Find the first event which can be processed now
-					auto it = m_PendingEvents.begin();
-					for (; it != m_PendingEvents.end(); ++it)
+					pendingEvent = m_PendingEvents.PopIf([&](const IEvent& event)
 					{
-						if (eventLoop->IsEventAllowedInsideYield((*it)->GetEventCategory()))
-						{
-							pendingIt = std::move(it);
-							break;
-						}
-					}
-
-					if (it == m_PendingEvents.end())
-					{
-						// All our events are *not* processable now, signal this.
-						app->DelayPendingEventHandler(*this);
-
-						// See the comment at the beginning of 'IEventLoop' header for the logic behind YieldFor() and behind DelayPendingEventHandler().
-						return false;
-					}
+						return eventLoop->IsEventAllowedInsideYield(event.GetEventCategory());
+					});
+				}
+				else
+				{
+					// Always get the first event. It's important we remove event from the queue before processing it,
+					// else a nested event loop, for example from a modal dialog, might process the same event again.
+					pendingEvent = m_PendingEvents.Pop();
 				}
 
-				// It's important we remove event from the list before processing it, else a nested event loop,
-				// for example from a modal dialog, might process the same event again.
-				pendingEvent = std::move(*pendingIt);
-				m_PendingEvents.erase(pendingIt);
-
-				if (m_PendingEvents.empty())
+				if (m_PendingEvents.IsEmpty())
 				{
 					// If there are no more pending events left, we don't need to stay in this list.
 					app->RemovePendingEventHandler(*this);
 				}
+				else if (!pendingEvent)
+				{
+					// All our events are *not* processable now (or they're still being posted), signal this.
+					app->DelayPendingEventHandler(*this);
+
+					// See the comment at the beginning of 'IEventLoop' header for the logic behind YieldFor() and behind DelayPendingEventHandler().
+					return false;
+				}
 			}
-			
+			else
+			{
+				app->RemovePendingEventHandler(*this);
+			}
+
 			if (pendingEvent)
 			{
 				auto pendingEventInternal = pendingEvent->QueryInterface<IEventInternal>();
@@ -778,10 +684,7 @@ namespace kxf
 	size_t EvtHandler::DiscardPendingEvents()
 	{
 		WriteLockGuard lock(m_PendingEventsLock);
-
-		const size_t count = m_PendingEvents.size();
-		m_PendingEvents.clear();
-		return count;
+		return m_PendingEvents.Clear();
 	}
 
 	void EvtHandler::Unlink()
@@ -1,6 +1,8 @@
 #pragma once
 #include "Common.h"
 #include "IEvtHandler.h"
+#include "Private/EventTable.h"
+#include "Private/PendingEventQueue.h"
 #include "kxf/Threading/LockGuard.h"
 #include "kxf/Threading/ReadWriteLock.h"
 #include "kxf/Threading/RecursiveRWLock.h"
@@ -18,12 +20,12 @@ namespace kxf
 		private:
 			// Dynamic events table
 			RecursiveRWLock m_EventTableLock;
-			std::vector<EventItem> m_EventTable;
+			EventSystem::Private::EventTable m_EventTable;
 			size_t m_EventBindSlot = 0;
 
-			// Pending events
+			// Pending events, the lock serializes the consumer side of the queue
 			ReadWriteLock m_PendingEventsLock;
-			std::vector<std::unique_ptr<IEvent>> m_PendingEvents;
+			EventSystem::Private::PendingEventQueue m_PendingEvents;
 
 			// Events chain
 			std::atomic<IEvtHandler*> m_PrevHandler = nullptr;
@@ -0,0 +1,140 @@
+#include "KxfPCH.h"
+#include "EventTable.h"
+
+namespace kxf::EventSystem::Private
+{
+	EventTable::Bucket* EventTable::FindBucket(const EventID& eventID) noexcept
+	{
+		auto [it, end] = m_Buckets.equal_range(std::hash<EventID>()(eventID));
+		for (; it != end; ++it)
+		{
+			if (it->second.ID == eventID)
+			{
+				return &it->second;
+			}
+		}
+		return nullptr;
+	}
+	size_t EventTable::FindItem(const Bucket& bucket, const LocallyUniqueID& bindSlot) const noexcept
+	{
+		auto it = std::lower_bound(bucket.Items.begin(), bucket.Items.end(), bindSlot, [](const auto& item, const LocallyUniqueID& bindSlot)
+		{
+			return item->GetBindSlot() < bindSlot;
+		});
+		return it - bucket.Items.begin();
+	}
+	void EventTable::RemoveAt(Bucket& bucket, size_t index)
+	{
+		auto it = bucket.Items.begin() + index;
+		m_SlotIndex.erase((*it)->GetBindSlot());
+
+		// The item can be executing right now, don't destroy it until the iteration is over
+		if (m_IterationDepth != 0)
+		{
+			m_Retired.emplace_back(std::move(*it));
+		}
+		bucket.Items.erase(it);
+		m_Revision++;
+
+		if (bucket.Items.empty())
+		{
+			m_HasEmptyBuckets = true;
+		}
+	}
+
+	EventItem* EventTable::Find(const LocallyUniqueID& bindSlot) noexcept
+	{
+		if (auto it = m_SlotIndex.find(bindSlot); it != m_SlotIndex.end())
+		{
+			Bucket& bucket = *it->second;
+			return bucket.Items[FindItem(bucket, bindSlot)].get();
+		}
+		return nullptr;
+	}
+	EventItem& EventTable::Add(EventItem item)
+	{
+		const EventID eventID = item.GetEventID();
+
+		Bucket* bucket = FindBucket(eventID);
+		if (!bucket)
+		{
+			bucket = &m_Buckets.emplace(std::hash<EventID>()(eventID), Bucket{eventID})->second;
+		}
+
+		// New bind slots are always greater than any slot in use so appending keeps the bucket sorted
+		wxASSERT(bucket->Items.empty() || bucket->Items.back()->GetBindSlot() < item.GetBindSlot());
+
+		auto& newItem = *bucket->Items.emplace_back(std::make_unique<EventItem>(std::move(item)));
+		m_SlotIndex.insert_or_assign(newItem.GetBindSlot(), bucket);
+		m_Revision++;
+
+		return newItem;
+	}
+	bool EventTable::Remove(const LocallyUniqueID& bindSlot)
+	{
+		if (auto it = m_SlotIndex.find(bindSlot); it != m_SlotIndex.end())
+		{
+			Bucket& bucket = *it->second;
+			RemoveAt(bucket, FindItem(bucket, bindSlot));
+			Purge();
+
+			return true;
+		}
+		return false;
+	}
+	void EventTable::Clear()
+	{
+		// Buckets and items can be in use by a running iteration, retire the items and leave the empty buckets for 'Purge'
+		if (m_IterationDepth != 0)
+		{
+			for (auto& [hash, bucket]: m_Buckets)
+			{
+				for (auto& item: bucket.Items)
+				{
+					m_Retired.emplace_back(std::move(item));
+				}
+				bucket.Items.clear();
+			}
+			m_SlotIndex.clear();
+			m_HasEmptyBuckets = !m_Buckets.empty();
+			m_Revision++;
+
+			return;
+		}
+
+		m_Buckets.clear();
+		m_SlotIndex.clear();
+		m_Retired.clear();
+		m_HasEmptyBuckets = false;
+		m_Revision++;
+	}
+
+	void EventTable::Purge()
+	{
+		if (m_IterationDepth == 0)
+		{
+			m_Retired.clear();
+			if (m_HasEmptyBuckets)
+			{
+				std::erase_if(m_Buckets, [](const auto& item)
+				{
+					return item.second.Items.empty();
+				});
+				m_HasEmptyBuckets = false;
+			}
+		}
+	}
+
+	EventTable& EventTable::operator=(EventTable&& other) noexcept
+	{
+		// Bucket nodes are not reallocated when the container is moved so the slot index stays valid
+		m_Buckets = std::move(other.m_Buckets);
+		m_SlotIndex = std::move(other.m_SlotIndex);
+		m_Retired = std::move(other.m_Retired);
+		m_HasEmptyBuckets = std::exchange(other.m_HasEmptyBuckets, false);
+		m_Revision++;
+		other.m_Revision++;
+
+		return *this;
+	}
+}
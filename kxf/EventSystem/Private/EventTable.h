@@ -0,0 +1,174 @@
+#pragma once
+#include "../Common.h"
+#include "../EventItem.h"
+#include "kxf/Utility/ScopeGuard.h"
+#include <unordered_map>
+#include <atomic>
+
+namespace kxf::EventSystem::Private
+{
+	// Dynamic event table indexed by event ID. Items bound to the same ID are kept in a single bucket in bind order,
+	// the bucket is found by the precomputed hash of the ID so dispatching doesn't depend on the total number of bindings.
+	// The table itself doesn't do any locking, it's expected to be guarded by the owning event handler.
+	class KX_API EventTable final
+	{
+		private:
+			struct IdentityHash final
+			{
+				size_t operator()(size_t hash) const noexcept
+				{
+					return hash;
+				}
+			};
+			struct Bucket final
+			{
+				EventID ID;
+
+				// Sorted by bind slot, which is the same as the bind order
+				std::vector<std::unique_ptr<EventItem>> Items;
+			};
+
+		private:
+			std::unordered_multimap<size_t, Bucket, IdentityHash> m_Buckets;
+			std::unordered_map<LocallyUniqueID, Bucket*> m_SlotIndex;
+			size_t m_Revision = 0;
+
+			// Items removed while the table is being iterated are kept alive until the iteration is over
+			std::atomic<size_t> m_IterationDepth = 0;
+			std::vector<std::unique_ptr<EventItem>> m_Retired;
+			bool m_HasEmptyBuckets = false;
+
+		private:
+			Bucket* FindBucket(const EventID& eventID) noexcept;
+			size_t FindItem(const Bucket& bucket, const LocallyUniqueID& bindSlot) const noexcept;
+			void RemoveAt(Bucket& bucket, size_t index);
+
+		public:
+			EventTable() = default;
+			EventTable(EventTable&& other) noexcept
+			{
+				*this = std::move(other);
+			}
+			EventTable(const EventTable&) = delete;
+
+		public:
+			bool IsEmpty() const noexcept
+			{
+				return m_SlotIndex.empty();
+			}
+			size_t GetSize() const noexcept
+			{
+				return m_SlotIndex.size();
+			}
+
+			EventItem* Find(const LocallyUniqueID& bindSlot) noexcept;
+			EventItem& Add(EventItem item);
+			bool Remove(const LocallyUniqueID& bindSlot);
+			void Clear();
+
+			// Destroys items unbound during iteration and drops empty buckets, does nothing if the table is still being iterated
+			bool NeedsPurge() const noexcept
+			{
+				return !m_Retired.empty() || m_HasEmptyBuckets;
+			}
+			void Purge();
+
+			// Calls the function for each item bound to the event ID starting from the most recently bound one until it returns false.
+			// The table can be modified from inside the function, items bound after the iteration has started are not visited.
+			template<class TFunc>
+			void ForEachBound(const EventID& eventID, TFunc&& func)
+			{
+				Bucket* bucket = FindBucket(eventID);
+				if (!bucket)
+				{
+					return;
+				}
+
+				m_IterationDepth++;
+				Utility::ScopeGuard atExit = [&]()
+				{
+					m_IterationDepth--;
+				};
+
+				auto& items = bucket->Items;
+				for (size_t i = items.size(); i != 0;)
+				{
+					EventItem& item = *items[--i];
+					const LocallyUniqueID bindSlot = item.GetBindSlot();
+					const size_t revision = m_Revision;
+
+					if (!std::invoke(func, item))
+					{
+						break;
+					}
+					if (m_Revision != revision)
+					{
+						// The bucket has been changed, continue from the item bound right before the current one
+						i = FindItem(*bucket, bindSlot);
+					}
+				}
+			}
+
+			template<class TFunc>
+			size_t CountIf(const EventID& eventID, TFunc&& pred)
+			{
+				size_t count = 0;
+				if (Bucket* bucket = FindBucket(eventID))
+				{
+					for (const auto& item: bucket->Items)
+					{
+						if (std::invoke(pred, *item))
+						{
+							count++;
+						}
+					}
+				}
+				return count;
+			}
+
+			// Removes items bound to the event ID for which the predicate returns true, starting from the most recently bound one
+			template<class TFunc>
+			size_t RemoveIf(const EventID& eventID, TFunc&& pred)
+			{
+				size_t count = 0;
+				if (Bucket* bucket = FindBucket(eventID))
+				{
+					for (size_t i = bucket->Items.size(); i != 0;)
+					{
+						if (std::invoke(pred, *bucket->Items[--i]))
+						{
+							RemoveAt(*bucket, i);
+							count++;
+						}
+					}
+					Purge();
+				}
+				return count;
+			}
+
+			// Same as above but for every item in the table
+			template<class TFunc>
+			size_t RemoveIf(TFunc&& pred)
+			{
+				size_t count = 0;
+				for (auto& [hash, bucket]: m_Buckets)
+				{
+					for (size_t i = bucket.Items.size(); i != 0;)
+					{
+						if (std::invoke(pred, *bucket.Items[--i]))
+						{
+							RemoveAt(bucket, i);
+							count++;
+						}
+					}
+				}
+				Purge();
+
+				return count;
+			}
+
+		public:
+			EventTable& operator=(EventTable&& other) noexcept;
+			EventTable& operator=(const EventTable&) = delete;
+	};
+}
@@ -0,0 +1,94 @@
+#include "KxfPCH.h"
+#include "PendingEventQueue.h"
+
+namespace kxf::EventSystem::Private
+{
+	void PendingEventQueue::Drain()
+	{
+		// Take everything posted so far at once, the list is in reverse order
+		Node* node = m_Head.exchange(nullptr, std::memory_order_acquire);
+		if (node)
+		{
+			const size_t offset = m_Batch.size();
+			for (; node; node = node->Next)
+			{
+				m_Batch.emplace_back(node);
+			}
+			std::reverse(m_Batch.begin() + offset, m_Batch.end());
+		}
+	}
+	std::unique_ptr<IEvent> PendingEventQueue::Take(Node& node) noexcept
+	{
+		if (node.UniqueID)
+		{
+			m_Index.erase(node.UniqueID);
+		}
+		m_Count.fetch_sub(1, std::memory_order_release);
+
+		return std::move(node.Event);
+	}
+
+	bool PendingEventQueue::Push(std::unique_ptr<IEvent> event, const UniversallyUniqueID& uniqueID)
+	{
+		auto node = std::make_unique<Node>();
+		node->UniqueID = uniqueID;
+
+		std::unique_lock lock(m_IndexLock, std::defer_lock);
+		if (uniqueID)
+		{
+			lock.lock();
+
+			// If there's a pending event with the same unique ID replace it with the new one, it keeps its place in the queue
+			if (auto it = m_Index.find(uniqueID); it != m_Index.end())
+			{
+				std::swap(it->second->Event, event);
+				lock.unlock();
+
+				// The replaced event is destroyed here, outside of the lock
+				return false;
+			}
+			m_Index.insert_or_assign(uniqueID, node.get());
+		}
+		node->Event = std::move(event);
+
+		// Count the event before it becomes visible so the consumer can never take more than was counted
+		const bool wasEmpty = m_Count.fetch_add(1, std::memory_order_acq_rel) == 0;
+
+		Node* newHead = node.release();
+		newHead->Next = m_Head.load(std::memory_order_relaxed);
+		while (!m_Head.compare_exchange_weak(newHead->Next, newHead, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+		return wasEmpty;
+	}
+	size_t PendingEventQueue::Clear()
+	{
+		Drain();
+
+		std::unique_lock lock(m_IndexLock);
+		const size_t count = m_Batch.size();
+
+		m_Index.clear();
+		m_Count.fetch_sub(count, std::memory_order_release);
+		auto batch = std::move(m_Batch);
+		m_Batch.clear();
+		lock.unlock();
+
+		return count;
+	}
+
+	PendingEventQueue& PendingEventQueue::operator=(PendingEventQueue&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Clear();
+			other.Drain();
+
+			m_Batch = std::move(other.m_Batch);
+			m_Index = std::move(other.m_Index);
+			m_Count.store(other.m_Count.exchange(0, std::memory_order_acq_rel), std::memory_order_release);
+			other.m_Batch.clear();
+		}
+		return *this;
+	}
+}
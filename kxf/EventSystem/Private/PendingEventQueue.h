@@ -0,0 +1,107 @@
+#pragma once
+#include "../Common.h"
+#include "../IEvent.h"
+#include "kxf/Core/UniversallyUniqueID.h"
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <deque>
+
+namespace kxf::EventSystem::Private
+{
+	// Multi-producer single-consumer queue of events waiting to be processed by an event handler. Posting an event
+	// doesn't take any locks unless the event has a unique ID, in which case it replaces the pending event with the
+	// same ID if there is one. Consumer side functions ('Pop*', 'Clear') must be serialized by the caller.
+	class KX_API PendingEventQueue final
+	{
+		private:
+			struct Node final
+			{
+				std::unique_ptr<IEvent> Event;
+				UniversallyUniqueID UniqueID;
+				Node* Next = nullptr;
+			};
+
+		private:
+			// Producer side, newest event first
+			std::atomic<Node*> m_Head = nullptr;
+			std::atomic<size_t> m_Count = 0;
+
+			// Coalescing index of the events with unique ID which haven't been taken yet
+			std::mutex m_IndexLock;
+			std::unordered_map<UniversallyUniqueID, Node*> m_Index;
+
+			// Consumer side, oldest event first
+			std::deque<std::unique_ptr<Node>> m_Batch;
+
+		private:
+			void Drain();
+			std::unique_ptr<IEvent> Take(Node& node) noexcept;
+
+		public:
+			PendingEventQueue() = default;
+			PendingEventQueue(const PendingEventQueue&) = delete;
+			~PendingEventQueue()
+			{
+				Clear();
+			}
+
+		public:
+			// The count includes events being posted right now, so the queue can briefly appear non-empty while 'Pop' returns nothing
+			size_t GetCount() const noexcept
+			{
+				return m_Count.load(std::memory_order_acquire);
+			}
+			bool IsEmpty() const noexcept
+			{
+				return GetCount() == 0;
+			}
+
+			// Returns true if the queue was empty before the event was added
+			bool Push(std::unique_ptr<IEvent> event, const UniversallyUniqueID& uniqueID = {});
+
+			// Removes and returns the oldest event accepted by the predicate
+			template<class TFunc>
+			std::unique_ptr<IEvent> PopIf(TFunc&& pred)
+			{
+				Drain();
+				for (auto it = m_Batch.begin(); it != m_Batch.end(); ++it)
+				{
+					Node& node = **it;
+
+					// Events with unique ID can be replaced by the producers until we take them
+					std::unique_lock lock(m_IndexLock, std::defer_lock);
+					if (node.UniqueID)
+					{
+						lock.lock();
+					}
+
+					if (std::invoke(pred, std::as_const(*node.Event)))
+					{
+						auto event = Take(node);
+						if (lock)
+						{
+							lock.unlock();
+						}
+
+						m_Batch.erase(it);
+						return event;
+					}
+				}
+				return nullptr;
+			}
+			std::unique_ptr<IEvent> Pop()
+			{
+				return PopIf([](const IEvent&)
+				{
+					return true;
+				});
+			}
+			size_t Clear();
+
+		public:
+			// Not thread-safe, neither queue can have concurrent producers
+			PendingEventQueue& operator=(PendingEventQueue&& other) noexcept;
+			PendingEventQueue& operator=(const PendingEventQueue&) = delete;
+	};
+}
@@ -0,0 +1,379 @@
+#include "KxfPCH.h"
+#include "BufferedStream.h"
+#include "kxf/Threading/IThreadPool.h"
+#include <mutex>
+#include <condition_variable>
+
+namespace
+{
+	size_t GetLength(kxf::DataSize size) noexcept
+	{
+		return size.IsValid() ? size.ToBytes() : 0;
+	}
+}
+
+namespace kxf
+{
+	// Background read of the next block. Lives on the heap so the pending task isn't affected by moving the stream.
+	struct BufferedInputStream::ReadAhead final
+	{
+		IThreadPool& ThreadPool;
+		std::vector<uint8_t> Buffer;
+		size_t Length = 0;
+		StreamError Error = StreamErrorCode::Success;
+
+		std::mutex Lock;
+		std::condition_variable Condition;
+		bool IsPending = false;
+		bool IsActive = false;
+
+		ReadAhead(IThreadPool& threadPool, size_t bufferSize)
+			:ThreadPool(threadPool), Buffer(bufferSize)
+		{
+		}
+
+		void Start(IInputStream& stream)
+		{
+			if (std::unique_lock lock(Lock); true)
+			{
+				IsPending = true;
+				IsActive = true;
+			}
+
+			auto ReadBlock = [this, &stream]()
+			{
+				stream.Read(Buffer.data(), Buffer.size());
+				const size_t length = GetLength(stream.LastRead());
+				StreamError error = stream.GetLastError();
+
+				std::unique_lock lock(Lock);
+				Length = length;
+				Error = std::move(error);
+				IsPending = false;
+				Condition.notify_all();
+			};
+
+			// A stopped pool still accepts tasks but never runs them, read the block right here instead of waiting forever
+			if (!ThreadPool.IsRunning() || !ThreadPool.AddTask(ReadBlock))
+			{
+				ReadBlock();
+			}
+		}
+		void Wait()
+		{
+			std::unique_lock lock(Lock);
+			Condition.wait(lock, [&]()
+			{
+				return !IsPending;
+			});
+		}
+	};
+}
+
+namespace kxf
+{
+	void BufferedInputStream::Init(size_t bufferSize, IThreadPool* threadPool)
+	{
+		bufferSize = std::max<size_t>(bufferSize, 1);
+		m_Buffer.resize(bufferSize);
+
+		if (threadPool)
+		{
+			m_ReadAhead = std::make_unique<ReadAhead>(*threadPool, bufferSize);
+		}
+	}
+
+	bool BufferedInputStream::FillBuffer()
+	{
+		m_BufferPosition = 0;
+		m_BufferLength = 0;
+
+		if (m_ReadAhead)
+		{
+			// Take the block read in the background and start reading the next one right away
+			if (!m_ReadAhead->IsActive)
+			{
+				m_ReadAhead->Start(*m_Stream);
+			}
+			m_ReadAhead->Wait();
+			m_ReadAhead->IsActive = false;
+
+			std::swap(m_Buffer, m_ReadAhead->Buffer);
+			m_BufferLength = m_ReadAhead->Length;
+			m_StreamError = m_ReadAhead->Error;
+
+			if (m_BufferLength != 0 && m_StreamError.IsSuccess())
+			{
+				m_ReadAhead->Start(*m_Stream);
+			}
+		}
+		else
+		{
+			m_Stream->Read(m_Buffer.data(), m_Buffer.size());
+			m_BufferLength = GetLength(m_Stream->LastRead());
+			m_StreamError = m_Stream->GetLastError();
+		}
+		return m_BufferLength != 0;
+	}
+	size_t BufferedInputStream::WaitReadAhead() const
+	{
+		// Returns how many bytes the underlying stream has read past the buffer
+		if (m_ReadAhead && m_ReadAhead->IsActive)
+		{
+			m_ReadAhead->Wait();
+			return m_ReadAhead->Length;
+		}
+		return 0;
+	}
+	void BufferedInputStream::DiscardBuffer()
+	{
+		WaitReadAhead();
+		if (m_ReadAhead)
+		{
+			m_ReadAhead->IsActive = false;
+		}
+
+		m_BufferPosition = 0;
+		m_BufferLength = 0;
+		m_StreamError = StreamErrorCode::Success;
+	}
+
+	BufferedInputStream::BufferedInputStream(BufferedInputStream&& other) noexcept
+		:InputStreamDelegate(std::move(other)),
+		m_Buffer(std::move(other.m_Buffer)),
+		m_BufferPosition(std::exchange(other.m_BufferPosition, 0)),
+		m_BufferLength(std::exchange(other.m_BufferLength, 0)),
+		m_ReadAhead(std::move(other.m_ReadAhead)),
+		m_LastRead(std::exchange(other.m_LastRead, {})),
+		m_LastError(std::move(other.m_LastError)),
+		m_StreamError(std::move(other.m_StreamError))
+	{
+	}
+	BufferedInputStream::~BufferedInputStream()
+	{
+		WaitReadAhead();
+	}
+
+	// IStream
+	void BufferedInputStream::Close()
+	{
+		DiscardBuffer();
+		m_Stream->Close();
+	}
+
+	bool BufferedInputStream::IsSeekable() const
+	{
+		WaitReadAhead();
+		return m_Stream->IsSeekable();
+	}
+	DataSize BufferedInputStream::GetSize() const
+	{
+		WaitReadAhead();
+		return m_Stream->GetSize();
+	}
+
+	// IInputStream
+	std::optional<uint8_t> BufferedInputStream::Peek()
+	{
+		if (GetBufferedLength() != 0 || FillBuffer())
+		{
+			return m_Buffer[m_BufferPosition];
+		}
+		return {};
+	}
+	IInputStream& BufferedInputStream::Read(void* buffer, size_t size)
+	{
+		auto data = static_cast<uint8_t*>(buffer);
+		size_t totalRead = 0;
+
+		while (totalRead != size)
+		{
+			if (GetBufferedLength() == 0)
+			{
+				// Large reads go directly to the destination unless the next block is being read in the background
+				if (!m_ReadAhead && size - totalRead >= m_Buffer.size())
+				{
+					m_Stream->Read(data + totalRead, size - totalRead);
+					totalRead += GetLength(m_Stream->LastRead());
+					m_StreamError = m_Stream->GetLastError();
+
+					break;
+				}
+				else if (!FillBuffer())
+				{
+					break;
+				}
+			}
+
+			const size_t count = std::min(size - totalRead, GetBufferedLength());
+			std::memcpy(data + totalRead, m_Buffer.data() + m_BufferPosition, count);
+			m_BufferPosition += count;
+			totalRead += count;
+		}
+
+		m_LastRead = totalRead;
+		m_LastError = totalRead == size || GetBufferedLength() != 0 ? StreamErrorCode::Success : m_StreamError;
+		return *this;
+	}
+	std::span<const std::byte> BufferedInputStream::ReadView(size_t size)
+	{
+		if (GetBufferedLength() < size && size <= m_Buffer.size() && m_BufferPosition != 0 && !m_ReadAhead)
+		{
+			// Move the unread part to the front and read the rest of the block to fit the view
+			const size_t buffered = GetBufferedLength();
+			std::memmove(m_Buffer.data(), m_Buffer.data() + m_BufferPosition, buffered);
+
+			m_Stream->Read(m_Buffer.data() + buffered, m_Buffer.size() - buffered);
+			m_BufferPosition = 0;
+			m_BufferLength = buffered + GetLength(m_Stream->LastRead());
+			m_StreamError = m_Stream->GetLastError();
+		}
+		else if (GetBufferedLength() == 0 && size <= m_Buffer.size())
+		{
+			FillBuffer();
+		}
+
+		if (GetBufferedLength() >= size || (GetBufferedLength() != 0 && m_StreamError.IsFail()))
+		{
+			const size_t count = std::min(size, GetBufferedLength());
+			std::span<const std::byte> view = {reinterpret_cast<const std::byte*>(m_Buffer.data() + m_BufferPosition), count};
+			m_BufferPosition += count;
+
+			m_LastRead = count;
+			m_LastError = count == size || GetBufferedLength() != 0 ? StreamErrorCode::Success : m_StreamError;
+			return view;
+		}
+		return {};
+	}
+
+	DataSize BufferedInputStream::TellI() const
+	{
+		const size_t ahead = WaitReadAhead();
+		return m_Stream->TellI() - static_cast<int64_t>(GetBufferedLength() + ahead);
+	}
+	DataSize BufferedInputStream::SeekI(DataSize offset, IOStreamSeek seek)
+	{
+		if (seek == IOStreamSeek::FromCurrent)
+		{
+			// Short seeks inside the buffer don't need to touch the underlying stream
+			const int64_t bytes = offset.ToBytes();
+			if (bytes >= -static_cast<int64_t>(m_BufferPosition) && bytes <= static_cast<int64_t>(GetBufferedLength()))
+			{
+				m_BufferPosition = static_cast<size_t>(static_cast<int64_t>(m_BufferPosition) + bytes);
+				return TellI();
+			}
+
+			const size_t ahead = WaitReadAhead();
+			offset = bytes - static_cast<int64_t>(GetBufferedLength() + ahead);
+		}
+
+		DiscardBuffer();
+		return m_Stream->SeekI(offset, seek);
+	}
+
+	BufferedInputStream& BufferedInputStream::operator=(BufferedInputStream&& other) noexcept
+	{
+		if (this != &other)
+		{
+			WaitReadAhead();
+
+			static_cast<InputStreamDelegate&>(*this) = std::move(other);
+			m_Buffer = std::move(other.m_Buffer);
+			m_BufferPosition = std::exchange(other.m_BufferPosition, 0);
+			m_BufferLength = std::exchange(other.m_BufferLength, 0);
+			m_ReadAhead = std::move(other.m_ReadAhead);
+			m_LastRead = std::exchange(other.m_LastRead, {});
+			m_LastError = std::move(other.m_LastError);
+			m_StreamError = std::move(other.m_StreamError);
+		}
+		return *this;
+	}
+}
+
+namespace kxf
+{
+	bool BufferedOutputStream::FlushBuffer()
+	{
+		if (m_BufferLength != 0)
+		{
+			const bool result = m_Stream->WriteAll(m_Buffer.data(), m_BufferLength);
+			m_BufferLength = 0;
+
+			if (!result)
+			{
+				m_LastError = m_Stream->GetLastError();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	BufferedOutputStream::~BufferedOutputStream()
+	{
+		if (HasTargetStream())
+		{
+			FlushBuffer();
+		}
+	}
+
+	// IStream
+	void BufferedOutputStream::Close()
+	{
+		FlushBuffer();
+		m_Stream->Close();
+	}
+
+	DataSize BufferedOutputStream::GetSize() const
+	{
+		return std::max(m_Stream->GetSize(), TellO());
+	}
+
+	// IOutputStream
+	IOutputStream& BufferedOutputStream::Write(const void* buffer, size_t size)
+	{
+		m_LastWrite = {};
+		if (size > m_Buffer.size() - m_BufferLength)
+		{
+			if (!FlushBuffer())
+			{
+				return *this;
+			}
+
+			// Doesn't fit into the buffer at all, no point in copying it
+			if (size >= m_Buffer.size())
+			{
+				m_Stream->Write(buffer, size);
+				m_LastWrite = m_Stream->LastWrite();
+				m_LastError = m_Stream->GetLastError();
+
+				return *this;
+			}
+		}
+
+		std::memcpy(m_Buffer.data() + m_BufferLength, buffer, size);
+		m_BufferLength += size;
+		m_LastWrite = size;
+		m_LastError = StreamErrorCode::Success;
+
+		return *this;
+	}
+
+	DataSize BufferedOutputStream::TellO() const
+	{
+		return m_Stream->TellO() + static_cast<int64_t>(m_BufferLength);
+	}
+	DataSize BufferedOutputStream::SeekO(DataSize offset, IOStreamSeek seek)
+	{
+		FlushBuffer();
+		return m_Stream->SeekO(offset, seek);
+	}
+
+	bool BufferedOutputStream::Flush()
+	{
+		return FlushBuffer() && m_Stream->Flush();
+	}
+	bool BufferedOutputStream::SetAllocationSize(DataSize allocationSize)
+	{
+		return FlushBuffer() && m_Stream->SetAllocationSize(allocationSize);
+	}
+}
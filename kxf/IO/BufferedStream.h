@@ -0,0 +1,232 @@
+#pragma once
+#include "Common.h"
+#include "StreamDelegate.h"
+
+namespace kxf
+{
+	class IThreadPool;
+}
+
+namespace kxf
+{
+	// Reads the underlying stream in large blocks and serves small reads from memory. With a thread pool the next block
+	// is read in the background while the current one is being consumed. The underlying stream must not be used directly
+	// while it's attached to the buffered stream.
+	class KX_API BufferedInputStream: public InputStreamDelegate
+	{
+		public:
+			static constexpr size_t DefaultBufferSize = 64 * 1024;
+
+		private:
+			struct ReadAhead;
+
+		private:
+			std::vector<uint8_t> m_Buffer;
+			size_t m_BufferPosition = 0;
+			size_t m_BufferLength = 0;
+			std::unique_ptr<ReadAhead> m_ReadAhead;
+
+			DataSize m_LastRead;
+			StreamError m_LastError = StreamErrorCode::Success;
+			StreamError m_StreamError = StreamErrorCode::Success;
+
+		private:
+			void Init(size_t bufferSize, IThreadPool* threadPool);
+			size_t GetBufferedLength() const noexcept
+			{
+				return m_BufferLength - m_BufferPosition;
+			}
+
+			bool FillBuffer();
+			size_t WaitReadAhead() const;
+			void DiscardBuffer();
+
+		public:
+			BufferedInputStream(IInputStream& stream, size_t bufferSize = DefaultBufferSize, IThreadPool* threadPool = nullptr)
+				:InputStreamDelegate(stream)
+			{
+				Init(bufferSize, threadPool);
+			}
+			BufferedInputStream(std::unique_ptr<IInputStream> stream, size_t bufferSize = DefaultBufferSize, IThreadPool* threadPool = nullptr)
+				:InputStreamDelegate(std::move(stream))
+			{
+				Init(bufferSize, threadPool);
+			}
+			BufferedInputStream(BufferedInputStream&&) noexcept;
+			BufferedInputStream(const BufferedInputStream&) = delete;
+			~BufferedInputStream();
+
+		public:
+			// IStream
+			void Close() override;
+
+			StreamError GetLastError() const override
+			{
+				return m_LastError;
+			}
+			void SetLastError(StreamError lastError) override
+			{
+				m_LastError = std::move(lastError);
+			}
+
+			bool IsSeekable() const override;
+			DataSize GetSize() const override;
+
+			// IInputStream
+			bool CanRead() const override
+			{
+				return GetBufferedLength() != 0 || m_StreamError.IsSuccess();
+			}
+
+			DataSize LastRead() const override
+			{
+				return m_LastRead;
+			}
+			void SetLastRead(DataSize lastRead) override
+			{
+				m_LastRead = lastRead;
+			}
+
+			std::optional<uint8_t> Peek() override;
+			IInputStream& Read(void* buffer, size_t size) override;
+			IInputStream& Read(IOutputStream& other) override
+			{
+				return IInputStream::Read(other);
+			}
+			bool ReadAll(void* buffer, size_t size) override
+			{
+				return IInputStream::ReadAll(buffer, size);
+			}
+			IInputStream& ReadV(std::span<const std::span<std::byte>> buffers) override
+			{
+				return IInputStream::ReadV(buffers);
+			}
+			std::span<const std::byte> ReadView(size_t size) override;
+
+			DataSize TellI() const override;
+			DataSize SeekI(DataSize offset, IOStreamSeek seek) override;
+
+			// BufferedInputStream
+			size_t GetBufferSize() const noexcept
+			{
+				return m_Buffer.size();
+			}
+			bool IsReadAheadEnabled() const noexcept
+			{
+				return m_ReadAhead != nullptr;
+			}
+
+		public:
+			BufferedInputStream& operator=(BufferedInputStream&&) noexcept;
+			BufferedInputStream& operator=(const BufferedInputStream&) = delete;
+	};
+}
+
+namespace kxf
+{
+	// Collects small writes in memory and passes them to the underlying stream in large blocks. The buffer is written out
+	// on 'Flush', before seeking and when the stream is closed or destroyed.
+	class KX_API BufferedOutputStream: public OutputStreamDelegate
+	{
+		public:
+			static constexpr size_t DefaultBufferSize = 64 * 1024;
+
+		private:
+			std::vector<uint8_t> m_Buffer;
+			size_t m_BufferLength = 0;
+
+			DataSize m_LastWrite;
+			StreamError m_LastError = StreamErrorCode::Success;
+
+		private:
+			bool FlushBuffer();
+
+		public:
+			BufferedOutputStream(IOutputStream& stream, size_t bufferSize = DefaultBufferSize)
+				:OutputStreamDelegate(stream), m_Buffer(std::max<size_t>(bufferSize, 1))
+			{
+			}
+			BufferedOutputStream(std::unique_ptr<IOutputStream> stream, size_t bufferSize = DefaultBufferSize)
+				:OutputStreamDelegate(std::move(stream)), m_Buffer(std::max<size_t>(bufferSize, 1))
+			{
+			}
+			BufferedOutputStream(BufferedOutputStream&& other) noexcept
+				:OutputStreamDelegate(std::move(other)),
+				m_Buffer(std::move(other.m_Buffer)),
+				m_BufferLength(std::exchange(other.m_BufferLength, 0)),
+				m_LastWrite(std::exchange(other.m_LastWrite, {})),
+				m_LastError(std::move(other.m_LastError))
+			{
+			}
+			BufferedOutputStream(const BufferedOutputStream&) = delete;
+			~BufferedOutputStream();
+
+		public:
+			// IStream
+			void Close() override;
+
+			StreamError GetLastError() const override
+			{
+				return m_LastError;
+			}
+			void SetLastError(StreamError lastError) override
+			{
+				m_LastError = std::move(lastError);
+			}
+
+			DataSize GetSize() const override;
+
+			// IOutputStream
+			DataSize LastWrite() const override
+			{
+				return m_LastWrite;
+			}
+			void SetLastWrite(DataSize lastWrite) override
+			{
+				m_LastWrite = lastWrite;
+			}
+
+			IOutputStream& Write(const void* buffer, size_t size) override;
+			IOutputStream& Write(IInputStream& other) override
+			{
+				return IOutputStream::Write(other);
+			}
+			bool WriteAll(const void* buffer, size_t size) override
+			{
+				return IOutputStream::WriteAll(buffer, size);
+			}
+			IOutputStream& WriteV(std::span<const std::span<const std::byte>> buffers) override
+			{
+				return IOutputStream::WriteV(buffers);
+			}
+
+			DataSize TellO() const override;
+			DataSize SeekO(DataSize offset, IOStreamSeek seek) override;
+
+			bool Flush() override;
+			bool SetAllocationSize(DataSize allocationSize) override;
+
+			// BufferedOutputStream
+			size_t GetBufferSize() const noexcept
+			{
+				return m_Buffer.size();
+			}
+
+		public:
+			BufferedOutputStream& operator=(BufferedOutputStream&& other) noexcept
+			{
+				if (this != &other)
+				{
+					FlushBuffer();
+
+					static_cast<OutputStreamDelegate&>(*this) = std::move(other);
+					m_Buffer = std::move(other.m_Buffer);
+					m_BufferLength = std::exchange(other.m_BufferLength, 0);
+					m_LastWrite = std::exchange(other.m_LastWrite, {});
+					m_LastError = std::move(other.m_LastError);
+				}
+				return *this;
+			}
+			BufferedOutputStream& operator=(const BufferedOutputStream&) = delete;
+	};
+}
@@ -4,6 +4,7 @@
 namespace
 {
 	constexpr size_t g_BufferSize = kxf::DataSize::FromKB(64).ToBytes();
+	constexpr size_t g_ViewBlockSize = kxf::DataSize::FromMB(64).ToBytes();
 }
 
 namespace kxf
@@ -11,6 +12,29 @@ namespace kxf
 	IInputStream& IInputStream::Read(IOutputStream& other)
 	{
 		DataSize readTotal = 0;
+
+		// Write directly from the stream memory if it's available instead of copying through the buffer
+		if (auto view = ReadView(g_ViewBlockSize); !view.empty())
+		{
+			while (!view.empty())
+			{
+				const DataSize written = other.Write(view.data(), view.size()).LastWrite();
+				const size_t writtenBytes = written.IsValid() ? written.ToBytes() : 0;
+
+				readTotal += writtenBytes;
+				if (writtenBytes != view.size())
+				{
+					// Return what wasn't written back to the stream
+					SeekI(-static_cast<int64_t>(view.size() - writtenBytes), IOStreamSeek::FromCurrent);
+					break;
+				}
+				view = ReadView(g_ViewBlockSize);
+			}
+			SetLastRead(readTotal);
+
+			return *this;
+		}
+
 		uint8_t buffer[g_BufferSize];
 
 		while (true)
@@ -73,6 +97,32 @@ namespace kxf
 
 		return size == bufferOffset;
 	}
+	IInputStream& IInputStream::ReadV(std::span<const std::span<std::byte>> buffers)
+	{
+		DataSize readTotal = 0;
+		for (const auto& buffer: buffers)
+		{
+			if (buffer.empty())
+			{
+				continue;
+			}
+
+			const DataSize read = Read(buffer.data(), buffer.size()).LastRead();
+			if (!read || read == 0)
+			{
+				break;
+			}
+
+			readTotal += read;
+			if (read.ToBytes<size_t>() != buffer.size())
+			{
+				break;
+			}
+		}
+		SetLastRead(readTotal);
+
+		return *this;
+	}
 }
 
 namespace kxf
@@ -115,4 +165,30 @@ namespace kxf
 
 		return size == bufferOffset;
 	}
+	IOutputStream& IOutputStream::WriteV(std::span<const std::span<const std::byte>> buffers)
+	{
+		DataSize writtenTotal = 0;
+		for (const auto& buffer: buffers)
+		{
+			if (buffer.empty())
+			{
+				continue;
+			}
+
+			const DataSize written = Write(buffer.data(), buffer.size()).LastWrite();
+			if (!written || written == 0)
+			{
+				break;
+			}
+
+			writtenTotal += written;
+			if (written.ToBytes<size_t>() != buffer.size())
+			{
+				break;
+			}
+		}
+		SetLastWrite(writtenTotal);
+
+		return *this;
+	}
 }
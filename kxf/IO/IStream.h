@@ -60,6 +60,18 @@ namespace kxf
 			virtual IInputStream& Read(IOutputStream& other);
 			virtual bool ReadAll(void* buffer, size_t size);
 
+			// Scatter read. Fills the buffers in order and stops at the first one which couldn't be filled completely,
+			// 'LastRead' is set to the total number of bytes read into all of them.
+			virtual IInputStream& ReadV(std::span<const std::span<std::byte>> buffers);
+
+			// Optional zero-copy access to the stream data. Returns the next 'size' bytes (fewer only if the stream ends before that)
+			// and advances the stream past them, the view stays valid until the stream is modified or closed. Streams which can't
+			// provide such a view return an empty one without changing their position, use 'Read' in that case.
+			virtual std::span<const std::byte> ReadView(size_t size)
+			{
+				return {};
+			}
+
 			virtual DataSize TellI() const = 0;
 			virtual DataSize SeekI(DataSize offset, IOStreamSeek seek) = 0;
 			DataSize RewindI()
@@ -86,6 +98,10 @@ namespace kxf
 			virtual IOutputStream& Write(IInputStream& other);
 			virtual bool WriteAll(const void* buffer, size_t size);
 
+			// Gather write. Writes the buffers in order as if they were a single contiguous one and stops at the first short write,
+			// 'LastWrite' is set to the total number of bytes written.
+			virtual IOutputStream& WriteV(std::span<const std::span<const std::byte>> buffers);
+
 			virtual DataSize TellO() const = 0;
 			virtual DataSize SeekO(DataSize offset, IOStreamSeek seek) = 0;
 			DataSize RewindO()
@@ -0,0 +1,243 @@
+#include "KxfPCH.h"
+#include "MappedFileStream.h"
+
+namespace
+{
+	constexpr size_t g_MinGrowSize = kxf::DataSize::FromMB(1).ToBytes();
+}
+
+namespace kxf
+{
+	bool MappedFileStream::DoMap(size_t size)
+	{
+		DoUnmap();
+		if (size == 0)
+		{
+			// Empty files can't be mapped
+			return true;
+		}
+
+		ULARGE_INTEGER sizeULI = {};
+		sizeULI.QuadPart = size;
+
+		// The file is extended to the mapping size if it's smaller
+		m_MappingHandle = ::CreateFileMappingW(m_File.GetHandle(), nullptr, m_IsWritable ? PAGE_READWRITE : PAGE_READONLY, sizeULI.HighPart, sizeULI.LowPart, nullptr);
+		if (m_MappingHandle)
+		{
+			m_View = ::MapViewOfFile(m_MappingHandle, m_IsWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+			if (m_View)
+			{
+				m_MappedSize = size;
+				return true;
+			}
+
+			::CloseHandle(m_MappingHandle);
+			m_MappingHandle = nullptr;
+		}
+		return false;
+	}
+	void MappedFileStream::DoUnmap() noexcept
+	{
+		if (m_View)
+		{
+			::UnmapViewOfFile(m_View);
+			m_View = nullptr;
+		}
+		if (m_MappingHandle)
+		{
+			::CloseHandle(m_MappingHandle);
+			m_MappingHandle = nullptr;
+		}
+		m_MappedSize = 0;
+	}
+	bool MappedFileStream::DoClose()
+	{
+		if (IsOpened())
+		{
+			if (m_IsWritable && m_View)
+			{
+				::FlushViewOfFile(m_View, m_DataSize);
+			}
+			DoUnmap();
+
+			// Drop the unused part of the mapping
+			if (m_IsWritable)
+			{
+				m_File.SeekO(m_DataSize, IOStreamSeek::FromStart);
+				m_File.SetAllocationSize({});
+			}
+			m_File.Close();
+			m_File = {};
+
+			m_StreamBuffer = {};
+			m_DataSize = 0;
+			m_IsWritable = false;
+			m_LastError = StreamErrorCode::EndOfStream;
+			m_LastRead = {};
+			m_LastWrite = {};
+
+			return true;
+		}
+		return false;
+	}
+	void MappedFileStream::UpdateStreamBuffer(size_t offset) noexcept
+	{
+		m_StreamBuffer.AttachStorage(m_View, m_DataSize);
+		m_StreamBuffer.SetStorageFixed();
+		if (offset != 0)
+		{
+			m_StreamBuffer.Seek(static_cast<intptr_t>(offset), IOStreamSeek::FromStart);
+		}
+	}
+	bool MappedFileStream::EnsureCapacity(size_t size)
+	{
+		if (size > m_MappedSize)
+		{
+			// Grow geometrically to not remap the file on every write
+			const size_t offset = m_StreamBuffer.Tell();
+			const size_t oldSize = m_MappedSize;
+			if (!DoMap(std::max({size, m_MappedSize + m_MappedSize / 2, g_MinGrowSize})))
+			{
+				// Restore the previous mapping so the data written so far is still accessible
+				DoMap(oldSize);
+				UpdateStreamBuffer(offset);
+
+				return false;
+			}
+			UpdateStreamBuffer(offset);
+		}
+		return true;
+	}
+
+	// IInputStream
+	std::optional<uint8_t> MappedFileStream::Peek()
+	{
+		if (CanRead())
+		{
+			return *static_cast<const uint8_t*>(m_StreamBuffer.GetBufferCurrent());
+		}
+		return {};
+	}
+	IInputStream& MappedFileStream::Read(void* buffer, size_t size)
+	{
+		m_LastRead = m_StreamBuffer.Read(buffer, size);
+		m_LastError = m_StreamBuffer.IsEndOfStream() ? StreamErrorCode::EndOfStream : StreamErrorCode::Success;
+
+		return *this;
+	}
+	std::span<const std::byte> MappedFileStream::ReadView(size_t size)
+	{
+		auto view = m_StreamBuffer.ReadView(size);
+		m_LastRead = view.size();
+		m_LastError = m_StreamBuffer.IsEndOfStream() ? StreamErrorCode::EndOfStream : StreamErrorCode::Success;
+
+		return view;
+	}
+
+	// IOutputStream
+	IOutputStream& MappedFileStream::Write(const void* buffer, size_t size)
+	{
+		m_LastWrite = {};
+		if (!m_IsWritable)
+		{
+			m_LastError = StreamErrorCode::ReadOnly;
+			return *this;
+		}
+
+		const size_t offset = m_StreamBuffer.Tell();
+		if (!EnsureCapacity(offset + size))
+		{
+			m_LastError = StreamErrorCode::WriteError;
+			return *this;
+		}
+
+		if (offset + size > m_DataSize)
+		{
+			m_DataSize = offset + size;
+			UpdateStreamBuffer(offset);
+		}
+		m_LastWrite = m_StreamBuffer.Write(buffer, size);
+		m_LastError = StreamErrorCode::Success;
+
+		return *this;
+	}
+
+	bool MappedFileStream::Flush()
+	{
+		if (m_IsWritable && m_View)
+		{
+			return ::FlushViewOfFile(m_View, m_DataSize) && m_File.Flush();
+		}
+		return false;
+	}
+	bool MappedFileStream::SetAllocationSize(DataSize allocationSize)
+	{
+		if (m_IsWritable && allocationSize)
+		{
+			const size_t size = allocationSize.ToBytes();
+			if (!EnsureCapacity(size))
+			{
+				return false;
+			}
+
+			// Shrinking only affects the data size, the file is truncated when the stream is closed
+			if (size < m_DataSize)
+			{
+				m_DataSize = size;
+				UpdateStreamBuffer(std::min(m_StreamBuffer.Tell(), size));
+			}
+			return true;
+		}
+		return false;
+	}
+
+	// IMemoryStream
+	MemoryStreamBuffer MappedFileStream::DetachStreamBuffer()
+	{
+		// The view can't outlive the mapping, so detaching gives an owning copy of the data
+		MemoryStreamBuffer streamBuffer;
+		streamBuffer.CreateStorage(m_View, m_DataSize);
+		DoClose();
+
+		return streamBuffer;
+	}
+	size_t MappedFileStream::CopyToBuffer(void* buffer, size_t size) const
+	{
+		const size_t effectiveSize = std::min(size, m_DataSize);
+		std::memcpy(buffer, m_View, effectiveSize);
+
+		return effectiveSize;
+	}
+
+	// MappedFileStream
+	bool MappedFileStream::Open(const FSPath& path, FlagSet<IOStreamAccess> access, IOStreamDisposition disposition, FlagSet<IOStreamShare> share)
+	{
+		DoClose();
+
+		// Mapping requires read access even for writing
+		m_IsWritable = access.Contains(IOStreamAccess::Write);
+		if (m_IsWritable)
+		{
+			access.Add(IOStreamAccess::Read);
+		}
+
+		if (m_File.Open(path, access, disposition, share))
+		{
+			m_DataSize = m_File.GetSize().ToBytes();
+			if (DoMap(m_DataSize))
+			{
+				UpdateStreamBuffer(0);
+				m_LastError = StreamErrorCode::Success;
+
+				return true;
+			}
+			m_File.Close();
+		}
+
+		m_File = {};
+		m_DataSize = 0;
+		m_IsWritable = false;
+		m_LastError = StreamError::Fail();
+		return false;
+	}
+}
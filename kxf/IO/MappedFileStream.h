@@ -0,0 +1,193 @@
+#pragma once
+#include "Common.h"
+#include "kxf/IO/IStream.h"
+#include "kxf/IO/IMemoryStream.h"
+#include "kxf/IO/IStreamOnFileSystem.h"
+#include "kxf/IO/MemoryStreamBuffer.h"
+#include "kxf/IO/NativeFileStream.h"
+
+namespace kxf
+{
+	// File stream working on a memory mapped view of the whole file. The mapped view is exposed through 'IMemoryStream'
+	// as an attached (non-owning) stream buffer so consumers aware of memory streams can work on the file contents directly.
+	// The stream is read-only unless it was opened with write access, writing past the end of the file grows the mapping
+	// and the file is truncated to the actually written size when the stream is closed.
+	class KX_API MappedFileStream: public RTTI::Implementation<MappedFileStream, IInputStream, IOutputStream, IMemoryStream, IStreamOnFileSystem>
+	{
+		private:
+			NativeFileStream m_File;
+			void* m_MappingHandle = nullptr;
+			void* m_View = nullptr;
+			size_t m_MappedSize = 0;
+			size_t m_DataSize = 0;
+			bool m_IsWritable = false;
+
+			MemoryStreamBuffer m_StreamBuffer;
+			StreamError m_LastError = StreamErrorCode::EndOfStream;
+			DataSize m_LastRead;
+			DataSize m_LastWrite;
+
+		private:
+			bool DoMap(size_t size);
+			void DoUnmap() noexcept;
+			bool DoClose();
+			void UpdateStreamBuffer(size_t offset) noexcept;
+			bool EnsureCapacity(size_t size);
+
+		public:
+			MappedFileStream() noexcept = default;
+			MappedFileStream(const FSPath& path,
+							 FlagSet<IOStreamAccess> access = IOStreamAccess::Read,
+							 IOStreamDisposition disposition = IOStreamDisposition::OpenExisting,
+							 FlagSet<IOStreamShare> share = IOStreamShare::Read
+			)
+			{
+				Open(path, access, disposition, share);
+			}
+			MappedFileStream(const MappedFileStream&) = delete;
+			~MappedFileStream()
+			{
+				DoClose();
+			}
+
+		public:
+			// IStream
+			void Close() override
+			{
+				DoClose();
+			}
+
+			StreamError GetLastError() const override
+			{
+				return m_LastError;
+			}
+			void SetLastError(StreamError lastError) override
+			{
+				m_LastError = std::move(lastError);
+			}
+
+			bool IsSeekable() const override
+			{
+				return true;
+			}
+			DataSize GetSize() const override
+			{
+				return m_DataSize;
+			}
+
+			// IInputStream
+			bool CanRead() const override
+			{
+				return !m_StreamBuffer.IsNull() && !m_StreamBuffer.IsEndOfStream();
+			}
+
+			DataSize LastRead() const override
+			{
+				return m_LastRead;
+			}
+			void SetLastRead(DataSize lastRead) override
+			{
+				m_LastRead = lastRead;
+			}
+
+			std::optional<uint8_t> Peek() override;
+			IInputStream& Read(void* buffer, size_t size) override;
+			using IInputStream::Read;
+
+			std::span<const std::byte> ReadView(size_t size) override;
+
+			DataSize TellI() const override
+			{
+				return m_StreamBuffer.Tell();
+			}
+			DataSize SeekI(DataSize offset, IOStreamSeek seek) override
+			{
+				return m_StreamBuffer.Seek(static_cast<intptr_t>(offset.ToBytes()), seek);
+			}
+
+			// IOutputStream
+			DataSize LastWrite() const override
+			{
+				return m_LastWrite;
+			}
+			void SetLastWrite(DataSize lastWrite) override
+			{
+				m_LastWrite = lastWrite;
+			}
+
+			IOutputStream& Write(const void* buffer, size_t size) override;
+			using IOutputStream::Write;
+
+			DataSize TellO() const override
+			{
+				return m_StreamBuffer.Tell();
+			}
+			DataSize SeekO(DataSize offset, IOStreamSeek seek) override
+			{
+				return m_StreamBuffer.Seek(static_cast<intptr_t>(offset.ToBytes()), seek);
+			}
+
+			bool Flush() override;
+			bool SetAllocationSize(DataSize allocationSize) override;
+
+			// IMemoryStream
+			MemoryStreamBuffer DetachStreamBuffer() override;
+			void AttachStreamBuffer(MemoryStreamBuffer streamBuffer) override
+			{
+				// The buffer is always a view of the mapped file, it can't be replaced
+				m_LastError = StreamErrorCode::ReadOnly;
+			}
+
+			MemoryStreamBuffer& GetStreamBuffer() override
+			{
+				return m_StreamBuffer;
+			}
+			const MemoryStreamBuffer& GetStreamBuffer() const override
+			{
+				return m_StreamBuffer;
+			}
+			size_t CopyToBuffer(void* buffer, size_t size) const override;
+
+			// IStreamOnFileSystem
+			FSPath GetFilePath() const override
+			{
+				return m_File.GetFilePath();
+			}
+			UniversallyUniqueID GetFileUniqueID() const override
+			{
+				return m_File.GetFileUniqueID();
+			}
+
+			// MappedFileStream
+			bool IsOpened() const noexcept
+			{
+				return m_File.GetHandle() != nullptr;
+			}
+			bool IsWritable() const noexcept
+			{
+				return m_IsWritable;
+			}
+			std::span<const std::byte> GetData() const noexcept
+			{
+				return {static_cast<const std::byte*>(m_View), m_DataSize};
+			}
+
+			bool Open(const FSPath& path,
+					  FlagSet<IOStreamAccess> access = IOStreamAccess::Read,
+					  IOStreamDisposition disposition = IOStreamDisposition::OpenExisting,
+					  FlagSet<IOStreamShare> share = IOStreamShare::Read
+			);
+
+		public:
+			explicit operator bool() const noexcept
+			{
+				return IsOpened();
+			}
+			bool operator!() const noexcept
+			{
+				return !IsOpened();
+			}
+
+			MappedFileStream& operator=(const MappedFileStream&) = delete;
+	};
+}
@@ -13,10 +13,59 @@ namespace kxf
 		:m_StreamBuffer(std::move(stream.GetStreamBuffer()))
 	{
 	}
+
+	// IInputStream
+	IInputStream& MemoryInputStream::ReadV(std::span<const std::span<std::byte>> buffers) noexcept
+	{
+		size_t readTotal = 0;
+		for (const auto& buffer: buffers)
+		{
+			const size_t read = m_StreamBuffer.Read(buffer.data(), buffer.size());
+			readTotal += read;
+
+			if (read != buffer.size())
+			{
+				break;
+			}
+		}
+		m_LastRead = readTotal;
+
+		return *this;
+	}
 }
 
 namespace kxf
 {
+	// IOutputStream
+	IOutputStream& MemoryOutputStream::WriteV(std::span<const std::span<const std::byte>> buffers)
+	{
+		// Grow the storage once for all of the buffers
+		size_t totalSize = 0;
+		for (const auto& buffer: buffers)
+		{
+			totalSize += buffer.size();
+		}
+		if (m_StreamBuffer.Tell() + totalSize > m_StreamBuffer.GetBufferSize())
+		{
+			m_StreamBuffer.ReserveStorage(m_StreamBuffer.Tell() + totalSize);
+		}
+
+		size_t writtenTotal = 0;
+		for (const auto& buffer: buffers)
+		{
+			const size_t written = m_StreamBuffer.Write(buffer.data(), buffer.size());
+			writtenTotal += written;
+
+			if (written != buffer.size())
+			{
+				break;
+			}
+		}
+		m_LastWrite = writtenTotal;
+
+		return *this;
+	}
+
 	// IReadableOutputStream
 	std::unique_ptr<IInputStream> MemoryOutputStream::CreateInputStream() const
 	{
@@ -118,8 +118,17 @@ namespace kxf
 				m_LastRead = m_StreamBuffer.Read(buffer, size);
 				return *this;
 			}
+			IInputStream& ReadV(std::span<const std::span<std::byte>> buffers) noexcept override;
 			using IInputStream::Read;
 
+			std::span<const std::byte> ReadView(size_t size) noexcept override
+			{
+				auto view = m_StreamBuffer.ReadView(size);
+				m_LastRead = view.size();
+
+				return view;
+			}
+
 			DataSize TellI() const noexcept override
 			{
 				return m_StreamBuffer.Tell();
@@ -257,6 +266,7 @@ namespace kxf
 				m_LastWrite = m_StreamBuffer.Write(buffer, size);
 				return *this;
 			}
+			IOutputStream& WriteV(std::span<const std::span<const std::byte>> buffers) override;
 			using IOutputStream::Write;
 
 			DataSize TellO() const noexcept override
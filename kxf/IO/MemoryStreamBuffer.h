@@ -161,6 +161,18 @@ namespace kxf
 
 			size_t Read(void* buffer, size_t size) noexcept;
 			size_t Read(MemoryStreamBuffer& other);
+			std::span<const std::byte> ReadView(size_t size) noexcept
+			{
+				if (m_BufferCurrent)
+				{
+					const size_t bytesToRead = std::min(size, GetBytesLeft());
+					std::span<const std::byte> view = {reinterpret_cast<const std::byte*>(m_BufferCurrent), bytesToRead};
+					m_BufferCurrent += bytesToRead;
+
+					return view;
+				}
+				return {};
+			}
 
 			size_t Write(const void* buffer, size_t size) noexcept;
 			size_t Write(MemoryStreamBuffer& other);
@@ -9,6 +9,22 @@ namespace
 {
 	using namespace kxf;
 
+	// Small buffers of vectored operations are combined into a single 'ReadFile'/'WriteFile' call through this staging buffer
+	constexpr size_t g_VectoredBufferSize = DataSize::FromKB(64).ToBytes();
+
+	template<class T>
+	size_t GetCoalescedCount(std::span<const std::span<T>> buffers, size_t& totalSize) noexcept
+	{
+		size_t count = 0;
+		totalSize = 0;
+		while (count < buffers.size() && totalSize + buffers[count].size() <= g_VectoredBufferSize)
+		{
+			totalSize += buffers[count].size();
+			count++;
+		}
+		return count;
+	}
+
 	int64_t SeekByHandle(HANDLE handle, DataSize offset, IOStreamSeek seekMode) noexcept
 	{
 		DWORD seekModeWin = std::numeric_limits<DWORD>::max();
@@ -233,6 +249,56 @@ namespace kxf
 		}
 		return *this;
 	}
+	IInputStream& NativeFileStream::ReadV(std::span<const std::span<std::byte>> buffers)
+	{
+		// 'ReadFileScatter' is no help here, it requires unbuffered I/O and page-sized buffers
+		std::byte staging[g_VectoredBufferSize];
+		DataSize readTotal = 0;
+
+		while (!buffers.empty())
+		{
+			size_t stagingSize = 0;
+			const size_t count = GetCoalescedCount(buffers, stagingSize);
+			if (count <= 1)
+			{
+				// Single or large buffer, read it directly
+				const auto& buffer = buffers.front();
+				if (!buffer.empty())
+				{
+					Read(buffer.data(), buffer.size());
+					readTotal += m_LastRead;
+
+					if (m_LastRead.ToBytes<size_t>() != buffer.size())
+					{
+						break;
+					}
+				}
+				buffers = buffers.subspan(1);
+			}
+			else
+			{
+				Read(staging, stagingSize);
+				readTotal += m_LastRead;
+
+				size_t read = m_LastRead.ToBytes<size_t>();
+				for (size_t offset = 0; const auto& buffer: buffers.first(count))
+				{
+					const size_t chunk = std::min(buffer.size(), read - offset);
+					std::memcpy(buffer.data(), staging + offset, chunk);
+					offset += chunk;
+				}
+
+				if (read != stagingSize)
+				{
+					break;
+				}
+				buffers = buffers.subspan(count);
+			}
+		}
+		m_LastRead = readTotal;
+
+		return *this;
+	}
 
 	DataSize NativeFileStream::TellI() const
 	{
@@ -269,6 +335,54 @@ namespace kxf
 		}
 		return *this;
 	}
+	IOutputStream& NativeFileStream::WriteV(std::span<const std::span<const std::byte>> buffers)
+	{
+		// See 'ReadV' for why 'WriteFileGather' isn't used
+		std::byte staging[g_VectoredBufferSize];
+		DataSize writtenTotal = 0;
+
+		while (!buffers.empty())
+		{
+			size_t stagingSize = 0;
+			const size_t count = GetCoalescedCount(buffers, stagingSize);
+			if (count <= 1)
+			{
+				const auto& buffer = buffers.front();
+				if (!buffer.empty())
+				{
+					Write(buffer.data(), buffer.size());
+					writtenTotal += m_LastWrite;
+
+					if (m_LastWrite.ToBytes<size_t>() != buffer.size())
+					{
+						break;
+					}
+				}
+				buffers = buffers.subspan(1);
+			}
+			else
+			{
+				size_t offset = 0;
+				for (const auto& buffer: buffers.first(count))
+				{
+					std::memcpy(staging + offset, buffer.data(), buffer.size());
+					offset += buffer.size();
+				}
+
+				Write(staging, stagingSize);
+				writtenTotal += m_LastWrite;
+
+				if (m_LastWrite.ToBytes<size_t>() != stagingSize)
+				{
+					break;
+				}
+				buffers = buffers.subspan(count);
+			}
+		}
+		m_LastWrite = writtenTotal;
+
+		return *this;
+	}
 	DataSize NativeFileStream::TellO() const
 	{
 		return GetOffsetByHandle(m_Handle);
@@ -78,6 +78,7 @@ namespace kxf
 			
 			std::optional<uint8_t> Peek() override;
 			IInputStream& Read(void* buffer, size_t size) override;
+			IInputStream& ReadV(std::span<const std::span<std::byte>> buffers) override;
 			using IInputStream::Read;
 
 			DataSize TellI() const override;
@@ -94,6 +95,7 @@ namespace kxf
 			}
 			
 			IOutputStream& Write(const void* buffer, size_t size) override;
+			IOutputStream& WriteV(std::span<const std::span<const std::byte>> buffers) override;
 			using IOutputStream::Write;
 
 			DataSize TellO() const override;
@@ -0,0 +1,509 @@
+#include "KxfPCH.h"
+#include "Pipeline.h"
+#include "kxf/Core/IAsyncTask.h"
+#include "kxf/Threading/IThreadPool.h"
+#include "kxf/Threading/SPSCQueue.h"
+#include <thread>
+
+namespace
+{
+	using namespace kxf;
+	using Clock = std::chrono::steady_clock;
+
+	TimeSpan ToTimeSpan(Clock::duration duration) noexcept
+	{
+		return TimeSpan::Milliseconds(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+	}
+
+	struct Block final
+	{
+		std::vector<uint8_t> Buffer;
+		size_t Size = 0;
+	};
+
+	// Blocks go from the producer to the consumer through 'Filled' and are given back through 'Free'
+	class Link final
+	{
+		private:
+			std::vector<Block> m_Blocks;
+
+		public:
+			SPSCQueue<Block*> Filled;
+			SPSCQueue<Block*> Free;
+
+		public:
+			Link(size_t blockSize, size_t depth)
+				:m_Blocks(depth), Filled(depth), Free(depth)
+			{
+				for (Block& block: m_Blocks)
+				{
+					block.Buffer.resize(blockSize);
+					Free.TryPush(&block);
+				}
+			}
+
+		public:
+			void Close() noexcept
+			{
+				Filled.Close();
+				Free.Close();
+			}
+	};
+
+	Block* PopBlock(SPSCQueue<Block*>& queue, Clock::duration& stallTime)
+	{
+		Block* block = nullptr;
+		if (queue.TryPop(block))
+		{
+			return block;
+		}
+
+		const auto start = Clock::now();
+		const bool result = queue.Pop(block);
+		stallTime += Clock::now() - start;
+
+		return result ? block : nullptr;
+	}
+	std::span<const std::byte> GetBlockData(const Block& block) noexcept
+	{
+		return {reinterpret_cast<const std::byte*>(block.Buffer.data()), block.Size};
+	}
+
+	// Output of a stage, cuts whatever is written into blocks and passes them to the next stage
+	class LinkOutputStream final: public IOutputStream
+	{
+		private:
+			Link& m_Link;
+			Clock::duration& m_StallTime;
+			Block* m_Block = nullptr;
+
+			DataSize m_TotalWrite = 0;
+			DataSize m_LastWrite;
+			StreamError m_LastError = StreamErrorCode::Success;
+
+		private:
+			bool SubmitBlock()
+			{
+				// An empty block stays with us, giving it back to the free queue is the consumer's job
+				if (m_Block && m_Block->Size != 0)
+				{
+					if (!m_Link.Filled.TryPush(std::exchange(m_Block, nullptr)))
+					{
+						m_LastError = StreamErrorCode::WriteError;
+						return false;
+					}
+				}
+				return true;
+			}
+
+		public:
+			LinkOutputStream(Link& link, Clock::duration& stallTime) noexcept
+				:m_Link(link), m_StallTime(stallTime)
+			{
+			}
+
+		public:
+			// IStream
+			void Close() override
+			{
+				SubmitBlock();
+			}
+
+			StreamError GetLastError() const override
+			{
+				return m_LastError;
+			}
+			void SetLastError(StreamError lastError) override
+			{
+				m_LastError = std::move(lastError);
+			}
+
+			bool IsSeekable() const override
+			{
+				return false;
+			}
+			DataSize GetSize() const override
+			{
+				return m_TotalWrite;
+			}
+
+			// IOutputStream
+			DataSize LastWrite() const override
+			{
+				return m_LastWrite;
+			}
+			void SetLastWrite(DataSize lastWrite) override
+			{
+				m_LastWrite = lastWrite;
+			}
+
+			IOutputStream& Write(const void* buffer, size_t size) override
+			{
+				auto data = static_cast<const uint8_t*>(buffer);
+				size_t written = 0;
+
+				while (written != size)
+				{
+					if (!m_Block)
+					{
+						m_Block = PopBlock(m_Link.Free, m_StallTime);
+						if (!m_Block)
+						{
+							m_LastError = StreamErrorCode::WriteError;
+							break;
+						}
+						m_Block->Size = 0;
+					}
+
+					const size_t count = std::min(size - written, m_Block->Buffer.size() - m_Block->Size);
+					std::memcpy(m_Block->Buffer.data() + m_Block->Size, data + written, count);
+					m_Block->Size += count;
+					written += count;
+
+					if (m_Block->Size == m_Block->Buffer.size() && !SubmitBlock())
+					{
+						break;
+					}
+				}
+
+				m_TotalWrite += written;
+				m_LastWrite = written;
+				if (written == size)
+				{
+					m_LastError = StreamErrorCode::Success;
+				}
+				return *this;
+			}
+
+			DataSize TellO() const override
+			{
+				return m_TotalWrite;
+			}
+			DataSize SeekO(DataSize offset, IOStreamSeek seek) override
+			{
+				return {};
+			}
+
+			bool Flush() override
+			{
+				return SubmitBlock();
+			}
+			bool SetAllocationSize(DataSize allocationSize) override
+			{
+				return false;
+			}
+	};
+
+	class TransformStage final: public IO::IPipelineStage
+	{
+		private:
+			String m_Name;
+			std::move_only_function<std::unique_ptr<IOutputStream>(IOutputStream&)> m_Func;
+			std::unique_ptr<IOutputStream> m_Stream;
+
+		private:
+			bool CreateStream(IOutputStream& output)
+			{
+				if (!m_Stream)
+				{
+					m_Stream = std::invoke(m_Func, output);
+				}
+				return m_Stream != nullptr;
+			}
+
+		public:
+			TransformStage(String name, std::move_only_function<std::unique_ptr<IOutputStream>(IOutputStream&)> func)
+				:m_Name(std::move(name)), m_Func(std::move(func))
+			{
+			}
+
+		public:
+			String GetName() const override
+			{
+				return m_Name;
+			}
+			bool Process(std::span<const std::byte> data, IOutputStream& output) override
+			{
+				return CreateStream(output) && m_Stream->WriteAll(data.data(), data.size());
+			}
+			bool Finish(IOutputStream& output) override
+			{
+				// Still create the stream for an empty input so it can write its header and footer
+				if (CreateStream(output))
+				{
+					// Adapters usually write their footer when they're destroyed and have no way to report it failing,
+					// so check the output for errors afterwards as well.
+					const bool isFlushed = m_Stream->Flush();
+					m_Stream = nullptr;
+
+					return isFlushed && output.GetLastError().IsSuccess();
+				}
+				return false;
+			}
+			void Reset() override
+			{
+				m_Stream = nullptr;
+			}
+	};
+
+	class ObserverStage final: public IO::IPipelineStage
+	{
+		private:
+			String m_Name;
+			std::move_only_function<void(std::span<const std::byte>)> m_Func;
+
+		public:
+			ObserverStage(String name, std::move_only_function<void(std::span<const std::byte>)> func)
+				:m_Name(std::move(name)), m_Func(std::move(func))
+			{
+			}
+
+		public:
+			String GetName() const override
+			{
+				return m_Name;
+			}
+			bool Process(std::span<const std::byte> data, IOutputStream& output) override
+			{
+				std::invoke(m_Func, data);
+				return output.WriteAll(data.data(), data.size());
+			}
+			bool Finish(IOutputStream& output) override
+			{
+				return true;
+			}
+	};
+}
+
+namespace kxf::IO
+{
+	struct Pipeline::Context final
+	{
+		std::vector<std::unique_ptr<Link>> Links;
+		std::atomic<bool> Failed = false;
+
+		Context(size_t linkCount, size_t blockSize, size_t queueDepth)
+		{
+			Links.reserve(linkCount);
+			for (size_t i = 0; i < linkCount; i++)
+			{
+				Links.emplace_back(std::make_unique<Link>(blockSize, queueDepth));
+			}
+		}
+
+		bool IsFailed() const noexcept
+		{
+			return Failed.load(std::memory_order_acquire);
+		}
+		void Abort() noexcept
+		{
+			// Wake up everyone waiting on the queues so they can see the failure
+			Failed.store(true, std::memory_order_release);
+			for (auto& link: Links)
+			{
+				link->Close();
+			}
+		}
+	};
+
+	void Pipeline::RunReader(Context& context)
+	{
+		auto& report = m_Report.front();
+		Link& output = *context.Links.front();
+
+		Clock::duration stallTime = {};
+		const auto startTime = Clock::now();
+
+		bool result = true;
+		while (!context.IsFailed())
+		{
+			Block* block = PopBlock(output.Free, stallTime);
+			if (!block)
+			{
+				result = false;
+				break;
+			}
+
+			const DataSize read = m_Source.Read(block->Buffer.data(), block->Buffer.size()).LastRead();
+			block->Size = read.IsValid() ? read.ToBytes<size_t>() : 0;
+			if (block->Size == 0)
+			{
+				// Nothing read is the end of the input unless the source has actually failed
+				const StreamError error = m_Source.GetLastError();
+				result = error.IsSuccess() || error == StreamErrorCode::EndOfStream;
+				break;
+			}
+			report.BytesIn += block->Size;
+			report.BytesOut += block->Size;
+
+			if (!output.Filled.TryPush(block))
+			{
+				result = false;
+				break;
+			}
+		}
+		output.Filled.Close();
+
+		report.StallTime = ToTimeSpan(stallTime);
+		report.BusyTime = ToTimeSpan(Clock::now() - startTime - stallTime);
+		if (!result)
+		{
+			context.Abort();
+		}
+	}
+	void Pipeline::RunStage(Context& context, size_t index)
+	{
+		auto& report = m_Report[index + 1];
+		auto& stage = *m_Stages[index];
+		Link& input = *context.Links[index];
+		Link& output = *context.Links[index + 1];
+
+		Clock::duration stallTime = {};
+		const auto startTime = Clock::now();
+		LinkOutputStream stream(output, stallTime);
+
+		bool result = true;
+		while (result && !context.IsFailed())
+		{
+			Block* block = PopBlock(input.Filled, stallTime);
+			if (!block)
+			{
+				break;
+			}
+			report.BytesIn += block->Size;
+
+			result = stage.Process(GetBlockData(*block), stream);
+			input.Free.TryPush(block);
+		}
+		result = result && !context.IsFailed() && stage.Finish(stream) && stream.Flush();
+		output.Filled.Close();
+
+		report.BytesOut = stream.TellO();
+		report.StallTime = ToTimeSpan(stallTime);
+		report.BusyTime = ToTimeSpan(Clock::now() - startTime - stallTime);
+		if (!result)
+		{
+			context.Abort();
+		}
+
+		// A failed stage skips 'Finish', don't let it keep anything referring to our output stream
+		stage.Reset();
+	}
+	void Pipeline::RunWriter(Context& context)
+	{
+		auto& report = m_Report.back();
+		Link& input = *context.Links.back();
+
+		Clock::duration stallTime = {};
+		const auto startTime = Clock::now();
+
+		bool result = true;
+		while (!context.IsFailed())
+		{
+			Block* block = PopBlock(input.Filled, stallTime);
+			if (!block)
+			{
+				break;
+			}
+			report.BytesIn += block->Size;
+
+			if (!m_Target.WriteAll(block->Buffer.data(), block->Size))
+			{
+				result = false;
+				break;
+			}
+			report.BytesOut += block->Size;
+			input.Free.TryPush(block);
+		}
+
+		report.StallTime = ToTimeSpan(stallTime);
+		report.BusyTime = ToTimeSpan(Clock::now() - startTime - stallTime);
+		if (!result)
+		{
+			context.Abort();
+		}
+	}
+
+	Pipeline::Pipeline(IInputStream& source, IOutputStream& target, size_t blockSize, size_t queueDepth)
+		:m_Source(source), m_Target(target), m_BlockSize(std::max<size_t>(blockSize, 1)), m_QueueDepth(std::max<size_t>(queueDepth, 1))
+	{
+	}
+	Pipeline::~Pipeline() = default;
+
+	Pipeline& Pipeline::AddStage(std::unique_ptr<IPipelineStage> stage)
+	{
+		if (stage)
+		{
+			m_Stages.emplace_back(std::move(stage));
+		}
+		return *this;
+	}
+	Pipeline& Pipeline::AddTransform(String name, std::move_only_function<std::unique_ptr<IOutputStream>(IOutputStream& output)> func)
+	{
+		return AddStage(std::make_unique<TransformStage>(std::move(name), std::move(func)));
+	}
+	Pipeline& Pipeline::AddObserver(String name, std::move_only_function<void(std::span<const std::byte> data)> func)
+	{
+		return AddStage(std::make_unique<ObserverStage>(std::move(name), std::move(func)));
+	}
+
+	bool Pipeline::Run(IThreadPool* threadPool)
+	{
+		m_Report.clear();
+		m_Report.resize(m_Stages.size() + 2);
+		m_Report.front().Name = "Read";
+		m_Report.back().Name = "Write";
+		for (size_t i = 0; i < m_Stages.size(); i++)
+		{
+			m_Report[i + 1].Name = m_Stages[i]->GetName();
+		}
+
+		Context context(m_Stages.size() + 1, m_BlockSize, m_QueueDepth);
+		std::vector<std::shared_ptr<IAsyncTask>> tasks;
+		std::vector<std::thread> threads;
+
+		// Every task blocks for the whole run, a pool which isn't running or can't run all of them at once would hang it
+		const size_t taskCount = m_Stages.size() + 1;
+		if (threadPool && (!threadPool->IsRunning() || threadPool->GetConcurrency() < taskCount))
+		{
+			threadPool = nullptr;
+		}
+
+		auto Start = [&](auto func)
+		{
+			if (threadPool)
+			{
+				if (auto task = threadPool->AddTask(func))
+				{
+					tasks.emplace_back(std::move(task));
+					return;
+				}
+			}
+
+			// No pool or it refused the task, every stage must run for the pipeline to make progress
+			threads.emplace_back(std::move(func));
+		};
+		Start([&]()
+		{
+			RunReader(context);
+		});
+		for (size_t i = 0; i < m_Stages.size(); i++)
+		{
+			Start([&, i]()
+			{
+				RunStage(context, i);
+			});
+		}
+		RunWriter(context);
+
+		for (auto& task: tasks)
+		{
+			task->WaitCompletion();
+		}
+		for (auto& thread: threads)
+		{
+			thread.join();
+		}
+		return !context.IsFailed();
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "Common.h"
+#include "IStream.h"
+#include "kxf/Core/DateTime/TimeSpan.h"
+
+namespace kxf
+{
+	class IThreadPool;
+}
+
+namespace kxf::IO
+{
+	class KX_API IPipelineStage
+	{
+		public:
+			virtual ~IPipelineStage() = default;
+
+		public:
+			virtual String GetName() const = 0;
+
+			// Transforms a block of data and writes the result into 'output' which passes it to the next stage
+			virtual bool Process(std::span<const std::byte> data, IOutputStream& output) = 0;
+
+			// Called once after the last block to write out whatever the stage still holds
+			virtual bool Finish(IOutputStream& output) = 0;
+
+			// Called at the end of every run, successful or not, after which 'output' is no longer valid.
+			// The stage should drop anything it still holds so the pipeline can be run again.
+			virtual void Reset()
+			{
+			}
+	};
+
+	struct PipelineStageReport final
+	{
+		String Name;
+		DataSize BytesIn = 0;
+		DataSize BytesOut = 0;
+
+		// Time spent doing the actual work and time spent waiting on the neighbouring stages
+		TimeSpan BusyTime;
+		TimeSpan StallTime;
+
+		// Bytes per second of busy time
+		DataSize GetThroughput() const noexcept
+		{
+			if (BusyTime.GetMilliseconds() > 0)
+			{
+				return BytesIn.ToBytes() * 1000 / BusyTime.GetMilliseconds();
+			}
+			return {};
+		}
+	};
+}
+
+namespace kxf::IO
+{
+	// Copies the source stream into the target one through a chain of transform stages, all of them running concurrently.
+	// Stages are connected with bounded queues of fixed-size blocks, so a slow stage stalls the ones before it instead
+	// of letting the data pile up in memory.
+	class KX_API Pipeline final
+	{
+		public:
+			static constexpr size_t DefaultBlockSize = 1024 * 1024;
+			static constexpr size_t DefaultQueueDepth = 4;
+
+		private:
+			struct Context;
+
+		private:
+			IInputStream& m_Source;
+			IOutputStream& m_Target;
+			size_t m_BlockSize = 0;
+			size_t m_QueueDepth = 0;
+
+			std::vector<std::unique_ptr<IPipelineStage>> m_Stages;
+			std::vector<PipelineStageReport> m_Report;
+
+		private:
+			void RunReader(Context& context);
+			void RunStage(Context& context, size_t index);
+			void RunWriter(Context& context);
+
+		public:
+			Pipeline(IInputStream& source, IOutputStream& target, size_t blockSize = DefaultBlockSize, size_t queueDepth = DefaultQueueDepth);
+			Pipeline(const Pipeline&) = delete;
+			~Pipeline();
+
+		public:
+			Pipeline& AddStage(std::unique_ptr<IPipelineStage> stage);
+
+			// Adds a stage from a stream adapter, for example 'LZ4OutputStream' or 'ZLibOutputStream'. The function creates
+			// the adapter on top of the stage output, the adapter is destroyed after the last block to let it finish its output.
+			Pipeline& AddTransform(String name, std::move_only_function<std::unique_ptr<IOutputStream>(IOutputStream& output)> func);
+
+			// Adds a stage which passes the data through unchanged after showing it to the function
+			Pipeline& AddObserver(String name, std::move_only_function<void(std::span<const std::byte> data)> func);
+
+			// Runs the pipeline and returns when the target stream received all the data or any stage failed. The reader and every
+			// stage need a thread of their own for the whole run: they are taken from the thread pool if it's running and its
+			// concurrency is enough to run all of them at once, otherwise they're created for the run. The writer runs on the calling thread.
+			bool Run(IThreadPool* threadPool = nullptr);
+
+			// Reader, stages and the writer in that order
+			const std::vector<PipelineStageReport>& GetReport() const noexcept
+			{
+				return m_Report;
+			}
+
+		public:
+			Pipeline& operator=(const Pipeline&) = delete;
+	};
+}
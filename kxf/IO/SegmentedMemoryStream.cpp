@@ -0,0 +1,312 @@
+#include "KxfPCH.h"
+#include "SegmentedMemoryStream.h"
+#include "kxf/Core/StandardAllocator.h"
+#include "kxf/Threading/LockGuard.h"
+
+namespace kxf
+{
+	std::shared_ptr<MemoryChunkPool> MemoryChunkPool::GetDefault()
+	{
+		static auto pool = std::make_shared<MemoryChunkPool>();
+		return pool;
+	}
+
+	MemoryChunkPool::MemoryChunkPool(size_t chunkSize, size_t maxFreeChunks)
+		:MemoryChunkPool(DefaultMemoryAllocator, chunkSize, maxFreeChunks)
+	{
+	}
+	MemoryChunkPool::MemoryChunkPool(IMemoryAllocator& allocator, size_t chunkSize, size_t maxFreeChunks)
+		:m_Allocator(allocator), m_ChunkSize(std::max<size_t>(chunkSize, 1)), m_MaxFreeChunks(maxFreeChunks)
+	{
+	}
+	MemoryChunkPool::~MemoryChunkPool()
+	{
+		Trim();
+	}
+
+	void* MemoryChunkPool::AcquireChunk()
+	{
+		if (WriteLockGuard lock(m_Lock); !m_FreeChunks.empty())
+		{
+			void* chunk = m_FreeChunks.back();
+			m_FreeChunks.pop_back();
+
+			return chunk;
+		}
+		return m_Allocator.Allocate(m_ChunkSize);
+	}
+	void MemoryChunkPool::ReleaseChunk(void* chunk) noexcept
+	{
+		if (chunk)
+		{
+			if (WriteLockGuard lock(m_Lock); m_FreeChunks.size() < m_MaxFreeChunks)
+			{
+				m_FreeChunks.push_back(chunk);
+				return;
+			}
+			m_Allocator.Free(chunk);
+		}
+	}
+	void MemoryChunkPool::Trim() noexcept
+	{
+		WriteLockGuard lock(m_Lock);
+		for (void* chunk: m_FreeChunks)
+		{
+			m_Allocator.Free(chunk);
+		}
+		m_FreeChunks.clear();
+	}
+}
+
+namespace kxf
+{
+	bool SegmentedMemoryStream::EnsureCapacity(size_t size)
+	{
+		while (GetCapacity() < size)
+		{
+			if (void* chunk = m_Pool->AcquireChunk())
+			{
+				m_Chunks.push_back(chunk);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	bool SegmentedMemoryStream::DoResize(size_t size)
+	{
+		if (size > m_Size)
+		{
+			if (!EnsureCapacity(size))
+			{
+				return false;
+			}
+
+			// Chunks come from the pool as is, so zero the gap between the old and the new end
+			for (size_t offset = m_Size; offset != size;)
+			{
+				const size_t count = std::min(size - offset, m_ChunkSize - offset % m_ChunkSize);
+				std::memset(GetChunkData(offset), 0, count);
+				offset += count;
+			}
+		}
+		m_Size = size;
+
+		return true;
+	}
+	size_t SegmentedMemoryStream::DoCopy(size_t offset, void* buffer, size_t size) const noexcept
+	{
+		auto data = static_cast<uint8_t*>(buffer);
+		size = std::min(size, m_Size - std::min(offset, m_Size));
+
+		for (size_t copied = 0; copied != size;)
+		{
+			const size_t count = std::min(size - copied, m_ChunkSize - (offset + copied) % m_ChunkSize);
+			std::memcpy(data + copied, GetChunkData(offset + copied), count);
+			copied += count;
+		}
+		return size;
+	}
+	void SegmentedMemoryStream::DoClear() noexcept
+	{
+		if (m_Pool)
+		{
+			for (void* chunk: m_Chunks)
+			{
+				m_Pool->ReleaseChunk(chunk);
+			}
+		}
+		m_Chunks.clear();
+		m_Size = 0;
+		m_Position = 0;
+		m_LastRead = {};
+		m_LastWrite = {};
+	}
+
+	SegmentedMemoryStream::SegmentedMemoryStream(std::shared_ptr<MemoryChunkPool> pool)
+		:m_Pool(std::move(pool))
+	{
+		if (!m_Pool)
+		{
+			m_Pool = MemoryChunkPool::GetDefault();
+		}
+		m_ChunkSize = m_Pool->GetChunkSize();
+	}
+
+	// IInputStream
+	std::optional<uint8_t> SegmentedMemoryStream::Peek()
+	{
+		if (m_Position < m_Size)
+		{
+			return *GetChunkData(m_Position);
+		}
+		return {};
+	}
+	IInputStream& SegmentedMemoryStream::Read(void* buffer, size_t size)
+	{
+		const size_t read = DoCopy(m_Position, buffer, size);
+		m_Position += read;
+
+		m_LastRead = read;
+		m_LastError = m_Position == m_Size ? StreamErrorCode::EndOfStream : StreamErrorCode::Success;
+		return *this;
+	}
+	IInputStream& SegmentedMemoryStream::Read(IOutputStream& other)
+	{
+		// Pass all the remaining chunks to the other stream in a single vectored write
+		std::vector<std::span<const std::byte>> buffers;
+		buffers.reserve(GetChunkCount() - m_Position / m_ChunkSize);
+		for (size_t offset = m_Position; offset != m_Size;)
+		{
+			const size_t count = std::min(m_Size - offset, m_ChunkSize - offset % m_ChunkSize);
+			buffers.emplace_back(reinterpret_cast<const std::byte*>(GetChunkData(offset)), count);
+			offset += count;
+		}
+
+		const DataSize written = other.WriteV(buffers).LastWrite();
+		const size_t writtenBytes = written.IsValid() ? written.ToBytes<size_t>() : 0;
+		m_Position += writtenBytes;
+
+		m_LastRead = writtenBytes;
+		m_LastError = m_Position == m_Size ? StreamErrorCode::EndOfStream : StreamErrorCode::Success;
+		return *this;
+	}
+	std::span<const std::byte> SegmentedMemoryStream::ReadView(size_t size)
+	{
+		// Only ranges which don't cross a chunk boundary can be viewed directly
+		const size_t count = std::min(size, m_Size - m_Position);
+		if (count != 0 && m_Position % m_ChunkSize + count <= m_ChunkSize)
+		{
+			std::span<const std::byte> view = {reinterpret_cast<const std::byte*>(GetChunkData(m_Position)), count};
+			m_Position += count;
+
+			m_LastRead = count;
+			m_LastError = m_Position == m_Size ? StreamErrorCode::EndOfStream : StreamErrorCode::Success;
+			return view;
+		}
+		return {};
+	}
+
+	DataSize SegmentedMemoryStream::SeekI(DataSize offset, IOStreamSeek seek)
+	{
+		int64_t position = -1;
+		switch (seek)
+		{
+			case IOStreamSeek::FromStart:
+			{
+				position = offset.ToBytes();
+				break;
+			}
+			case IOStreamSeek::FromCurrent:
+			{
+				position = static_cast<int64_t>(m_Position) + offset.ToBytes();
+				break;
+			}
+			case IOStreamSeek::FromEnd:
+			{
+				position = static_cast<int64_t>(m_Size) + offset.ToBytes();
+				break;
+			}
+		};
+
+		if (position < 0)
+		{
+			m_LastError = StreamError::Fail();
+			return {};
+		}
+
+		// Seeking past the end extends the stream the same way 'MemoryStreamBuffer' does
+		if (static_cast<size_t>(position) > m_Size && !DoResize(static_cast<size_t>(position)))
+		{
+			position = static_cast<int64_t>(m_Size);
+		}
+		m_Position = static_cast<size_t>(position);
+
+		return m_Position;
+	}
+
+	// IOutputStream
+	IOutputStream& SegmentedMemoryStream::Write(const void* buffer, size_t size)
+	{
+		m_LastWrite = {};
+		if (!EnsureCapacity(m_Position + size))
+		{
+			m_LastError = StreamErrorCode::WriteError;
+			return *this;
+		}
+
+		auto data = static_cast<const uint8_t*>(buffer);
+		for (size_t written = 0; written != size;)
+		{
+			const size_t count = std::min(size - written, m_ChunkSize - m_Position % m_ChunkSize);
+			std::memcpy(GetChunkData(m_Position), data + written, count);
+
+			m_Position += count;
+			written += count;
+		}
+		m_Size = std::max(m_Size, m_Position);
+
+		m_LastWrite = size;
+		m_LastError = StreamErrorCode::Success;
+		return *this;
+	}
+
+	bool SegmentedMemoryStream::SetAllocationSize(DataSize allocationSize)
+	{
+		return allocationSize.IsValid() && EnsureCapacity(allocationSize.ToBytes<size_t>());
+	}
+
+	// SegmentedMemoryStream
+	std::span<const std::byte> SegmentedMemoryStream::GetChunk(size_t index) const noexcept
+	{
+		const size_t offset = index * m_ChunkSize;
+		if (offset < m_Size)
+		{
+			return {static_cast<const std::byte*>(m_Chunks[index]), std::min(m_ChunkSize, m_Size - offset)};
+		}
+		return {};
+	}
+	CallbackResult SegmentedMemoryStream::EnumChunks(CallbackFunction<std::span<const std::byte>> func) const
+	{
+		const size_t count = GetChunkCount();
+		for (size_t i = 0; i < count; i++)
+		{
+			if (func.Invoke(GetChunk(i)).ShouldTerminate())
+			{
+				break;
+			}
+		}
+		return func.GetResult();
+	}
+	MemoryStreamBuffer SegmentedMemoryStream::Flatten() const
+	{
+		MemoryStreamBuffer streamBuffer;
+		streamBuffer.CreateStorage(m_Size);
+		DoCopy(0, streamBuffer.GetBufferStart(), m_Size);
+
+		return streamBuffer;
+	}
+
+	SegmentedMemoryStream& SegmentedMemoryStream::operator=(SegmentedMemoryStream&& other) noexcept
+	{
+		if (this != &other)
+		{
+			DoClear();
+
+			// The moved-from stream keeps its pool so it stays usable
+			m_Pool = other.m_Pool;
+			m_ChunkSize = other.m_ChunkSize;
+			m_Chunks = std::move(other.m_Chunks);
+			m_Size = std::exchange(other.m_Size, 0);
+			m_Position = std::exchange(other.m_Position, 0);
+
+			m_LastError = std::move(other.m_LastError);
+			m_LastRead = std::exchange(other.m_LastRead, {});
+			m_LastWrite = std::exchange(other.m_LastWrite, {});
+			other.m_Chunks.clear();
+		}
+		return *this;
+	}
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "Common.h"
+#include "IStream.h"
+#include "MemoryStreamBuffer.h"
+#include "kxf/Core/CallbackFunction.h"
+#include "kxf/Core/IMemoryAllocator.h"
+#include "kxf/Threading/ReadWriteLock.h"
+
+namespace kxf
+{
+	// Thread-safe pool of fixed-size memory chunks. Released chunks are kept for reuse up to the specified limit.
+	class KX_API MemoryChunkPool final
+	{
+		public:
+			static constexpr size_t DefaultChunkSize = 64 * 1024;
+			static constexpr size_t DefaultMaxFreeChunks = 256;
+
+		public:
+			static std::shared_ptr<MemoryChunkPool> GetDefault();
+
+		private:
+			IMemoryAllocator& m_Allocator;
+			size_t m_ChunkSize = 0;
+			size_t m_MaxFreeChunks = 0;
+
+			ReadWriteLock m_Lock;
+			std::vector<void*> m_FreeChunks;
+
+		public:
+			MemoryChunkPool(size_t chunkSize = DefaultChunkSize, size_t maxFreeChunks = DefaultMaxFreeChunks);
+			MemoryChunkPool(IMemoryAllocator& allocator, size_t chunkSize = DefaultChunkSize, size_t maxFreeChunks = DefaultMaxFreeChunks);
+			MemoryChunkPool(const MemoryChunkPool&) = delete;
+			~MemoryChunkPool();
+
+		public:
+			size_t GetChunkSize() const noexcept
+			{
+				return m_ChunkSize;
+			}
+
+			void* AcquireChunk();
+			void ReleaseChunk(void* chunk) noexcept;
+			void Trim() noexcept;
+
+		public:
+			MemoryChunkPool& operator=(const MemoryChunkPool&) = delete;
+	};
+}
+
+namespace kxf
+{
+	// Memory stream which keeps its data in a list of fixed-size chunks taken from a 'MemoryChunkPool' instead of a single
+	// contiguous buffer. Growing the stream never moves the data already written, use 'EnumChunks' to access the data
+	// without copying it or 'Flatten' to get a contiguous copy.
+	class KX_API SegmentedMemoryStream: public RTTI::Implementation<SegmentedMemoryStream, IInputStream, IOutputStream>
+	{
+		private:
+			std::shared_ptr<MemoryChunkPool> m_Pool;
+			std::vector<void*> m_Chunks;
+			size_t m_ChunkSize = 0;
+			size_t m_Size = 0;
+			size_t m_Position = 0;
+
+			StreamError m_LastError = StreamErrorCode::Success;
+			DataSize m_LastRead;
+			DataSize m_LastWrite;
+
+		private:
+			uint8_t* GetChunkData(size_t offset) const noexcept
+			{
+				return static_cast<uint8_t*>(m_Chunks[offset / m_ChunkSize]) + offset % m_ChunkSize;
+			}
+			size_t GetCapacity() const noexcept
+			{
+				return m_Chunks.size() * m_ChunkSize;
+			}
+
+			bool EnsureCapacity(size_t size);
+			bool DoResize(size_t size);
+			size_t DoCopy(size_t offset, void* buffer, size_t size) const noexcept;
+			void DoClear() noexcept;
+
+		public:
+			SegmentedMemoryStream()
+				:SegmentedMemoryStream(MemoryChunkPool::GetDefault())
+			{
+			}
+			SegmentedMemoryStream(std::shared_ptr<MemoryChunkPool> pool);
+			SegmentedMemoryStream(SegmentedMemoryStream&& other) noexcept
+			{
+				*this = std::move(other);
+			}
+			SegmentedMemoryStream(const SegmentedMemoryStream&) = delete;
+			~SegmentedMemoryStream()
+			{
+				DoClear();
+			}
+
+		public:
+			// IStream
+			void Close() override
+			{
+				DoClear();
+			}
+
+			StreamError GetLastError() const override
+			{
+				return m_LastError;
+			}
+			void SetLastError(StreamError lastError) override
+			{
+				m_LastError = std::move(lastError);
+			}
+
+			bool IsSeekable() const override
+			{
+				return true;
+			}
+			DataSize GetSize() const override
+			{
+				return m_Size;
+			}
+
+			// IInputStream
+			bool CanRead() const override
+			{
+				return m_Position < m_Size;
+			}
+
+			DataSize LastRead() const override
+			{
+				return m_LastRead;
+			}
+			void SetLastRead(DataSize lastRead) override
+			{
+				m_LastRead = lastRead;
+			}
+
+			std::optional<uint8_t> Peek() override;
+			IInputStream& Read(void* buffer, size_t size) override;
+			IInputStream& Read(IOutputStream& other) override;
+			using IInputStream::Read;
+
+			std::span<const std::byte> ReadView(size_t size) override;
+
+			DataSize TellI() const override
+			{
+				return m_Position;
+			}
+			DataSize SeekI(DataSize offset, IOStreamSeek seek) override;
+
+			// IOutputStream
+			DataSize LastWrite() const override
+			{
+				return m_LastWrite;
+			}
+			void SetLastWrite(DataSize lastWrite) override
+			{
+				m_LastWrite = lastWrite;
+			}
+
+			IOutputStream& Write(const void* buffer, size_t size) override;
+			using IOutputStream::Write;
+
+			DataSize TellO() const override
+			{
+				return m_Position;
+			}
+			DataSize SeekO(DataSize offset, IOStreamSeek seek) override
+			{
+				return SeekI(offset, seek);
+			}
+
+			bool Flush() override
+			{
+				return true;
+			}
+			bool SetAllocationSize(DataSize allocationSize) override;
+
+			// SegmentedMemoryStream
+			const std::shared_ptr<MemoryChunkPool>& GetPool() const noexcept
+			{
+				return m_Pool;
+			}
+			size_t GetChunkSize() const noexcept
+			{
+				return m_ChunkSize;
+			}
+			size_t GetChunkCount() const noexcept
+			{
+				return (m_Size + m_ChunkSize - 1) / m_ChunkSize;
+			}
+			std::span<const std::byte> GetChunk(size_t index) const noexcept;
+			CallbackResult EnumChunks(CallbackFunction<std::span<const std::byte>> func) const;
+
+			size_t CopyToBuffer(void* buffer, size_t size) const noexcept
+			{
+				return DoCopy(0, buffer, size);
+			}
+			MemoryStreamBuffer Flatten() const;
+
+		public:
+			SegmentedMemoryStream& operator=(SegmentedMemoryStream&& other) noexcept;
+			SegmentedMemoryStream& operator=(const SegmentedMemoryStream&) = delete;
+	};
+}
@@ -154,6 +154,15 @@ namespace kxf
 			{
 				return m_Stream->ReadAll(buffer, size);
 			}
+			IInputStream& ReadV(std::span<const std::span<std::byte>> buffers) override
+			{
+				m_Stream->ReadV(buffers);
+				return *this;
+			}
+			std::span<const std::byte> ReadView(size_t size) override
+			{
+				return m_Stream->ReadView(size);
+			}
 
 			DataSize TellI() const override
 			{
@@ -214,6 +223,11 @@ namespace kxf
 			{
 				return m_Stream->WriteAll(buffer, size);
 			}
+			IOutputStream& WriteV(std::span<const std::span<const std::byte>> buffers) override
+			{
+				m_Stream->WriteV(buffers);
+				return *this;
+			}
 
 			DataSize TellO() const override
 			{
@@ -7,6 +7,20 @@ namespace kxf
 {
 	bool IO::InputStreamReader::ReadStringASCII(String& value, size_t size)
 	{
+		if (auto view = m_Stream.ReadView(size); !view.empty())
+		{
+			if (view.size() == size)
+			{
+				std::string_view str(reinterpret_cast<const char*>(view.data()), view.size());
+				DoRemoveTrailingNulls(str);
+
+				value = String::FromASCII(str);
+				return true;
+			}
+			value.clear();
+			return false;
+		}
+
 		std::vector<char> buffer;
 		if (ReadVector(buffer, size))
 		{
@@ -22,6 +36,20 @@ namespace kxf
 	}
 	bool IO::InputStreamReader::ReadStringUTF8(String& value, size_t size)
 	{
+		if (auto view = m_Stream.ReadView(size); !view.empty())
+		{
+			if (view.size() == size)
+			{
+				std::string_view str(reinterpret_cast<const char*>(view.data()), view.size());
+				DoRemoveTrailingNulls(str);
+
+				value = String::FromUTF8(str);
+				return true;
+			}
+			value.clear();
+			return false;
+		}
+
 		std::vector<char> buffer;
 		if (ReadVector(buffer, size))
 		{
@@ -16,7 +16,14 @@ namespace kxf::IO
 			{
 				while (!data.empty() && data.back() == 0)
 				{
-					data.pop_back();
+					if constexpr(requires { data.remove_suffix(1); })
+					{
+						data.remove_suffix(1);
+					}
+					else
+					{
+						data.pop_back();
+					}
 				}
 			}
 			
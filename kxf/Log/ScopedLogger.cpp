@@ -1,6 +1,7 @@
 #include "KxfPCH.h"
 #include "ScopedLogger.h"
 #include "ScopedLoggerTarget.h"
+#include "ScopedLoggerAsync.h"
 #include "Private/WxOverride.h"
 #include "kxf/System/DynamicLibrary.h"
 
@@ -56,7 +57,43 @@ namespace kxf
 	{
 		return FormatLogLevel(value);
 	}
+}
+
+namespace kxf::Private
+{
+	String FormatScopedLoggerRecord(DateTime timestamp, const TimeZoneOffset& tzOffset, uint32_t processID, uint32_t threadID, bool isUnknownThread, LogLevel logLevel, size_t scopeLevel, StringView message, StringView category)
+	{
+		String buffer;
+		buffer.reserve(255);
+
+		// Log time
+		buffer.Format("[{}]", FormatTimestamp(timestamp, tzOffset));
+
+		// Log location
+		buffer.Format("[PID:{:0>6}|{}:{:0>6}]", processID, isUnknownThread ? "UNK" : "TID", threadID);
+
+		// Log message level
+		buffer.Format("[{:<11}]", FormatLogLevel(logLevel));
+
+		// Add indents
+		buffer.Append(' ', scopeLevel * 4);
+
+		// Add category if present
+		if (!category.empty())
+		{
+			buffer.Format(" <{}>", category);
+		}
+
+		// Log the actual message string
+		buffer += ' ';
+		buffer += message;
+
+		return buffer;
+	}
+}
 
+namespace kxf
+{
 	ScopedLoggerGlobalContext& ScopedLoggerGlobalContext::Initialize(std::shared_ptr<IScopedLoggerContext> userContext, LogLevel logLevel)
 	{
 		static ScopedLoggerGlobalContext globalContext(userContext, logLevel);
@@ -105,6 +142,7 @@ namespace kxf
 	}
 	void ScopedLoggerGlobalContext::Destroy()
 	{
+		DisableAsyncMode();
 		m_UnknownContextTLS.reset();
 		m_TLSIndex.Uninitialize();
 	}
@@ -166,6 +204,24 @@ namespace kxf
 			return ToInt(logLevel) <= ToInt(m_LogLevel.load());
 		}
 	}
+
+	void ScopedLoggerGlobalContext::EnableAsyncMode(const ScopedLoggerAsyncOptions& options)
+	{
+		DisableAsyncMode();
+
+		m_AsyncWriter = std::make_shared<Private::ScopedLoggerAsyncWriter>(options);
+		m_IsAsyncModeEnabled = true;
+	}
+	void ScopedLoggerGlobalContext::DisableAsyncMode()
+	{
+		m_IsAsyncModeEnabled = false;
+
+		// Writes everything that's still buffered, threads notice their buffers are detached and switch to synchronous mode
+		if (auto writer = m_AsyncWriter.exchange(nullptr))
+		{
+			writer->Stop();
+		}
+	}
 }
 
 namespace kxf
@@ -182,6 +238,7 @@ namespace kxf
 	void ScopedLoggerTLS::Destroy()
 	{
 		LogOpenClose(false);
+		DetachAsyncWriter();
 
 		if (auto logTarget = m_LogTarget.load())
 		{
@@ -237,39 +294,12 @@ namespace kxf
 			message.Write(*this);
 		}
 	}
-	String ScopedLoggerTLS::FormatRecord(LogLevel logLevel, DateTime timestamp, StringView message, StringView category) const
+	String ScopedLoggerTLS::FormatRecord(LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel) const
 	{
-		String buffer;
-		buffer.reserve(255);
-
-		// Log time
-		buffer.Format("[{}]", FormatTimestamp(timestamp, m_GlobalContext.GetTimeOffset()));
-
-		// Log location
-		bool isUnknown = IsUnknown();
-		buffer.Format("[PID:{:0>6}|{}:{:0>6}]",
-					  m_Process.GetID(),
-					  isUnknown ? "UNK" : "TID",
-					  isUnknown ? SystemThread::GetCurrentThread().GetID() : m_Thread.GetID()
-		);
-
-		// Log message level
-		buffer.Format("[{:<11}]", FormatLogLevel(logLevel));
-
-		// Add indents
-		buffer.Append(' ', m_ScopeLevel * 4);
-
-		// Add category if present
-		if (!category.empty())
-		{
-			buffer.Format(" <{}>", category);
-		}
-
-		// Log the actual message string
-		buffer += ' ';
-		buffer += message;
+		const bool isUnknown = IsUnknown();
+		const uint32_t threadID = isUnknown ? SystemThread::GetCurrentThread().GetID() : m_Thread.GetID();
 
-		return buffer;
+		return Private::FormatScopedLoggerRecord(timestamp, m_GlobalContext.GetTimeOffset(), m_Process.GetID(), threadID, isUnknown, logLevel, scopeLevel, message, category);
 	}
 	void ScopedLoggerTLS::InitializeUserData(std::shared_ptr<IScopedLoggerContext> userContext)
 	{
@@ -293,8 +323,64 @@ namespace kxf
 		}
 	}
 
+	void ScopedLoggerTLS::WriteRecord(LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel)
+	{
+		if (auto logTarget = m_LogTarget.load(); logTarget && !logTarget->WriteRecord(*this, logLevel, timestamp, message, category, scopeLevel))
+		{
+			String formatted = logTarget->FormatRecord(*this, logLevel, timestamp, message, category);
+			if (formatted.IsEmpty())
+			{
+				formatted = FormatRecord(logLevel, timestamp, message, category, scopeLevel);
+			}
+
+			logTarget->Write(logLevel, formatted.view());
+		}
+	}
+	bool ScopedLoggerTLS::AttachAsyncWriter()
+	{
+		if (m_AsyncBuffer)
+		{
+			if (!m_AsyncBuffer->IsDetached())
+			{
+				return true;
+			}
+
+			// Asynchronous mode has been disabled (or re-enabled with a different writer) since the last write
+			m_AsyncBuffer = nullptr;
+			m_AsyncWriter = nullptr;
+		}
+
+		if (!IsUnknown() && m_GlobalContext.IsAsyncModeEnabled())
+		{
+			// The writer thread itself must never wait for its own buffer to drain
+			if (auto writer = m_GlobalContext.GetAsyncWriter(); writer && !writer->IsWriterThread())
+			{
+				m_AsyncBuffer = writer->Attach(*this);
+				if (m_AsyncBuffer)
+				{
+					m_AsyncWriter = std::move(writer);
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+	void ScopedLoggerTLS::DetachAsyncWriter()
+	{
+		if (m_AsyncBuffer)
+		{
+			m_AsyncWriter->Detach(*m_AsyncBuffer);
+			m_AsyncBuffer = nullptr;
+			m_AsyncWriter = nullptr;
+		}
+	}
+
 	void ScopedLoggerTLS::Flush()
 	{
+		if (m_AsyncBuffer && !m_AsyncBuffer->IsDetached())
+		{
+			m_AsyncWriter->Flush(*m_AsyncBuffer);
+		}
 		if (auto logTarget = m_LogTarget.load())
 		{
 			logTarget->Flush();
@@ -304,15 +390,13 @@ namespace kxf
 	{
 		if (!message.empty() && m_GlobalContext.CanLogLevel(logLevel))
 		{
-			if (auto logTarget = m_LogTarget.load())
+			if ((m_AsyncBuffer || m_GlobalContext.IsAsyncModeEnabled()) && AttachAsyncWriter())
 			{
-				String formatted = logTarget->FormatRecord(*this, logLevel, timestamp, message, category);
-				if (formatted.IsEmpty())
-				{
-					formatted = FormatRecord(logLevel, timestamp, message, category);
-				}
-
-				logTarget->Write(logLevel, formatted.view());
+				m_AsyncWriter->Push(*m_AsyncBuffer, logLevel, timestamp, message, category, m_ScopeLevel);
+			}
+			else
+			{
+				WriteRecord(logLevel, timestamp, message, category, m_ScopeLevel);
 			}
 		}
 	}
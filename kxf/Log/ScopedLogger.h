@@ -19,6 +19,15 @@ namespace kxf
 	class ScopedLoggerNewScope;
 	class ScopedLoggerGlobalContext;
 	class ScopedMessageLogger;
+	struct ScopedLoggerAsyncOptions;
+}
+namespace kxf::Private
+{
+	class ScopedLoggerRingBuffer;
+	class ScopedLoggerAsyncWriter;
+
+	// Formats a record the same way 'ScopedLoggerTLS' does, used to convert records stored in other formats back to text
+	KX_API String FormatScopedLoggerRecord(DateTime timestamp, const TimeZoneOffset& tzOffset, uint32_t processID, uint32_t threadID, bool isUnknownThread, LogLevel logLevel, size_t scopeLevel, StringView message, StringView category);
 }
 
 namespace kxf
@@ -38,6 +47,13 @@ namespace kxf
 			{
 				return {};
 			}
+
+			// Targets storing records in their own format can write them here instead of receiving the text
+			// produced by 'FormatRecord'. Return false to get the text through 'Write' as usual.
+			virtual bool WriteRecord(const ScopedLoggerTLS& tls, LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel)
+			{
+				return false;
+			}
 	};
 
 	class IScopedLoggerContext: public RTTI::Interface<IScopedLoggerContext>
@@ -59,11 +75,14 @@ namespace kxf
 	{
 		friend class ScopedLogger;
 		friend class ScopedLoggerGlobalContext;
+		friend class Private::ScopedLoggerAsyncWriter;
 
 		protected:
 			ScopedLoggerGlobalContext& m_GlobalContext;
 			std::atomic<std::weak_ptr<IScopedLoggerContext>> m_UserContextRef;
 			std::atomic<std::shared_ptr<IScopedLoggerTarget>> m_LogTarget;
+			std::shared_ptr<Private::ScopedLoggerAsyncWriter> m_AsyncWriter;
+			std::shared_ptr<Private::ScopedLoggerRingBuffer> m_AsyncBuffer;
 			std::vector<ScopedLogger*> m_ScopeStack;
 			SystemProcess m_Process;
 			SystemThread m_Thread;
@@ -76,7 +95,9 @@ namespace kxf
 			void Destroy();
 
 			void LogOpenClose(bool open);
-			String FormatRecord(LogLevel logLevel, DateTime timestamp, StringView str, StringView category) const;
+			void WriteRecord(LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel);
+			bool AttachAsyncWriter();
+			void DetachAsyncWriter();
 			void InitializeUserData(std::shared_ptr<IScopedLoggerContext> userContext);
 
 			void OnScopeEnter(ScopedLogger& scope)
@@ -143,6 +164,8 @@ namespace kxf
 				return m_Thread.IsNull();
 			}
 
+			String FormatRecord(LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel) const;
+
 			void Flush();
 			void Write(LogLevel logLevel, DateTime timestamp, StringView message, StringView category);
 	};
@@ -646,6 +669,9 @@ namespace kxf
 			FiberLocalSlot m_TLSIndex;
 			bool m_UpdateUserContext = false;
 
+			std::atomic<std::shared_ptr<Private::ScopedLoggerAsyncWriter>> m_AsyncWriter;
+			std::atomic<bool> m_IsAsyncModeEnabled = false;
+
 		private:
 			bool IsInitialized() const noexcept;
 			void Initialize();
@@ -696,6 +722,19 @@ namespace kxf
 			{
 				m_TimeOffset = timeOffset;
 			}
+
+			// In asynchronous mode threads only put records into their buffers, formatting and writing them is done by a background thread.
+			// The unknown context is always synchronous since it can be used by multiple threads at once.
+			bool IsAsyncModeEnabled() const noexcept
+			{
+				return m_IsAsyncModeEnabled.load(std::memory_order_relaxed);
+			}
+			void EnableAsyncMode(const ScopedLoggerAsyncOptions& options);
+			void DisableAsyncMode();
+			std::shared_ptr<Private::ScopedLoggerAsyncWriter> GetAsyncWriter() const noexcept
+			{
+				return m_AsyncWriter;
+			}
 	};
 }
 
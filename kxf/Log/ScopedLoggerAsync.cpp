@@ -0,0 +1,231 @@
+#include "KxfPCH.h"
+#include "ScopedLoggerAsync.h"
+#include "ScopedLogger.h"
+#include <bit>
+
+namespace
+{
+	bool IsImportantRecord(kxf::LogLevel logLevel) noexcept
+	{
+		return logLevel == kxf::LogLevel::Critical || logLevel == kxf::LogLevel::Error;
+	}
+}
+
+namespace kxf::Private
+{
+	ScopedLoggerRingBuffer::ScopedLoggerRingBuffer(ScopedLoggerTLS& owner, size_t capacity)
+		:m_Owner(owner), m_Records(std::bit_ceil(std::max<size_t>(capacity, 2))), m_Mask(m_Records.size() - 1)
+	{
+	}
+}
+
+namespace kxf::Private
+{
+	void ScopedLoggerAsyncWriter::OnThread()
+	{
+		const auto interval = std::chrono::milliseconds(std::max<int64_t>(m_Options.FlushInterval.GetMilliseconds(), 1));
+
+		std::unique_lock lock(m_Lock);
+		bool hasMore = false;
+		while (!m_ShouldTerminate)
+		{
+			if (!hasMore)
+			{
+				m_Condition.wait_for(lock, interval, [&]()
+				{
+					return m_IsNotified.exchange(false) || m_ShouldTerminate;
+				});
+			}
+
+			// Write one batch from each buffer per round so a single busy thread can't starve the others
+			size_t written = 0;
+			for (const auto& buffer: m_Buffers)
+			{
+				written += WriteRecords(*buffer, m_Options.BatchSize);
+			}
+
+			// Let threads attach or detach their buffers between the rounds
+			hasMore = written != 0;
+			if (hasMore)
+			{
+				lock.unlock();
+				lock.lock();
+			}
+		}
+	}
+	size_t ScopedLoggerAsyncWriter::WriteRecords(ScopedLoggerRingBuffer& buffer, size_t maxCount)
+	{
+		ScopedLoggerTLS& tls = buffer.GetOwner();
+		const size_t count = buffer.Consume(maxCount, [&](const ScopedLoggerRingBuffer::Record& record)
+		{
+			tls.WriteRecord(record.Level, record.Timestamp, record.Message.view(), record.Category.view(), record.ScopeLevel);
+		});
+
+		if (size_t dropped = buffer.m_DroppedCount.exchange(0, std::memory_order_relaxed); dropped != 0)
+		{
+			tls.WriteRecord(LogLevel::Warning, DateTime::Now(), Format("{} log records were dropped because the buffer was full", dropped).view(), {}, 0);
+		}
+		return count;
+	}
+	void ScopedLoggerAsyncWriter::Notify() noexcept
+	{
+		// The flag has to be set under the lock, otherwise the writer can check it right before it starts
+		// waiting and miss the notification. Only the first producer after the writer has woken up takes the lock.
+		if (!m_IsNotified.load(std::memory_order_acquire))
+		{
+			bool shouldNotify = false;
+			if (std::unique_lock lock(m_Lock); !m_IsNotified.load(std::memory_order_relaxed))
+			{
+				m_IsNotified = true;
+				shouldNotify = true;
+			}
+
+			if (shouldNotify)
+			{
+				m_Condition.notify_one();
+			}
+		}
+	}
+
+	ScopedLoggerAsyncWriter::ScopedLoggerAsyncWriter(const ScopedLoggerAsyncOptions& options)
+		:m_Options(options)
+	{
+		m_Thread = std::thread([this]()
+		{
+			OnThread();
+		});
+		m_ThreadID = m_Thread.get_id();
+	}
+	ScopedLoggerAsyncWriter::~ScopedLoggerAsyncWriter()
+	{
+		Stop();
+	}
+
+	std::shared_ptr<ScopedLoggerRingBuffer> ScopedLoggerAsyncWriter::Attach(ScopedLoggerTLS& tls)
+	{
+		auto buffer = std::make_shared<ScopedLoggerRingBuffer>(tls, m_Options.BufferCapacity);
+		if (std::unique_lock lock(m_Lock); !m_ShouldTerminate)
+		{
+			m_Buffers.emplace_back(buffer);
+			return buffer;
+		}
+		return nullptr;
+	}
+	void ScopedLoggerAsyncWriter::Detach(ScopedLoggerRingBuffer& buffer)
+	{
+		// Write out everything the thread has logged so far while its context is still alive
+		std::unique_lock lock(m_Lock);
+		while (WriteRecords(buffer, std::numeric_limits<size_t>::max()) != 0)
+		{
+		}
+
+		buffer.m_IsDetached = true;
+		std::erase_if(m_Buffers, [&](const auto& item)
+		{
+			return item.get() == &buffer;
+		});
+	}
+	void ScopedLoggerAsyncWriter::Flush(ScopedLoggerRingBuffer& buffer)
+	{
+		std::unique_lock lock(m_Lock);
+		while (WriteRecords(buffer, std::numeric_limits<size_t>::max()) != 0)
+		{
+		}
+	}
+	void ScopedLoggerAsyncWriter::Stop()
+	{
+		if (std::unique_lock lock(m_Lock); !m_ShouldTerminate)
+		{
+			m_ShouldTerminate = true;
+		}
+		else
+		{
+			return;
+		}
+
+		m_Condition.notify_one();
+		m_Thread.join();
+
+		// The thread has written everything before exiting, the remaining threads switch to synchronous mode. Buffers are marked
+		// as detached before the last drain, so a producer that has already decided to push will see it and write its record itself.
+		std::unique_lock lock(m_Lock);
+		for (const auto& buffer: m_Buffers)
+		{
+			buffer->m_IsDetached = true;
+		}
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		for (const auto& buffer: m_Buffers)
+		{
+			while (WriteRecords(*buffer, std::numeric_limits<size_t>::max()) != 0)
+			{
+			}
+		}
+		m_Buffers.clear();
+	}
+
+	bool ScopedLoggerAsyncWriter::Push(ScopedLoggerRingBuffer& buffer, LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel)
+	{
+		const size_t capacity = buffer.m_Records.size();
+		const bool isImportant = IsImportantRecord(logLevel);
+
+		const size_t writeIndex = buffer.m_WriteIndex.load(std::memory_order_relaxed);
+		size_t readIndex = buffer.m_ReadIndex.load(std::memory_order_acquire);
+		size_t used = writeIndex - readIndex;
+
+		if (used >= capacity)
+		{
+			if (m_Options.OverflowPolicy != ScopedLoggerOverflowPolicy::Block && !isImportant)
+			{
+				buffer.m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			// Wait for the writer to make some room
+			while (used >= capacity)
+			{
+				buffer.m_IsProducerWaiting = true;
+				Notify();
+				buffer.m_ReadIndex.wait(readIndex);
+
+				readIndex = buffer.m_ReadIndex.load(std::memory_order_acquire);
+				used = writeIndex - readIndex;
+			}
+		}
+		else if (m_Options.OverflowPolicy == ScopedLoggerOverflowPolicy::Sample && !isImportant && used >= capacity / 2)
+		{
+			if (buffer.m_SampleCounter++ % std::max<size_t>(m_Options.SampleRate, 1) != 0)
+			{
+				buffer.m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+
+		auto& record = buffer.m_Records[writeIndex & buffer.m_Mask];
+		record.Timestamp = timestamp;
+		record.Message.assign(message.data(), message.size());
+		record.Category.assign(category.data(), category.size());
+		record.ScopeLevel = scopeLevel;
+		record.Level = logLevel;
+		buffer.m_WriteIndex.store(writeIndex + 1, std::memory_order_release);
+
+		// The writer could have been stopped after the caller has checked the buffer, and its final drain could have missed
+		// this record. Write whatever is left synchronously, the lock keeps us from consuming together with 'Stop'.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (buffer.IsDetached())
+		{
+			std::unique_lock lock(m_Lock);
+			while (WriteRecords(buffer, std::numeric_limits<size_t>::max()) != 0)
+			{
+			}
+			return true;
+		}
+
+		// Don't wake up the writer for every record, only when the buffer is filling up or when the record is important
+		if (isImportant || used + 1 == capacity / 2)
+		{
+			Notify();
+		}
+		return true;
+	}
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include "Common.h"
+#include "kxf/Core/DateTime.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace kxf
+{
+	class ScopedLoggerTLS;
+}
+
+namespace kxf
+{
+	enum class ScopedLoggerOverflowPolicy
+	{
+		// Wait until the background thread makes room for the record
+		Block,
+
+		// Discard records that don't fit
+		Drop,
+
+		// Keep only every n-th record once the buffer is half full, discard records that don't fit
+		Sample
+	};
+
+	struct ScopedLoggerAsyncOptions final
+	{
+		// Number of records each thread can have in flight, rounded up to a power of two
+		size_t BufferCapacity = 4096;
+
+		// Critical and error records always wait for room regardless of this policy
+		ScopedLoggerOverflowPolicy OverflowPolicy = ScopedLoggerOverflowPolicy::Block;
+		size_t SampleRate = 16;
+
+		// Max number of records written from one thread buffer before moving to the next one
+		size_t BatchSize = 256;
+
+		// How often the background thread checks the buffers if nobody wakes it up sooner
+		TimeSpan FlushInterval = TimeSpan::Milliseconds(50);
+	};
+}
+
+namespace kxf::Private
+{
+	// Single-producer single-consumer ring of raw log records owned by a logger thread context. The record strings
+	// are reused between records so once the buffer is warmed up adding a record doesn't allocate.
+	class ScopedLoggerRingBuffer final
+	{
+		friend class ScopedLoggerAsyncWriter;
+
+		public:
+			struct Record final
+			{
+				DateTime Timestamp;
+				String Message;
+				String Category;
+				size_t ScopeLevel = 0;
+				LogLevel Level = LogLevel::Unknown;
+			};
+
+		private:
+			ScopedLoggerTLS& m_Owner;
+			std::vector<Record> m_Records;
+			const size_t m_Mask = 0;
+
+			alignas(64) std::atomic<size_t> m_WriteIndex = 0;
+			alignas(64) std::atomic<size_t> m_ReadIndex = 0;
+			std::atomic<bool> m_IsProducerWaiting = false;
+			std::atomic<size_t> m_DroppedCount = 0;
+			std::atomic<bool> m_IsDetached = false;
+			size_t m_SampleCounter = 0;
+
+		private:
+			template<class TFunc>
+			size_t Consume(size_t maxCount, TFunc&& func)
+			{
+				const size_t readIndex = m_ReadIndex.load(std::memory_order_relaxed);
+				const size_t count = std::min(m_WriteIndex.load(std::memory_order_acquire) - readIndex, maxCount);
+				for (size_t i = 0; i < count; i++)
+				{
+					std::invoke(func, std::as_const(m_Records[(readIndex + i) & m_Mask]));
+				}
+
+				if (count != 0)
+				{
+					m_ReadIndex.store(readIndex + count);
+					if (m_IsProducerWaiting.exchange(false))
+					{
+						m_ReadIndex.notify_one();
+					}
+				}
+				return count;
+			}
+
+		public:
+			ScopedLoggerRingBuffer(ScopedLoggerTLS& owner, size_t capacity);
+			ScopedLoggerRingBuffer(const ScopedLoggerRingBuffer&) = delete;
+
+		public:
+			ScopedLoggerTLS& GetOwner() const noexcept
+			{
+				return m_Owner;
+			}
+			bool IsDetached() const noexcept
+			{
+				return m_IsDetached.load(std::memory_order_acquire);
+			}
+			bool IsEmpty() const noexcept
+			{
+				return m_WriteIndex.load(std::memory_order_acquire) == m_ReadIndex.load(std::memory_order_acquire);
+			}
+
+		public:
+			ScopedLoggerRingBuffer& operator=(const ScopedLoggerRingBuffer&) = delete;
+	};
+
+	// Background thread formatting and writing records from the thread buffers
+	class ScopedLoggerAsyncWriter final
+	{
+		private:
+			const ScopedLoggerAsyncOptions m_Options;
+
+			std::mutex m_Lock;
+			std::condition_variable m_Condition;
+			std::atomic<bool> m_IsNotified = false;
+			std::vector<std::shared_ptr<ScopedLoggerRingBuffer>> m_Buffers;
+
+			std::thread m_Thread;
+			std::thread::id m_ThreadID;
+			bool m_ShouldTerminate = false;
+
+		private:
+			void OnThread();
+			size_t WriteRecords(ScopedLoggerRingBuffer& buffer, size_t maxCount);
+			void Notify() noexcept;
+
+		public:
+			ScopedLoggerAsyncWriter(const ScopedLoggerAsyncOptions& options);
+			ScopedLoggerAsyncWriter(const ScopedLoggerAsyncWriter&) = delete;
+			~ScopedLoggerAsyncWriter();
+
+		public:
+			const ScopedLoggerAsyncOptions& GetOptions() const noexcept
+			{
+				return m_Options;
+			}
+			bool IsWriterThread() const noexcept
+			{
+				return std::this_thread::get_id() == m_ThreadID;
+			}
+
+			std::shared_ptr<ScopedLoggerRingBuffer> Attach(ScopedLoggerTLS& tls);
+			void Detach(ScopedLoggerRingBuffer& buffer);
+			void Flush(ScopedLoggerRingBuffer& buffer);
+			void Stop();
+
+			// Called on the thread owning the buffer, returns false if the record was dropped
+			bool Push(ScopedLoggerRingBuffer& buffer, LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel);
+
+		public:
+			ScopedLoggerAsyncWriter& operator=(const ScopedLoggerAsyncWriter&) = delete;
+	};
+}
@@ -0,0 +1,316 @@
+#include "KxfPCH.h"
+#include "ScopedLoggerBinaryTarget.h"
+#include "kxf/Serialization/BinarySerializer.h"
+#include "kxf/Core/IEncodingConverter.h"
+
+namespace
+{
+	using Format = kxf::Private::ScopedLoggerBinaryFormat;
+
+	constexpr size_t g_BufferSize = 64 * 1024;
+	constexpr size_t g_MaxInternedStrings = 64 * 1024;
+	constexpr size_t g_MaxInternedMessageLength = 256;
+
+	void ToUTF8(kxf::StringView value, std::string& buffer)
+	{
+		using namespace kxf;
+
+		buffer.resize(EncodingConverter_UTF8.ToMultiByte(value, {}));
+		EncodingConverter_UTF8.ToMultiByte(value, std::as_writable_bytes(std::span(buffer)));
+	}
+}
+
+namespace kxf
+{
+	void ScopedLoggerBinaryTarget::WriteHeader(const ScopedLoggerGlobalContext& context)
+	{
+		Serialization::WriteObject(m_Buffer, Format::Signature);
+		Serialization::WriteObject(m_Buffer, Format::Version);
+		Serialization::WriteObject(m_Buffer, SystemProcess::GetCurrentProcess().GetID());
+		Serialization::WriteObject(m_Buffer, context.GetTimeOffset().GetOffset().GetMilliseconds());
+
+		m_HeaderWritten = true;
+	}
+	void ScopedLoggerBinaryTarget::WriteString(StringView value)
+	{
+		ToUTF8(value, m_UTF8Buffer);
+		Serialization::WriteObject(m_Buffer, m_UTF8Buffer);
+	}
+	std::optional<uint32_t> ScopedLoggerBinaryTarget::InternString(StringView value, bool isMessage)
+	{
+		if (auto it = m_Strings.find(value); it != m_Strings.end())
+		{
+			return it->second;
+		}
+		if (m_Strings.size() >= g_MaxInternedStrings)
+		{
+			return {};
+		}
+
+		if (isMessage)
+		{
+			// Most messages contain some variable data, only intern them once they've been seen again.
+			// The seen set is only a filter, start it over rather than let it grow with every distinct message.
+			if (m_SeenMessages.size() >= g_MaxInternedStrings)
+			{
+				m_SeenMessages.clear();
+			}
+			if (value.length() > g_MaxInternedMessageLength || m_SeenMessages.insert(std::hash<StringView>()(value)).second)
+			{
+				return {};
+			}
+		}
+
+		const uint32_t index = static_cast<uint32_t>(m_Strings.size());
+		m_Strings.emplace(std::wstring(value), index);
+
+		Serialization::WriteObject(m_Buffer, Format::Tag::String);
+		Serialization::WriteObject(m_Buffer, index);
+		WriteString(value);
+
+		return index;
+	}
+	void ScopedLoggerBinaryTarget::FlushBuffer()
+	{
+		if (const size_t size = m_Buffer.TellO().ToBytes(); size != 0)
+		{
+			m_Stream->Write(m_Buffer.GetStreamBuffer().GetBufferStart(), size);
+			m_Buffer.SeekO(0, IOStreamSeek::FromStart);
+		}
+	}
+
+	ScopedLoggerBinaryTarget::ScopedLoggerBinaryTarget(std::unique_ptr<IOutputStream> stream)
+		:m_Stream(std::move(stream))
+	{
+		m_Buffer.SetAllocationSize(g_BufferSize);
+	}
+	ScopedLoggerBinaryTarget::~ScopedLoggerBinaryTarget()
+	{
+		FlushBuffer();
+		m_Stream->Flush();
+	}
+
+	// IScopedLoggerTarget
+	void ScopedLoggerBinaryTarget::Write(LogLevel logLevel, StringView str)
+	{
+		// Text from the targets that don't know about us, stored as is
+		WriteLockGuard lock(m_Lock);
+		if (!m_HeaderWritten)
+		{
+			WriteHeader(ScopedLoggerGlobalContext::GetInstance());
+		}
+
+		Serialization::WriteObject(m_Buffer, Format::Tag::Text);
+		WriteString(str);
+
+		m_FlushControl.OnWrite();
+		if (m_FlushControl.ShouldFlush(logLevel) || m_Buffer.TellO().ToBytes() >= g_BufferSize)
+		{
+			FlushBuffer();
+			m_Stream->Flush();
+			m_FlushControl.OnFlush();
+		}
+	}
+	void ScopedLoggerBinaryTarget::Flush()
+	{
+		WriteLockGuard lock(m_Lock);
+
+		FlushBuffer();
+		m_Stream->Flush();
+		m_FlushControl.OnFlush();
+	}
+	bool ScopedLoggerBinaryTarget::WriteRecord(const ScopedLoggerTLS& tls, LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel)
+	{
+		WriteLockGuard lock(m_Lock);
+		if (!m_HeaderWritten)
+		{
+			WriteHeader(tls.GetGlobalContext());
+		}
+
+		// String definitions must precede the record referencing them
+		std::optional<uint32_t> categoryIndex;
+		if (!category.empty())
+		{
+			categoryIndex = InternString(category, false);
+		}
+		const std::optional<uint32_t> messageIndex = InternString(message, true);
+
+		const bool isUnknown = tls.IsUnknown();
+		uint8_t flags = 0;
+		if (isUnknown)
+		{
+			flags |= Format::UnknownThread;
+		}
+		if (!category.empty())
+		{
+			flags |= Format::HasCategory;
+		}
+		if (!messageIndex)
+		{
+			flags |= Format::InlineMessage;
+		}
+
+		Serialization::WriteObject(m_Buffer, Format::Tag::Record);
+		Serialization::WriteObject(m_Buffer, flags);
+		Serialization::WriteObject(m_Buffer, timestamp);
+		Serialization::WriteObject(m_Buffer, logLevel);
+		Serialization::WriteObject(m_Buffer, isUnknown ? SystemThread::GetCurrentThread().GetID() : tls.GetThread().GetID());
+		Serialization::WriteObject(m_Buffer, static_cast<uint32_t>(scopeLevel));
+
+		if (!category.empty())
+		{
+			if (categoryIndex)
+			{
+				Serialization::WriteObject(m_Buffer, *categoryIndex);
+			}
+			else
+			{
+				// The string table is full, categories are rare enough to store them inline in this case
+				Serialization::WriteObject(m_Buffer, std::numeric_limits<uint32_t>::max());
+				WriteString(category);
+			}
+		}
+		if (messageIndex)
+		{
+			Serialization::WriteObject(m_Buffer, *messageIndex);
+		}
+		else
+		{
+			WriteString(message);
+		}
+
+		m_FlushControl.OnWrite();
+		if (m_FlushControl.ShouldFlush(logLevel))
+		{
+			FlushBuffer();
+			m_Stream->Flush();
+			m_FlushControl.OnFlush();
+		}
+		else if (m_Buffer.TellO().ToBytes() >= g_BufferSize)
+		{
+			FlushBuffer();
+		}
+		return true;
+	}
+}
+
+namespace kxf
+{
+	bool ScopedLoggerBinaryDecoder::Decode(IInputStream& binaryStream, IOutputStream& textStream)
+	{
+		auto WriteLine = [&](const String& line)
+		{
+			auto utf8 = line.ToUTF8();
+			utf8 += '\n';
+			textStream.Write(utf8.data(), utf8.size());
+		};
+		auto ReadString = [&]()
+		{
+			std::string utf8;
+			Serialization::ReadObject(binaryStream, utf8);
+			return String::FromUTF8(utf8);
+		};
+
+		try
+		{
+			uint32_t signature = 0;
+			uint32_t version = 0;
+			uint32_t processID = 0;
+			int64_t tzOffset = 0;
+			Serialization::ReadObject(binaryStream, signature);
+			Serialization::ReadObject(binaryStream, version);
+			if (signature != Format::Signature || version != Format::Version)
+			{
+				return false;
+			}
+			Serialization::ReadObject(binaryStream, processID);
+			Serialization::ReadObject(binaryStream, tzOffset);
+
+			const TimeZoneOffset timeZone(TimeSpan::Milliseconds(tzOffset));
+			std::vector<String> strings;
+
+			Format::Tag tag = {};
+			while (true)
+			{
+				// Nothing left to read is the normal end of the log, a partial tag means the stream was cut off
+				if (const auto read = binaryStream.Read(&tag, sizeof(tag)).LastRead().ToBytes<size_t>(); read != sizeof(tag))
+				{
+					return read == 0;
+				}
+
+				switch (tag)
+				{
+					case Format::Tag::String:
+					{
+						uint32_t index = 0;
+						Serialization::ReadObject(binaryStream, index);
+						if (index != strings.size())
+						{
+							return false;
+						}
+						strings.emplace_back(ReadString());
+						break;
+					}
+					case Format::Tag::Text:
+					{
+						WriteLine(ReadString());
+						break;
+					}
+					case Format::Tag::Record:
+					{
+						uint8_t flags = 0;
+						DateTime timestamp;
+						LogLevel logLevel = LogLevel::Unknown;
+						uint32_t threadID = 0;
+						uint32_t scopeLevel = 0;
+						Serialization::ReadObject(binaryStream, flags);
+						Serialization::ReadObject(binaryStream, timestamp);
+						Serialization::ReadObject(binaryStream, logLevel);
+						Serialization::ReadObject(binaryStream, threadID);
+						Serialization::ReadObject(binaryStream, scopeLevel);
+
+						auto ReadIndexedString = [&](uint32_t index) -> String
+						{
+							if (index >= strings.size())
+							{
+								throw BinarySerializerException("Invalid string index");
+							}
+							return strings[index];
+						};
+
+						String category;
+						if (flags & Format::HasCategory)
+						{
+							uint32_t index = 0;
+							Serialization::ReadObject(binaryStream, index);
+							category = index == std::numeric_limits<uint32_t>::max() ? ReadString() : ReadIndexedString(index);
+						}
+
+						String message;
+						if (flags & Format::InlineMessage)
+						{
+							message = ReadString();
+						}
+						else
+						{
+							uint32_t index = 0;
+							Serialization::ReadObject(binaryStream, index);
+							message = ReadIndexedString(index);
+						}
+
+						WriteLine(Private::FormatScopedLoggerRecord(timestamp, timeZone, processID, threadID, (flags & Format::UnknownThread) != 0, logLevel, scopeLevel, message, category));
+						break;
+					}
+					default:
+					{
+						return false;
+					}
+				};
+			}
+		}
+		catch (const BinarySerializerException&)
+		{
+			return false;
+		}
+	}
+}
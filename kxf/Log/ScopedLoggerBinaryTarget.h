@@ -0,0 +1,94 @@
+#pragma once
+#include "Common.h"
+#include "ScopedLogger.h"
+#include "ScopedLoggerTarget.h"
+#include "kxf/IO/IStream.h"
+#include "kxf/IO/MemoryStream.h"
+#include "kxf/Threading/ReadWriteLock.h"
+#include <unordered_map>
+#include <unordered_set>
+
+namespace kxf::Private
+{
+	// Binary log stream layout. The header is followed by a sequence of tagged entries:
+	// strings definitions which are referenced by their index by the records that follow them and the records themselves.
+	struct ScopedLoggerBinaryFormat final
+	{
+		static constexpr uint32_t Signature = 0x42474c4b; // 'KLGB'
+		static constexpr uint32_t Version = 1;
+
+		enum class Tag: uint8_t
+		{
+			String = 1,
+			Record = 2,
+			Text = 3
+		};
+
+		// Record flags
+		static constexpr uint8_t UnknownThread = 1 << 0;
+		static constexpr uint8_t HasCategory = 1 << 1;
+		static constexpr uint8_t InlineMessage = 1 << 2;
+	};
+}
+
+namespace kxf
+{
+	// Writes records as a compact binary stream instead of text. Categories and recurring messages are stored once
+	// and then referenced by their index. Use 'ScopedLoggerBinaryDecoder' to convert the stream back to the text format.
+	class ScopedLoggerBinaryTarget: public IScopedLoggerTarget
+	{
+		private:
+			struct StringHash final
+			{
+				using is_transparent = void;
+
+				size_t operator()(StringView value) const noexcept
+				{
+					return std::hash<StringView>()(value);
+				}
+			};
+
+		private:
+			ReadWriteLock m_Lock;
+			std::unique_ptr<IOutputStream> m_Stream;
+			MemoryOutputStream m_Buffer;
+			Private::ScopedLoggerFlushControl m_FlushControl;
+
+			std::unordered_map<std::wstring, uint32_t, StringHash, std::equal_to<>> m_Strings;
+			std::unordered_set<size_t> m_SeenMessages;
+			std::string m_UTF8Buffer;
+			bool m_HeaderWritten = false;
+
+		private:
+			void WriteHeader(const ScopedLoggerGlobalContext& context);
+			void WriteString(StringView value);
+			std::optional<uint32_t> InternString(StringView value, bool isMessage);
+			void FlushBuffer();
+
+		public:
+			ScopedLoggerBinaryTarget(std::unique_ptr<IOutputStream> stream);
+			~ScopedLoggerBinaryTarget();
+
+		public:
+			// IScopedLoggerTarget
+			void Write(LogLevel logLevel, StringView str) override;
+			void Flush() override;
+			bool WriteRecord(const ScopedLoggerTLS& tls, LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel) override;
+
+			// ScopedLoggerBinaryTarget
+			void SetFlushThreshold(size_t value) noexcept
+			{
+				m_FlushControl.SetFlushThreshold(value);
+			}
+	};
+}
+
+namespace kxf
+{
+	class ScopedLoggerBinaryDecoder final
+	{
+		public:
+			// Converts the binary log stream into the text format, returns false if the stream is not a valid binary log or is truncated
+			static bool Decode(IInputStream& binaryStream, IOutputStream& textStream);
+	};
+}
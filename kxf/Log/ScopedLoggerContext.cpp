@@ -1,6 +1,7 @@
 #include "KxfPCH.h"
 #include "ScopedLoggerContext.h"
 #include "ScopedLoggerTarget.h"
+#include "ScopedLoggerBinaryTarget.h"
 
 namespace kxf
 {
@@ -25,6 +26,26 @@ namespace kxf
 	}
 }
 
+namespace kxf
+{
+	// ScopedLoggerBinaryFileContext
+	ScopedLoggerBinaryFileContext::ScopedLoggerBinaryFileContext(std::unique_ptr<IOutputStream> stream)
+	{
+		m_Target = std::make_shared<ScopedLoggerBinaryTarget>(std::move(stream));
+	}
+	ScopedLoggerBinaryFileContext::ScopedLoggerBinaryFileContext(IFileSystem& fs, const FSPath& filePath)
+	{
+		auto stream = fs.OpenToWrite(filePath, IOStreamDisposition::CreateAlways, IOStreamShare::Read, FSActionFlag::CreateDirectoryTree|FSActionFlag::Recursive);
+		m_Target = std::make_shared<ScopedLoggerBinaryTarget>(std::move(stream));
+	}
+
+	// IScopedLoggerContext
+	std::shared_ptr<IScopedLoggerTarget> ScopedLoggerBinaryFileContext::CreateLogTarget(ScopedLoggerTLS& tls)
+	{
+		return m_Target;
+	}
+}
+
 namespace kxf
 {
 	// IScopedLoggerContext
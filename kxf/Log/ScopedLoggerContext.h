@@ -48,6 +48,24 @@ namespace kxf
 	};
 }
 
+namespace kxf
+{
+	class ScopedLoggerBinaryTarget;
+	class ScopedLoggerBinaryFileContext: public IScopedLoggerContext
+	{
+		private:
+			std::shared_ptr<ScopedLoggerBinaryTarget> m_Target;
+
+		public:
+			ScopedLoggerBinaryFileContext(std::unique_ptr<IOutputStream> stream);
+			ScopedLoggerBinaryFileContext(IFileSystem& fs, const FSPath& filePath);
+
+		public:
+			// IScopedLoggerContext
+			std::shared_ptr<IScopedLoggerTarget> CreateLogTarget(ScopedLoggerTLS& tls) override;
+	};
+}
+
 namespace kxf
 {
 	class ScopedLoggerAggregateTarget;
@@ -177,6 +177,28 @@ namespace kxf
 
 				return formatted;
 			}
+			bool WriteRecord(const ScopedLoggerTLS& tls, LogLevel logLevel, DateTime timestamp, StringView message, StringView category, size_t scopeLevel) override
+			{
+				// Targets with their own record format get the record as is, the rest share the formatted text
+				String formatted;
+				ForEach(m_LogTargets, [&](IScopedLoggerTarget& ref)
+				{
+					if (!ref.WriteRecord(tls, logLevel, timestamp, message, category, scopeLevel))
+					{
+						if (formatted.IsEmpty())
+						{
+							formatted = FormatRecord(tls, logLevel, timestamp, message, category);
+							if (formatted.IsEmpty())
+							{
+								formatted = tls.FormatRecord(logLevel, timestamp, message, category, scopeLevel);
+							}
+						}
+						ref.Write(logLevel, formatted.view());
+					}
+					return CallbackCommand::Continue;
+				});
+				return true;
+			}
 
 			// AggregateScopedLoggerTarget
 			void PushTarget(std::shared_ptr<IScopedLoggerTarget> ptr)
@@ -52,10 +52,15 @@ namespace kxf
 					const uint64_t resultSize = resultStream.GetSize().ToBytes();
 					m_ResultBuffer.Allocate(resultSize + sizeof(resultSize), MemoryProtection::RW, GetResultBufferName(), m_KernelScope);
 
-					// Write result size and the result
+					// Write result size and the result in one go
+					const std::span<const std::byte> buffers[] =
+					{
+						std::as_bytes(std::span(&resultSize, 1)),
+						resultStream.ReadView(resultSize)
+					};
+
 					MemoryOutputStream stream = m_ResultBuffer.GetOutputStream();
-					Serialization::WriteObject(stream, resultSize);
-					stream.Write(resultStream);
+					stream.WriteV(buffers);
 				}
 			}
 		}
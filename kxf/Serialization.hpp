@@ -2,6 +2,7 @@
 #include "kxf/Serialization/Common.h"
 
 #include "kxf/Serialization/BinarySerializer.h"
+#include "kxf/Serialization/BinaryArchive.h"
 #include "kxf/Serialization/XDocument.h"
 #include "kxf/Serialization/XML.h"
 #include "kxf/Serialization/INI.h"
@@ -0,0 +1,218 @@
+#include "KxfPCH.h"
+#include "BinaryArchive.h"
+#include "kxf/IO/IStream.h"
+#include "kxf/IO/MemoryStreamBuffer.h"
+
+namespace
+{
+	// Archive layout: header, objects in the order they were added with zero padding between them, footer. Every object is placed
+	// at an offset aligned for its type, sized objects (strings and vectors) have a 64-bit count immediately before the data.
+	constexpr uint32_t g_Magic = 0x4142584b; // 'KXBA'
+	constexpr uint32_t g_Version = 1;
+	constexpr size_t g_SizeAlignment = alignof(uint64_t);
+
+	struct ArchiveHeader final
+	{
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+	};
+	struct ArchiveFooter final
+	{
+		uint64_t Root = 0;
+		uint64_t Size = 0;
+	};
+	static_assert(sizeof(ArchiveHeader) == g_SizeAlignment && sizeof(ArchiveFooter) == 2 * g_SizeAlignment);
+
+	constexpr uint64_t AlignOffset(uint64_t offset, size_t alignment) noexcept
+	{
+		return (offset + alignment - 1) & ~static_cast<uint64_t>(alignment - 1);
+	}
+	bool IsAligned(const void* ptr, size_t alignment) noexcept
+	{
+		return (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) == 0;
+	}
+}
+
+namespace kxf
+{
+	void BinaryArchiveBuilder::DoWrite(const void* buffer, size_t size)
+	{
+		if (size != 0)
+		{
+			if (m_Stream.Write(buffer, size).LastWrite().ToBytes() != size)
+			{
+				throw BinarySerializerException("Could not write the required amount of bytes");
+			}
+			m_Offset += size;
+		}
+	}
+	void BinaryArchiveBuilder::DoPad(uint64_t size)
+	{
+		static constexpr std::byte padding[64] = {};
+		while (size != 0)
+		{
+			const size_t chunkSize = static_cast<size_t>(std::min<uint64_t>(size, std::size(padding)));
+			DoWrite(padding, chunkSize);
+			size -= chunkSize;
+		}
+	}
+	uint64_t BinaryArchiveBuilder::DoAlign(size_t alignment)
+	{
+		if (!std::has_single_bit(alignment))
+		{
+			throw BinarySerializerException("Invalid archive object alignment");
+		}
+
+		DoPad(AlignOffset(m_Offset, alignment) - m_Offset);
+		return m_Offset;
+	}
+
+	uint64_t BinaryArchiveBuilder::DoAddBuffer(const void* buffer, size_t size, size_t alignment)
+	{
+		if (m_IsFinished)
+		{
+			throw BinarySerializerException("The archive is already finished");
+		}
+
+		const uint64_t offset = DoAlign(alignment);
+		DoWrite(buffer, size);
+
+		return offset;
+	}
+	uint64_t BinaryArchiveBuilder::DoAddSizedBuffer(uint64_t count, const void* buffer, size_t size, size_t alignment, bool terminate)
+	{
+		if (m_IsFinished)
+		{
+			throw BinarySerializerException("The archive is already finished");
+		}
+
+		// The count goes right before the data and the data itself has to be aligned for the item type,
+		// so place the count such that both requirements are met.
+		alignment = std::max(alignment, g_SizeAlignment);
+		DoAlign(g_SizeAlignment);
+
+		const uint64_t offset = AlignOffset(m_Offset + sizeof(count), alignment) - sizeof(count);
+		DoPad(offset - m_Offset);
+
+		DoWrite(&count, sizeof(count));
+		DoWrite(buffer, size);
+		if (terminate)
+		{
+			const char terminator = '\0';
+			DoWrite(&terminator, sizeof(terminator));
+		}
+		return offset;
+	}
+	void BinaryArchiveBuilder::DoFinish(uint64_t root)
+	{
+		if (m_IsFinished)
+		{
+			throw BinarySerializerException("The archive is already finished");
+		}
+		if (root != 0 && root >= m_Offset)
+		{
+			throw BinarySerializerException("Archive root is outside of the archive");
+		}
+
+		ArchiveFooter footer;
+		footer.Root = root;
+		footer.Size = DoAlign(g_SizeAlignment) + sizeof(footer);
+		DoWrite(&footer, sizeof(footer));
+
+		m_IsFinished = true;
+	}
+
+	BinaryArchiveBuilder::BinaryArchiveBuilder(IOutputStream& stream)
+		:m_Stream(stream)
+	{
+		ArchiveHeader header;
+		header.Magic = g_Magic;
+		header.Version = g_Version;
+		DoWrite(&header, sizeof(header));
+	}
+}
+
+namespace kxf
+{
+	const void* BinaryArchiveReader::DoGetObject(uint64_t offset, size_t size, size_t alignment) const noexcept
+	{
+		if (m_Data.empty() || offset < sizeof(ArchiveHeader))
+		{
+			return nullptr;
+		}
+
+		const uint64_t bodySize = m_Data.size() - sizeof(ArchiveFooter);
+		if (offset > bodySize || size > bodySize - offset)
+		{
+			return nullptr;
+		}
+
+		const std::byte* ptr = m_Data.data() + offset;
+		return IsAligned(ptr, alignment) ? ptr : nullptr;
+	}
+	std::span<const std::byte> BinaryArchiveReader::DoGetSizedBuffer(uint64_t offset, size_t itemSize, size_t alignment, uint64_t& count) const noexcept
+	{
+		count = 0;
+
+		auto countPtr = static_cast<const uint64_t*>(DoGetObject(offset, sizeof(uint64_t), g_SizeAlignment));
+		if (!countPtr)
+		{
+			return {};
+		}
+
+		const uint64_t itemsOffset = offset + sizeof(uint64_t);
+		const uint64_t bodySize = m_Data.size() - sizeof(ArchiveFooter);
+		const uint64_t itemCount = *countPtr;
+		if (itemCount > (bodySize - itemsOffset) / itemSize || itemCount > std::numeric_limits<size_t>::max() / itemSize)
+		{
+			return {};
+		}
+
+		const std::byte* items = m_Data.data() + itemsOffset;
+		if (!IsAligned(items, alignment))
+		{
+			return {};
+		}
+
+		count = itemCount;
+		return {items, static_cast<size_t>(itemCount * itemSize)};
+	}
+
+	bool BinaryArchiveReader::Open(std::span<const std::byte> data) noexcept
+	{
+		Close();
+
+		if (data.size() < sizeof(ArchiveHeader) + sizeof(ArchiveFooter) || !IsAligned(data.data(), g_SizeAlignment))
+		{
+			return false;
+		}
+
+		ArchiveHeader header;
+		std::memcpy(&header, data.data(), sizeof(header));
+		if (header.Magic != g_Magic || header.Version != g_Version)
+		{
+			return false;
+		}
+
+		ArchiveFooter footer;
+		std::memcpy(&footer, data.data() + data.size() - sizeof(footer), sizeof(footer));
+		if (footer.Size != data.size() || (footer.Root != 0 && (footer.Root < sizeof(header) || footer.Root >= data.size() - sizeof(footer))))
+		{
+			return false;
+		}
+
+		m_Data = data;
+		m_Root = footer.Root;
+		return true;
+	}
+	bool BinaryArchiveReader::Open(const MemoryStreamBuffer& buffer) noexcept
+	{
+		if (auto data = buffer.GetBufferStart())
+		{
+			return Open({static_cast<const std::byte*>(data), buffer.GetBufferSize()});
+		}
+
+		Close();
+		return false;
+	}
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include "Common.h"
+#include "BinarySerializer.h"
+
+namespace kxf
+{
+	class IOutputStream;
+	class MemoryStreamBuffer;
+
+	struct ArchiveString final
+	{
+	};
+
+	template<class T>
+	struct ArchiveVector final
+	{
+	};
+
+	// Reference to an object stored in a binary archive, the offset is counted from the start of the archive so the archive
+	// can be used at any address. Zero offset is a null reference since it's always occupied by the archive header.
+	// References are trivially copyable themselves and are meant to be used as fields of the archived structs.
+	template<class T>
+	struct ArchiveRef final
+	{
+		uint64_t Offset = 0;
+
+		bool IsNull() const noexcept
+		{
+			return Offset == 0;
+		}
+	};
+}
+
+namespace kxf::Private
+{
+	template<class T>
+	constexpr bool IsArchivableType() noexcept
+	{
+		return std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T> && !std::is_pointer_v<T>;
+	}
+}
+
+namespace kxf
+{
+	// Writes an archive where every object is aligned and can be accessed directly from the memory it's stored in.
+	// Objects are written as they are added, so anything an object refers to has to be added before the object itself.
+	// The root reference goes to the footer which 'Finish' writes, the stream doesn't need to be seekable.
+	// Errors are reported with 'BinarySerializerException' just like 'BinarySerializer' does it.
+	class KX_API BinaryArchiveBuilder final
+	{
+		private:
+			IOutputStream& m_Stream;
+			uint64_t m_Offset = 0;
+			bool m_IsFinished = false;
+
+		private:
+			void DoWrite(const void* buffer, size_t size);
+			void DoPad(uint64_t size);
+			uint64_t DoAlign(size_t alignment);
+
+			uint64_t DoAddBuffer(const void* buffer, size_t size, size_t alignment);
+			uint64_t DoAddSizedBuffer(uint64_t count, const void* buffer, size_t size, size_t alignment, bool terminate);
+			void DoFinish(uint64_t root);
+
+		public:
+			BinaryArchiveBuilder(IOutputStream& stream);
+			BinaryArchiveBuilder(const BinaryArchiveBuilder&) = delete;
+
+		public:
+			uint64_t GetSize() const noexcept
+			{
+				return m_Offset;
+			}
+			bool IsFinished() const noexcept
+			{
+				return m_IsFinished;
+			}
+
+			// Strings are stored in UTF-8 with the length prefix and the null terminator
+			ArchiveRef<ArchiveString> AddString(std::string_view utf8)
+			{
+				return {DoAddSizedBuffer(utf8.size(), utf8.data(), utf8.size(), alignof(uint64_t), true)};
+			}
+			ArchiveRef<ArchiveString> AddString(const String& value)
+			{
+				return AddString(value.ToUTF8());
+			}
+
+			template<class T>
+			requires(Private::IsArchivableType<T>())
+			ArchiveRef<ArchiveVector<T>> AddVector(std::span<const T> items)
+			{
+				return {DoAddSizedBuffer(items.size(), items.data(), items.size_bytes(), alignof(T), false)};
+			}
+
+			template<class T>
+			requires(Private::IsArchivableType<T>())
+			ArchiveRef<T> AddStruct(const T& value)
+			{
+				return {DoAddBuffer(&value, sizeof(T), alignof(T))};
+			}
+
+			template<class T>
+			void Finish(ArchiveRef<T> root)
+			{
+				DoFinish(root.Offset);
+			}
+
+		public:
+			BinaryArchiveBuilder& operator=(const BinaryArchiveBuilder&) = delete;
+	};
+
+	// Gives typed access to an archive in place. Nothing is copied or allocated, every reference is checked against the
+	// archive bounds and the alignment of its type and resolves to null or an empty view if it doesn't fit. The memory
+	// must outlive the reader and every view taken from it.
+	class KX_API BinaryArchiveReader final
+	{
+		private:
+			std::span<const std::byte> m_Data;
+			uint64_t m_Root = 0;
+
+		private:
+			const void* DoGetObject(uint64_t offset, size_t size, size_t alignment) const noexcept;
+			std::span<const std::byte> DoGetSizedBuffer(uint64_t offset, size_t itemSize, size_t alignment, uint64_t& count) const noexcept;
+
+		public:
+			BinaryArchiveReader() noexcept = default;
+			BinaryArchiveReader(std::span<const std::byte> data) noexcept
+			{
+				Open(data);
+			}
+			BinaryArchiveReader(const MemoryStreamBuffer& buffer) noexcept
+			{
+				Open(buffer);
+			}
+
+		public:
+			bool IsNull() const noexcept
+			{
+				return m_Data.empty();
+			}
+			std::span<const std::byte> GetData() const noexcept
+			{
+				return m_Data;
+			}
+
+			// The data has to end where the archive ends since the footer is at the very end. Validates the header and the footer only,
+			// the objects themselves are checked when they're accessed.
+			bool Open(std::span<const std::byte> data) noexcept;
+			bool Open(const MemoryStreamBuffer& buffer) noexcept;
+			void Close() noexcept
+			{
+				m_Data = {};
+				m_Root = 0;
+			}
+
+			template<class T>
+			ArchiveRef<T> GetRoot() const noexcept
+			{
+				return {m_Root};
+			}
+
+			template<class T>
+			requires(Private::IsArchivableType<T>())
+			const T* Get(ArchiveRef<T> ref) const noexcept
+			{
+				return static_cast<const T*>(DoGetObject(ref.Offset, sizeof(T), alignof(T)));
+			}
+
+			std::string_view Get(ArchiveRef<ArchiveString> ref) const noexcept
+			{
+				uint64_t length = 0;
+				auto buffer = DoGetSizedBuffer(ref.Offset, sizeof(char), alignof(uint64_t), length);
+
+				return {reinterpret_cast<const char*>(buffer.data()), buffer.size()};
+			}
+			String GetString(ArchiveRef<ArchiveString> ref) const
+			{
+				return String::FromUTF8(Get(ref));
+			}
+
+			template<class T>
+			requires(Private::IsArchivableType<T>())
+			std::span<const T> Get(ArchiveRef<ArchiveVector<T>> ref) const noexcept
+			{
+				uint64_t count = 0;
+				auto buffer = DoGetSizedBuffer(ref.Offset, sizeof(T), alignof(T), count);
+
+				return {reinterpret_cast<const T*>(buffer.data()), static_cast<size_t>(count)};
+			}
+
+		public:
+			explicit operator bool() const noexcept
+			{
+				return !IsNull();
+			}
+			bool operator!() const noexcept
+			{
+				return IsNull();
+			}
+	};
+}
@@ -5,6 +5,34 @@
 
 namespace
 {
+	using kxf::Serialization::WireFormat;
+
+	thread_local WireFormat g_WireFormat = WireFormat::Fixed;
+
+	// LEB128 encoding of a 64-bit value takes 10 bytes at most
+	constexpr size_t g_MaxVarIntSize = 10;
+
+	size_t EncodeVarInt(uint64_t value, uint8_t* buffer) noexcept
+	{
+		size_t size = 0;
+		while (value >= 0x80u)
+		{
+			buffer[size++] = static_cast<uint8_t>(value|0x80u);
+			value >>= 7;
+		}
+		buffer[size++] = static_cast<uint8_t>(value);
+
+		return size;
+	}
+	constexpr uint64_t EncodeZigZag(int64_t value) noexcept
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+	constexpr int64_t DecodeZigZag(uint64_t value) noexcept
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
 	uint64_t WriteBuffer(kxf::IOutputStream& stream, const void* buffer, size_t length)
 	{
 		uint64_t written = stream.Write(buffer, length).LastWrite().ToBytes();
@@ -23,6 +51,56 @@ namespace
 		}
 		return read;
 	}
+	uint64_t ReadVarInt(kxf::IInputStream& stream, uint64_t& value)
+	{
+		value = 0;
+
+		uint64_t read = 0;
+		for (size_t shift = 0; ; shift += 7)
+		{
+			uint8_t byte = 0;
+			read += ReadBuffer(stream, &byte, 1);
+
+			// The tenth byte can only carry the highest bit
+			if (shift == 63 && byte > 1)
+			{
+				throw kxf::BinarySerializerException("Invalid varint");
+			}
+			value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+
+			if ((byte & 0x80u) == 0)
+			{
+				return read;
+			}
+		}
+	}
+	uint64_t WriteSizedBuffer(kxf::IOutputStream& stream, uint64_t size, const void* buffer, size_t length)
+	{
+		uint8_t prefix[g_MaxVarIntSize] = {};
+		size_t prefixSize = sizeof(size);
+		if (g_WireFormat == WireFormat::Compact)
+		{
+			prefixSize = EncodeVarInt(size, prefix);
+		}
+		else
+		{
+			std::memcpy(prefix, &size, sizeof(size));
+		}
+
+		// The size prefix and the data are passed to the stream in a single vectored write
+		const std::span<const std::byte> buffers[] =
+		{
+			std::as_bytes(std::span(prefix, prefixSize)),
+			{static_cast<const std::byte*>(buffer), length}
+		};
+
+		uint64_t written = stream.WriteV(buffers).LastWrite().ToBytes();
+		if (written != prefixSize + length)
+		{
+			throw kxf::BinarySerializerException("Could not write the required amount of bytes");
+		}
+		return written;
+	}
 }
 
 namespace kxf
@@ -49,6 +127,23 @@ namespace kxf
 	}
 }
 
+namespace kxf::Serialization
+{
+	WireFormat GetWireFormat() noexcept
+	{
+		return g_WireFormat;
+	}
+
+	ScopedWireFormat::ScopedWireFormat(WireFormat format) noexcept
+		:m_PreviousFormat(std::exchange(g_WireFormat, format))
+	{
+	}
+	ScopedWireFormat::~ScopedWireFormat() noexcept
+	{
+		g_WireFormat = m_PreviousFormat;
+	}
+}
+
 namespace kxf::Private
 {
 	uint64_t BufferBinarySerializer::DoWriteBuffer(IOutputStream& stream, const void* buffer, size_t length) const
@@ -59,13 +154,56 @@ namespace kxf::Private
 	{
 		return ReadBuffer(stream, buffer, length);
 	}
+	uint64_t BufferBinarySerializer::DoWriteSizedBuffer(IOutputStream& stream, uint64_t size, const void* buffer, size_t length) const
+	{
+		return WriteSizedBuffer(stream, size, buffer, length);
+	}
 
 	uint64_t IntBinarySerializer::DoSerializeInteger(IOutputStream& stream, const void* buffer, size_t length, bool isSigned) const
 	{
+		// Single bytes gain nothing from the varint encoding
+		if (g_WireFormat == WireFormat::Compact && length > 1)
+		{
+			uint64_t value = 0;
+			std::memcpy(&value, buffer, length);
+
+			if (isSigned)
+			{
+				// Sign-extend to 64 bits so that small negative numbers stay small after the zigzag encoding
+				const size_t shift = (sizeof(value) - length) * 8;
+				value = EncodeZigZag(static_cast<int64_t>(value << shift) >> shift);
+			}
+
+			uint8_t bytes[g_MaxVarIntSize] = {};
+			return WriteBuffer(stream, bytes, EncodeVarInt(value, bytes));
+		}
 		return WriteBuffer(stream, buffer, length);
 	}
 	uint64_t IntBinarySerializer::DoDeserializeInteger(IInputStream& stream, void* buffer, size_t length, bool isSigned) const
 	{
+		if (g_WireFormat == WireFormat::Compact && length > 1)
+		{
+			uint64_t value = 0;
+			uint64_t read = ReadVarInt(stream, value);
+
+			const size_t shift = (sizeof(value) - length) * 8;
+			if (isSigned)
+			{
+				const int64_t signedValue = DecodeZigZag(value);
+				if ((static_cast<int64_t>(static_cast<uint64_t>(signedValue) << shift) >> shift) != signedValue)
+				{
+					throw BinarySerializerException("Integer value is out of range");
+				}
+				value = static_cast<uint64_t>(signedValue);
+			}
+			else if (((value << shift) >> shift) != value)
+			{
+				throw BinarySerializerException("Integer value is out of range");
+			}
+
+			std::memcpy(buffer, &value, length);
+			return read;
+		}
 		return ReadBuffer(stream, buffer, length);
 	}
 
@@ -80,7 +218,7 @@ namespace kxf::Private
 
 	uint64_t StringBinarySerializer::DoSerializeString(IOutputStream& stream, const void* buffer, size_t length) const
 	{
-		return Serialization::WriteObject(stream, static_cast<uint64_t>(length)) + WriteBuffer(stream, buffer, length);
+		return WriteSizedBuffer(stream, length, buffer, length);
 	}
 	uint64_t StringBinarySerializer::DoDeserializeString(IInputStream& stream, void* buffer, size_t& length) const
 	{
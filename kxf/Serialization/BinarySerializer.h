@@ -28,6 +28,37 @@ namespace kxf
 			BinarySerializerException(const String& message);
 	};
 }
+namespace kxf::Serialization
+{
+	enum class WireFormat
+	{
+		// Every integer is written at its full width, lengths of strings and containers as 64-bit integers
+		Fixed,
+
+		// Integers wider than a byte and all lengths are written as LEB128 varints, signed values are zigzag-encoded first.
+		// Contents of containers of trivially copyable types are still written as they are, with a single write.
+		Compact
+	};
+
+	WireFormat GetWireFormat() noexcept;
+
+	// Switches the wire format of the current thread for the lifetime of the object. The format isn't recorded
+	// in the output, so the data must be read back with the same format it was written with.
+	class ScopedWireFormat final
+	{
+		private:
+			WireFormat m_PreviousFormat = WireFormat::Fixed;
+
+		public:
+			ScopedWireFormat(WireFormat format) noexcept;
+			ScopedWireFormat(const ScopedWireFormat&) = delete;
+			~ScopedWireFormat() noexcept;
+
+		public:
+			ScopedWireFormat& operator=(const ScopedWireFormat&) = delete;
+	};
+}
+
 namespace kxf::Serialization
 {
 	template<class TValue>
@@ -96,6 +127,9 @@ namespace kxf::Private
 		protected:
 			uint64_t DoWriteBuffer(IOutputStream& stream, const void* buffer, size_t length) const;
 			uint64_t DoReadBuffer(IInputStream& stream, void* buffer, size_t length) const;
+
+			// Writes the item count followed by the buffer itself
+			uint64_t DoWriteSizedBuffer(IOutputStream& stream, uint64_t size, const void* buffer, size_t length) const;
 	};
 
 	class IntBinarySerializer
@@ -387,19 +421,19 @@ namespace kxf
 	{
 		uint64_t Serialize(IOutputStream& stream, const std::array<T, N>& value) const
 		{
-			uint64_t written = Serialization::WriteObject(stream, static_cast<uint64_t>(N));
 			if constexpr(std::is_trivially_copyable_v<T>)
 			{
-				written += DoWriteBuffer(stream, value.data(), N * sizeof(T));
+				return DoWriteSizedBuffer(stream, N, value.data(), N * sizeof(T));
 			}
 			else
 			{
+				uint64_t written = Serialization::WriteObject(stream, static_cast<uint64_t>(N));
 				for (const auto& item: value)
 				{
 					written += Serialization::WriteObject(stream, item);
 				}
+				return written;
 			}
-			return written;
 		}
 		uint64_t Deserialize(IInputStream& stream, std::array<T, N>& value) const
 		{
@@ -430,19 +464,19 @@ namespace kxf
 	{
 		uint64_t Serialize(IOutputStream& stream, const std::vector<T>& value) const
 		{
-			uint64_t written = Serialization::WriteObject(stream, static_cast<uint64_t>(value.size()));
 			if constexpr(std::is_trivially_copyable_v<T>)
 			{
-				written += DoWriteBuffer(stream, value.data(), value.size() * sizeof(T));
+				return DoWriteSizedBuffer(stream, value.size(), value.data(), value.size() * sizeof(T));
 			}
 			else
 			{
+				uint64_t written = Serialization::WriteObject(stream, static_cast<uint64_t>(value.size()));
 				for (const auto& item: value)
 				{
 					written += Serialization::WriteObject(stream, item);
 				}
+				return written;
 			}
-			return written;
 		}
 		uint64_t Deserialize(IInputStream& stream, std::vector<T>& value) const
 		{
@@ -1,2 +1,6 @@
 #pragma once
 #include "JSON/JSONDocument.h"
+#include "JSON/JSONStreamReader.h"
+#include "JSON/JSONStreamWriter.h"
+#include "JSON/JSONStreamSerializer.h"
+#include "JSON/JSONView.h"
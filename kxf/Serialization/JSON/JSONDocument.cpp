@@ -1,7 +1,8 @@
 #include "KxfPCH.h"
 #include "JSONDocument.h"
+#include "JSONStreamReader.h"
+#include "JSONStreamWriter.h"
 #include "kxf/Network/URI.h"
-#include "kxf/IO/StreamReaderWriter.h"
 #include "kxf/Utility/SoftwareLicenseDB.h"
 #include <wx/string.h>
 
@@ -27,8 +28,9 @@ namespace kxf
 	{
 		try
 		{
-			std::string string = AsBase().dump(1, '\t');
-			return stream.WriteAll(string.data(), string.length());
+			// Write directly to the stream instead of making the whole text in memory first
+			JSONStreamWriter writer(stream, 1, '\t');
+			return writer.WriteValue(AsBase()) && writer.Flush();
 		}
 		catch (...)
 		{
@@ -51,21 +53,28 @@ namespace kxf
 	}
 	bool JSONDocument::Load(IInputStream& stream)
 	{
-		if (auto size = stream.GetSize())
+		try
 		{
-			try
+			// Parse the stream memory in place if it's available
+			if (auto size = stream.GetSize())
 			{
-				IO::InputStreamReader reader(stream);
-
-				AsBase() = nlohmann::json::parse(reader.ReadStdString(size.ToBytes()), nullptr, false);
-				return this->empty();
+				if (auto view = stream.ReadView(size.ToBytes()); !view.empty())
+				{
+					const auto data = reinterpret_cast<const char*>(view.data());
+					AsBase() = nlohmann::json::parse(data, data + view.size(), nullptr, false);
+					return this->empty();
+				}
 			}
-			catch (...)
+
+			// Otherwise parse it as it's read, without loading the whole text first
+			JSONStreamReader reader(stream);
+			if (!reader.ReadValue(AsBase()) || reader.Next() != JSONToken::End)
 			{
-				this->clear();
+				AsBase() = nlohmann::json(nlohmann::json::value_t::discarded);
 			}
+			return this->empty();
 		}
-		else
+		catch (...)
 		{
 			this->clear();
 		}
@@ -0,0 +1,756 @@
+#include "KxfPCH.h"
+#include "JSONStreamReader.h"
+#include "Private/UTF8.h"
+#include <charconv>
+
+namespace
+{
+	constexpr bool IsWhitespace(int c) noexcept
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+	constexpr bool IsDigit(int c) noexcept
+	{
+		return c >= '0' && c <= '9';
+	}
+	constexpr bool IsNumberChar(int c) noexcept
+	{
+		return IsDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+	}
+	constexpr int HexDigitValue(int c) noexcept
+	{
+		if (c >= '0' && c <= '9')
+		{
+			return c - '0';
+		}
+		else if (c >= 'a' && c <= 'f')
+		{
+			return c - 'a' + 10;
+		}
+		else if (c >= 'A' && c <= 'F')
+		{
+			return c - 'A' + 10;
+		}
+		return -1;
+	}
+
+	// Checks the number against the JSON grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+	bool IsValidNumber(std::string_view number, bool& isInteger) noexcept
+	{
+		size_t i = 0;
+		auto SkipDigits = [&]()
+		{
+			const size_t start = i;
+			while (i < number.size() && IsDigit(number[i]))
+			{
+				i++;
+			}
+			return i != start;
+		};
+
+		isInteger = true;
+		if (i < number.size() && number[i] == '-')
+		{
+			i++;
+		}
+		if (i < number.size() && number[i] == '0')
+		{
+			i++;
+		}
+		else if (!SkipDigits())
+		{
+			return false;
+		}
+
+		if (i < number.size() && number[i] == '.')
+		{
+			i++;
+			isInteger = false;
+			if (!SkipDigits())
+			{
+				return false;
+			}
+		}
+		if (i < number.size() && (number[i] == 'e' || number[i] == 'E'))
+		{
+			i++;
+			isInteger = false;
+			if (i < number.size() && (number[i] == '+' || number[i] == '-'))
+			{
+				i++;
+			}
+			if (!SkipDigits())
+			{
+				return false;
+			}
+		}
+		return i == number.size();
+	}
+
+	// For a number 'from_chars' has rejected as out of range, tells whether it's too small rather than too large
+	bool IsUnderflow(std::string_view number) noexcept
+	{
+		const size_t exponent = number.find_first_of("eE");
+		return exponent != number.npos && exponent + 1 < number.size() && number[exponent + 1] == '-';
+	}
+
+	void AppendUTF8(std::string& buffer, uint32_t c)
+	{
+		if (c < 0x80)
+		{
+			buffer += static_cast<char>(c);
+		}
+		else if (c < 0x800)
+		{
+			buffer += static_cast<char>(0xC0|(c >> 6));
+			buffer += static_cast<char>(0x80|(c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			buffer += static_cast<char>(0xE0|(c >> 12));
+			buffer += static_cast<char>(0x80|((c >> 6) & 0x3F));
+			buffer += static_cast<char>(0x80|(c & 0x3F));
+		}
+		else
+		{
+			buffer += static_cast<char>(0xF0|(c >> 18));
+			buffer += static_cast<char>(0x80|((c >> 12) & 0x3F));
+			buffer += static_cast<char>(0x80|((c >> 6) & 0x3F));
+			buffer += static_cast<char>(0x80|(c & 0x3F));
+		}
+	}
+}
+
+namespace kxf
+{
+	bool JSONStreamReader::FillBuffer()
+	{
+		if (m_EndOfStream)
+		{
+			return false;
+		}
+		m_ChunkOffset += m_Size;
+		m_Position = 0;
+		m_Size = 0;
+
+		// Use the stream memory directly when it's available, copy into the own buffer otherwise
+		if (auto view = m_Stream.ReadView(m_Buffer.size()); !view.empty())
+		{
+			m_Data = reinterpret_cast<const char*>(view.data());
+			m_Size = view.size();
+			return true;
+		}
+
+		const DataSize read = m_Stream.Read(m_Buffer.data(), m_Buffer.size()).LastRead();
+		if (read.IsValid() && read.ToBytes() > 0)
+		{
+			m_Data = m_Buffer.data();
+			m_Size = read.ToBytes<size_t>();
+			return true;
+		}
+
+		m_Data = nullptr;
+		m_EndOfStream = true;
+		return false;
+	}
+	int JSONStreamReader::SkipWhitespace()
+	{
+		int c = PeekChar();
+		while (IsWhitespace(c))
+		{
+			m_Position++;
+			c = PeekChar();
+		}
+		return c;
+	}
+
+	JSONToken JSONStreamReader::SetError(const char* message)
+	{
+		m_ErrorMessage = message;
+		m_ErrorOffset = GetOffset();
+		m_Value.clear();
+		m_Stack.clear();
+		m_State = State::Done;
+
+		return m_Token = JSONToken::Error;
+	}
+	JSONToken JSONStreamReader::EndValue(JSONToken token) noexcept
+	{
+		m_State = m_Stack.empty() ? State::Done : State::CommaOrEnd;
+		return m_Token = token;
+	}
+
+	JSONToken JSONStreamReader::ParseValue(int c)
+	{
+		switch (c)
+		{
+			case '{':
+			{
+				m_Position++;
+				m_Stack.push_back(true);
+				m_State = State::FirstKeyOrEnd;
+				return m_Token = JSONToken::BeginObject;
+			}
+			case '[':
+			{
+				m_Position++;
+				m_Stack.push_back(false);
+				m_State = State::FirstValueOrEnd;
+				return m_Token = JSONToken::BeginArray;
+			}
+			case '"':
+			{
+				return ParseString(JSONToken::String);
+			}
+			case 't':
+			{
+				m_Boolean = true;
+				return ParseLiteral("true", JSONToken::Boolean);
+			}
+			case 'f':
+			{
+				m_Boolean = false;
+				return ParseLiteral("false", JSONToken::Boolean);
+			}
+			case 'n':
+			{
+				return ParseLiteral("null", JSONToken::Null);
+			}
+			case -1:
+			{
+				return SetError("Unexpected end of input");
+			}
+		};
+
+		if (c == '-' || IsDigit(c))
+		{
+			return ParseNumber();
+		}
+		return SetError("Unexpected character, expected a value");
+	}
+	JSONToken JSONStreamReader::ParseKey()
+	{
+		if (PeekChar() != '"')
+		{
+			return SetError("Expected an object key");
+		}
+		if (ParseString(JSONToken::Key) == JSONToken::Error)
+		{
+			return JSONToken::Error;
+		}
+
+		if (SkipWhitespace() != ':')
+		{
+			return SetError("Expected ':' after an object key");
+		}
+		m_Position++;
+
+		m_State = State::Value;
+		return m_Token = JSONToken::Key;
+	}
+	JSONToken JSONStreamReader::ParseString(JSONToken token)
+	{
+		// Skip the opening quote
+		m_Position++;
+		m_Value.clear();
+
+		// Raw bytes are validated the same way 'JSONView' does it, a sequence can be split between two buffer fills
+		JSON::Private::UTF8State utf8State;
+
+		while (true)
+		{
+			if (m_Position == m_Size && !FillBuffer())
+			{
+				return SetError("Unexpected end of input inside a string");
+			}
+
+			// Copy the run of plain characters at once
+			const size_t start = m_Position;
+			while (m_Position != m_Size)
+			{
+				const auto c = static_cast<unsigned char>(m_Data[m_Position]);
+				if (c == '"' || c == '\\' || c < 0x20)
+				{
+					break;
+				}
+				m_Position++;
+			}
+			if (const size_t invalid = JSON::Private::ValidateUTF8(m_Data + start, m_Position - start, utf8State); invalid != m_Position - start)
+			{
+				m_Position = start + invalid;
+				return SetError("Invalid UTF-8 sequence in a string");
+			}
+			m_Value.append(m_Data + start, m_Position - start);
+
+			if (m_Position != m_Size)
+			{
+				// Escapes, the closing quote and control characters can't continue a multibyte sequence
+				if (utf8State.Remaining != 0)
+				{
+					return SetError("Invalid UTF-8 sequence in a string");
+				}
+				const auto c = static_cast<unsigned char>(m_Data[m_Position]);
+				if (c == '"')
+				{
+					m_Position++;
+					if (token == JSONToken::String)
+					{
+						return EndValue(token);
+					}
+					return m_Token = token;
+				}
+				else if (c == '\\')
+				{
+					m_Position++;
+					if (!ParseEscape())
+					{
+						return JSONToken::Error;
+					}
+				}
+				else
+				{
+					return SetError("Control characters must be escaped in strings");
+				}
+			}
+		}
+	}
+	bool JSONStreamReader::ParseEscape()
+	{
+		auto ReadHex = [&](uint32_t& value)
+		{
+			value = 0;
+			for (size_t i = 0; i < 4; i++)
+			{
+				const int digit = HexDigitValue(PeekChar());
+				if (digit < 0)
+				{
+					return false;
+				}
+				value = (value << 4)|static_cast<uint32_t>(digit);
+				m_Position++;
+			}
+			return true;
+		};
+
+		const int c = PeekChar();
+		if (c != -1)
+		{
+			m_Position++;
+		}
+		switch (c)
+		{
+			case '"':
+			case '\\':
+			case '/':
+			{
+				m_Value += static_cast<char>(c);
+				return true;
+			}
+			case 'b':
+			{
+				m_Value += '\b';
+				return true;
+			}
+			case 'f':
+			{
+				m_Value += '\f';
+				return true;
+			}
+			case 'n':
+			{
+				m_Value += '\n';
+				return true;
+			}
+			case 'r':
+			{
+				m_Value += '\r';
+				return true;
+			}
+			case 't':
+			{
+				m_Value += '\t';
+				return true;
+			}
+			case 'u':
+			{
+				uint32_t codePoint = 0;
+				if (!ReadHex(codePoint))
+				{
+					SetError("Invalid '\\u' escape sequence");
+					return false;
+				}
+
+				if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+				{
+					// High surrogate, has to be followed by an escaped low one
+					uint32_t lowSurrogate = 0;
+					if (PeekChar() != '\\' || (m_Position++, PeekChar() != 'u') || (m_Position++, !ReadHex(lowSurrogate)) || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF)
+					{
+						SetError("Unpaired UTF-16 surrogate in a '\\u' escape sequence");
+						return false;
+					}
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+				}
+				else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+				{
+					SetError("Unpaired UTF-16 surrogate in a '\\u' escape sequence");
+					return false;
+				}
+
+				AppendUTF8(m_Value, codePoint);
+				return true;
+			}
+		};
+
+		SetError("Invalid escape sequence");
+		return false;
+	}
+	JSONToken JSONStreamReader::ParseNumber()
+	{
+		m_Value.clear();
+		for (int c = PeekChar(); IsNumberChar(c); c = PeekChar())
+		{
+			m_Value += static_cast<char>(c);
+			m_Position++;
+		}
+
+		bool isInteger = false;
+		if (!IsValidNumber(m_Value, isInteger))
+		{
+			return SetError("Invalid number");
+		}
+
+		const char* first = m_Value.data();
+		const char* last = first + m_Value.size();
+		if (isInteger)
+		{
+			if (m_Value.front() == '-')
+			{
+				if (std::from_chars(first, last, m_Integer).ec == std::errc())
+				{
+					return EndValue(JSONToken::Integer);
+				}
+			}
+			else if (std::from_chars(first, last, m_UnsignedInteger).ec == std::errc())
+			{
+				return EndValue(JSONToken::UnsignedInteger);
+			}
+		}
+
+		// Either not an integer or out of the 64-bit range, the grammar check guarantees the format is fine for 'from_chars'.
+		// Like the DOM parser does it, values too small to be represented become zero and too large ones are an error.
+		if (auto result = std::from_chars(first, last, m_Float); result.ec == std::errc())
+		{
+			return EndValue(JSONToken::Float);
+		}
+		else if (result.ec == std::errc::result_out_of_range && IsUnderflow(m_Value))
+		{
+			m_Float = m_Value.front() == '-' ? -0.0 : 0.0;
+			return EndValue(JSONToken::Float);
+		}
+		return SetError("Number is out of range");
+	}
+	JSONToken JSONStreamReader::ParseLiteral(std::string_view literal, JSONToken token)
+	{
+		for (char c: literal)
+		{
+			if (PeekChar() != c)
+			{
+				return SetError("Invalid literal");
+			}
+			m_Position++;
+		}
+		m_Value = literal;
+
+		return EndValue(token);
+	}
+
+	JSONStreamReader::JSONStreamReader(IInputStream& stream, size_t bufferSize)
+		:m_Stream(stream), m_Buffer(std::max<size_t>(bufferSize, 1))
+	{
+		// Skip UTF-8 BOM if there's one
+		if (PeekChar() == 0xEF)
+		{
+			m_Position++;
+			if (PeekChar() != 0xBB || (m_Position++, PeekChar() != 0xBF))
+			{
+				SetError("Invalid UTF-8 byte order mark");
+				return;
+			}
+			m_Position++;
+		}
+	}
+
+	JSONToken JSONStreamReader::Next()
+	{
+		if (m_Token == JSONToken::End || m_Token == JSONToken::Error)
+		{
+			return m_Token;
+		}
+
+		while (true)
+		{
+			const int c = SkipWhitespace();
+			switch (m_State)
+			{
+				case State::Value:
+				{
+					return ParseValue(c);
+				}
+				case State::FirstValueOrEnd:
+				{
+					if (c == ']')
+					{
+						m_Position++;
+						m_Stack.pop_back();
+						return EndValue(JSONToken::EndArray);
+					}
+					return ParseValue(c);
+				}
+				case State::FirstKeyOrEnd:
+				{
+					if (c == '}')
+					{
+						m_Position++;
+						m_Stack.pop_back();
+						return EndValue(JSONToken::EndObject);
+					}
+					return ParseKey();
+				}
+				case State::Key:
+				{
+					return ParseKey();
+				}
+				case State::CommaOrEnd:
+				{
+					const bool isObject = m_Stack.back();
+					if (c == ',')
+					{
+						m_Position++;
+						m_State = isObject ? State::Key : State::Value;
+						continue;
+					}
+					else if (c == (isObject ? '}' : ']'))
+					{
+						m_Position++;
+						m_Stack.pop_back();
+						return EndValue(isObject ? JSONToken::EndObject : JSONToken::EndArray);
+					}
+					else if (c == -1)
+					{
+						return SetError("Unexpected end of input");
+					}
+					return SetError(isObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+				}
+				case State::Done:
+				{
+					if (c == -1)
+					{
+						m_Value.clear();
+						return m_Token = JSONToken::End;
+					}
+					return SetError("Unexpected data after the end of the document");
+				}
+			};
+		}
+	}
+
+	bool JSONStreamReader::SkipValue()
+	{
+		if (m_Token == JSONToken::BeginObject || m_Token == JSONToken::BeginArray)
+		{
+			const size_t depth = m_Stack.size() - 1;
+			while (m_Stack.size() != depth)
+			{
+				if (auto token = Next(); token == JSONToken::Error || token == JSONToken::End)
+				{
+					return false;
+				}
+			}
+		}
+		return m_Token != JSONToken::Error;
+	}
+	bool JSONStreamReader::ReadValue(nlohmann::json& value)
+	{
+		std::vector<nlohmann::json*> stack;
+		std::string key;
+
+		auto AddValue = [&](nlohmann::json item) -> nlohmann::json&
+		{
+			if (stack.empty())
+			{
+				value = std::move(item);
+				return value;
+			}
+
+			nlohmann::json& container = *stack.back();
+			if (container.is_object())
+			{
+				nlohmann::json& slot = container[key];
+				slot = std::move(item);
+				return slot;
+			}
+			else
+			{
+				container.push_back(std::move(item));
+				return container.back();
+			}
+		};
+
+		do
+		{
+			switch (Next())
+			{
+				case JSONToken::BeginObject:
+				{
+					stack.push_back(&AddValue(nlohmann::json::object()));
+					break;
+				}
+				case JSONToken::BeginArray:
+				{
+					stack.push_back(&AddValue(nlohmann::json::array()));
+					break;
+				}
+				case JSONToken::EndObject:
+				case JSONToken::EndArray:
+				{
+					if (stack.empty())
+					{
+						// The caller asked for a value where its container ends
+						return false;
+					}
+					stack.pop_back();
+					break;
+				}
+				case JSONToken::Key:
+				{
+					if (stack.empty())
+					{
+						return false;
+					}
+					key = std::move(m_Value);
+					break;
+				}
+				case JSONToken::String:
+				{
+					AddValue(std::move(m_Value));
+					break;
+				}
+				case JSONToken::Integer:
+				{
+					AddValue(m_Integer);
+					break;
+				}
+				case JSONToken::UnsignedInteger:
+				{
+					AddValue(m_UnsignedInteger);
+					break;
+				}
+				case JSONToken::Float:
+				{
+					AddValue(m_Float);
+					break;
+				}
+				case JSONToken::Boolean:
+				{
+					AddValue(m_Boolean);
+					break;
+				}
+				case JSONToken::Null:
+				{
+					AddValue(nullptr);
+					break;
+				}
+				default:
+				{
+					return false;
+				}
+			};
+		}
+		while (!stack.empty());
+
+		return true;
+	}
+	bool JSONStreamReader::Parse(nlohmann::json_sax<nlohmann::json>& handler)
+	{
+		constexpr size_t unknownSize = std::numeric_limits<size_t>::max();
+
+		while (true)
+		{
+			bool result = false;
+			switch (Next())
+			{
+				case JSONToken::BeginObject:
+				{
+					result = handler.start_object(unknownSize);
+					break;
+				}
+				case JSONToken::EndObject:
+				{
+					result = handler.end_object();
+					break;
+				}
+				case JSONToken::BeginArray:
+				{
+					result = handler.start_array(unknownSize);
+					break;
+				}
+				case JSONToken::EndArray:
+				{
+					result = handler.end_array();
+					break;
+				}
+				case JSONToken::Key:
+				{
+					result = handler.key(m_Value);
+					break;
+				}
+				case JSONToken::String:
+				{
+					result = handler.string(m_Value);
+					break;
+				}
+				case JSONToken::Integer:
+				{
+					result = handler.number_integer(m_Integer);
+					break;
+				}
+				case JSONToken::UnsignedInteger:
+				{
+					result = handler.number_unsigned(m_UnsignedInteger);
+					break;
+				}
+				case JSONToken::Float:
+				{
+					result = handler.number_float(m_Float, m_Value);
+					break;
+				}
+				case JSONToken::Boolean:
+				{
+					result = handler.boolean(m_Boolean);
+					break;
+				}
+				case JSONToken::Null:
+				{
+					result = handler.null();
+					break;
+				}
+				case JSONToken::End:
+				{
+					return true;
+				}
+				default:
+				{
+					auto message = m_ErrorMessage.ToUTF8();
+					handler.parse_error(m_ErrorOffset, {}, nlohmann::json::parse_error::create(101, m_ErrorOffset, message, nullptr));
+					return false;
+				}
+			};
+
+			if (!result)
+			{
+				return false;
+			}
+		}
+	}
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include "../Common.h"
+#include "kxf/IO/IStream.h"
+#include <nlohmann/json.hpp>
+
+namespace kxf
+{
+	enum class JSONToken
+	{
+		None = -1,
+
+		BeginObject,
+		EndObject,
+		BeginArray,
+		EndArray,
+		Key,
+
+		String,
+		Integer,
+		UnsignedInteger,
+		Float,
+		Boolean,
+		Null,
+
+		End,
+		Error
+	};
+}
+
+namespace kxf
+{
+	// Pull parser reading JSON from a stream through a fixed-size buffer, memory use doesn't depend on the size of the document
+	// (only on the length of the longest string and the nesting depth). Numbers follow 'nlohmann::json' conventions: negative
+	// integers are 'Integer', non-negative ones are 'UnsignedInteger' and integers not fitting 64 bits are read as 'Float'.
+	class KX_API JSONStreamReader final
+	{
+		public:
+			static constexpr size_t DefaultBufferSize = 64 * 1024;
+
+		private:
+			enum class State: uint8_t
+			{
+				Value,
+				FirstValueOrEnd,
+				FirstKeyOrEnd,
+				Key,
+				CommaOrEnd,
+				Done
+			};
+
+		private:
+			IInputStream& m_Stream;
+			std::vector<char> m_Buffer;
+			const char* m_Data = nullptr;
+			size_t m_Size = 0;
+			size_t m_Position = 0;
+			uint64_t m_ChunkOffset = 0;
+			bool m_EndOfStream = false;
+
+			std::vector<bool> m_Stack;
+			State m_State = State::Value;
+			JSONToken m_Token = JSONToken::None;
+
+			std::string m_Value;
+			int64_t m_Integer = 0;
+			uint64_t m_UnsignedInteger = 0;
+			double m_Float = 0;
+			bool m_Boolean = false;
+
+			String m_ErrorMessage;
+			uint64_t m_ErrorOffset = 0;
+
+		private:
+			bool FillBuffer();
+			int PeekChar()
+			{
+				if (m_Position != m_Size || FillBuffer())
+				{
+					return static_cast<unsigned char>(m_Data[m_Position]);
+				}
+				return -1;
+			}
+			int SkipWhitespace();
+
+			JSONToken SetError(const char* message);
+			JSONToken EndValue(JSONToken token) noexcept;
+
+			JSONToken ParseValue(int c);
+			JSONToken ParseKey();
+			JSONToken ParseString(JSONToken token);
+			JSONToken ParseNumber();
+			JSONToken ParseLiteral(std::string_view literal, JSONToken token);
+			bool ParseEscape();
+
+		public:
+			JSONStreamReader(IInputStream& stream, size_t bufferSize = DefaultBufferSize);
+			JSONStreamReader(const JSONStreamReader&) = delete;
+
+		public:
+			// Reads the next token, 'End' and 'Error' are final and are returned for all subsequent calls
+			JSONToken Next();
+			JSONToken GetToken() const noexcept
+			{
+				return m_Token;
+			}
+
+			// Number of containers the reader is currently inside of, 'BeginObject' and 'BeginArray' are already counted
+			size_t GetDepth() const noexcept
+			{
+				return m_Stack.size();
+			}
+
+			// Position of the next unread byte in the stream
+			uint64_t GetOffset() const noexcept
+			{
+				return m_ChunkOffset + m_Position;
+			}
+
+			// Skips over the object or array the current token begins, does nothing for other tokens
+			bool SkipValue();
+
+			// Reads the next value into a DOM fragment, useful to materialize parts of a large document one at a time
+			bool ReadValue(nlohmann::json& value);
+
+			// Feeds the rest of the document to a SAX handler, stops as soon as the handler returns false
+			bool Parse(nlohmann::json_sax<nlohmann::json>& handler);
+
+		public:
+			// Key and string tokens are unescaped UTF-8, number tokens keep their original text
+			std::string_view GetUTF8() const noexcept
+			{
+				return m_Value;
+			}
+			String GetString() const
+			{
+				return String::FromUTF8(m_Value);
+			}
+
+			bool GetBoolean() const noexcept
+			{
+				return m_Boolean;
+			}
+			double GetFloat() const noexcept
+			{
+				if (m_Token == JSONToken::Integer)
+				{
+					return static_cast<double>(m_Integer);
+				}
+				else if (m_Token == JSONToken::UnsignedInteger)
+				{
+					return static_cast<double>(m_UnsignedInteger);
+				}
+				return m_Float;
+			}
+
+			// Converts the current number token to the given arithmetic type, fails if the value doesn't fit or, for integer types, isn't an integer
+			template<class T>
+			requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+			std::optional<T> GetNumber() const noexcept
+			{
+				if constexpr(std::is_floating_point_v<T>)
+				{
+					if (m_Token == JSONToken::Integer || m_Token == JSONToken::UnsignedInteger || m_Token == JSONToken::Float)
+					{
+						return static_cast<T>(GetFloat());
+					}
+				}
+				else if (m_Token == JSONToken::Integer)
+				{
+					if (std::in_range<T>(m_Integer))
+					{
+						return static_cast<T>(m_Integer);
+					}
+				}
+				else if (m_Token == JSONToken::UnsignedInteger)
+				{
+					if (std::in_range<T>(m_UnsignedInteger))
+					{
+						return static_cast<T>(m_UnsignedInteger);
+					}
+				}
+				return {};
+			}
+
+			const String& GetErrorMessage() const noexcept
+			{
+				return m_ErrorMessage;
+			}
+			uint64_t GetErrorOffset() const noexcept
+			{
+				return m_ErrorOffset;
+			}
+
+		public:
+			JSONStreamReader& operator=(const JSONStreamReader&) = delete;
+	};
+}
@@ -0,0 +1,180 @@
+#pragma once
+#include "../Common.h"
+#include "JSONStreamReader.h"
+#include "JSONStreamWriter.h"
+
+namespace kxf
+{
+	// Counterpart of 'BinarySerializer' for the streaming JSON reader and writer. 'Deserialize' starts by reading the value's
+	// first token itself, so it can be called right after the key (or in place of the next array element) has been read.
+	template<class TValue>
+	struct JSONStreamSerializer;
+}
+
+namespace kxf::Serialization
+{
+	template<class TValue>
+	bool WriteJSON(JSONStreamWriter& writer, const TValue& value)
+	{
+		if constexpr(std::is_enum_v<TValue>)
+		{
+			using T = std::underlying_type_t<TValue>;
+			return JSONStreamSerializer<T>().Serialize(writer, static_cast<T>(value));
+		}
+		else
+		{
+			return JSONStreamSerializer<TValue>().Serialize(writer, value);
+		}
+	}
+
+	template<class TValue>
+	bool ReadJSON(JSONStreamReader& reader, TValue& value)
+	{
+		if constexpr(std::is_enum_v<TValue>)
+		{
+			using T = std::underlying_type_t<TValue>;
+
+			T temp = {};
+			if (JSONStreamSerializer<T>().Deserialize(reader, temp))
+			{
+				value = static_cast<TValue>(temp);
+				return true;
+			}
+			return false;
+		}
+		else
+		{
+			return JSONStreamSerializer<TValue>().Deserialize(reader, value);
+		}
+	}
+}
+
+namespace kxf
+{
+	template<>
+	struct JSONStreamSerializer<String> final
+	{
+		bool Serialize(JSONStreamWriter& writer, const String& value) const
+		{
+			return writer.Value(value);
+		}
+		bool Deserialize(JSONStreamReader& reader, String& value) const
+		{
+			if (reader.Next() == JSONToken::String)
+			{
+				value = reader.GetString();
+				return true;
+			}
+			return false;
+		}
+	};
+
+	template<>
+	struct JSONStreamSerializer<std::string> final
+	{
+		bool Serialize(JSONStreamWriter& writer, const std::string& value) const
+		{
+			return writer.Value(std::string_view(value));
+		}
+		bool Deserialize(JSONStreamReader& reader, std::string& value) const
+		{
+			if (reader.Next() == JSONToken::String)
+			{
+				value = reader.GetUTF8();
+				return true;
+			}
+			return false;
+		}
+	};
+
+	template<>
+	struct JSONStreamSerializer<bool> final
+	{
+		bool Serialize(JSONStreamWriter& writer, bool value) const
+		{
+			return writer.Value(value);
+		}
+		bool Deserialize(JSONStreamReader& reader, bool& value) const
+		{
+			if (reader.Next() == JSONToken::Boolean)
+			{
+				value = reader.GetBoolean();
+				return true;
+			}
+			return false;
+		}
+	};
+
+	template<class T>
+	requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+	struct JSONStreamSerializer<T> final
+	{
+		bool Serialize(JSONStreamWriter& writer, T value) const
+		{
+			return writer.Value(value);
+		}
+		bool Deserialize(JSONStreamReader& reader, T& value) const
+		{
+			reader.Next();
+			if (auto number = reader.GetNumber<T>())
+			{
+				value = *number;
+				return true;
+			}
+			return false;
+		}
+	};
+
+	template<class T>
+	struct JSONStreamSerializer<std::vector<T>> final
+	{
+		bool Serialize(JSONStreamWriter& writer, const std::vector<T>& values) const
+		{
+			if (!writer.BeginArray())
+			{
+				return false;
+			}
+			for (const T& value: values)
+			{
+				if (!Serialization::WriteJSON(writer, value))
+				{
+					return false;
+				}
+			}
+			return writer.EndArray();
+		}
+		bool Deserialize(JSONStreamReader& reader, std::vector<T>& values) const
+		{
+			if (reader.Next() != JSONToken::BeginArray)
+			{
+				return false;
+			}
+
+			// Element deserializers read their first token themselves, the end of the array shows up as a failed element read
+			values.clear();
+			const size_t depth = reader.GetDepth();
+			while (true)
+			{
+				T value = {};
+				if (!Serialization::ReadJSON(reader, value))
+				{
+					return reader.GetToken() == JSONToken::EndArray && reader.GetDepth() == depth - 1;
+				}
+				values.emplace_back(std::move(value));
+			}
+		}
+	};
+
+	template<>
+	struct JSONStreamSerializer<nlohmann::json> final
+	{
+		bool Serialize(JSONStreamWriter& writer, const nlohmann::json& value) const
+		{
+			return writer.WriteValue(value);
+		}
+		bool Deserialize(JSONStreamReader& reader, nlohmann::json& value) const
+		{
+			return reader.ReadValue(value);
+		}
+	};
+}
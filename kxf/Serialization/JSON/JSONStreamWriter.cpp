@@ -0,0 +1,446 @@
+#include "KxfPCH.h"
+#include "JSONStreamWriter.h"
+#include <charconv>
+
+namespace
+{
+	// Shortest round-trip representation laid out the same way 'nlohmann::json' does it: fixed notation for decimal
+	// exponents in [-4, 15], scientific one with at least two exponent digits otherwise, integral values keep ".0".
+	std::string_view FormatFloat(double value, char (&buffer)[64]) noexcept
+	{
+		char scientific[32] = {};
+		const auto result = std::to_chars(std::begin(scientific), std::end(scientific), value, std::chars_format::scientific);
+		const std::string_view text(scientific, result.ptr - scientific);
+
+		// Split "-d.ddde+XX" into the sign, the significant digits and the exponent
+		const bool isNegative = text.front() == '-';
+		const size_t exponentPos = text.find('e');
+
+		char digits[20] = {};
+		size_t digitCount = 0;
+		for (char c: text.substr(isNegative ? 1 : 0, exponentPos - (isNegative ? 1 : 0)))
+		{
+			if (c != '.')
+			{
+				digits[digitCount++] = c;
+			}
+		}
+
+		int exponent = 0;
+		const char* exponentStart = text.data() + exponentPos + 1;
+		std::from_chars(exponentStart + (*exponentStart == '+' ? 1 : 0), text.data() + text.size(), exponent);
+
+		char* out = buffer;
+		if (isNegative)
+		{
+			*out++ = '-';
+		}
+
+		const int k = static_cast<int>(digitCount);
+		const int n = exponent + 1;
+		if (k <= n && n <= 15)
+		{
+			// digits000.0
+			out = std::copy_n(digits, k, out);
+			out = std::fill_n(out, n - k, '0');
+			*out++ = '.';
+			*out++ = '0';
+		}
+		else if (0 < n && n <= 15)
+		{
+			// dig.its
+			out = std::copy_n(digits, n, out);
+			*out++ = '.';
+			out = std::copy_n(digits + n, k - n, out);
+		}
+		else if (-4 < n && n <= 0)
+		{
+			// 0.[000]digits
+			*out++ = '0';
+			*out++ = '.';
+			out = std::fill_n(out, -n, '0');
+			out = std::copy_n(digits, k, out);
+		}
+		else
+		{
+			// d[.igits]e[+-]XX
+			*out++ = digits[0];
+			if (k > 1)
+			{
+				*out++ = '.';
+				out = std::copy_n(digits + 1, k - 1, out);
+			}
+			*out++ = 'e';
+			*out++ = exponent < 0 ? '-' : '+';
+
+			const int absExponent = std::abs(exponent);
+			if (absExponent < 10)
+			{
+				*out++ = '0';
+			}
+			out = std::to_chars(out, buffer + std::size(buffer), absExponent).ptr;
+		}
+		return {buffer, static_cast<size_t>(out - buffer)};
+	}
+}
+
+namespace kxf
+{
+	bool JSONStreamWriter::DoFlush()
+	{
+		if (!m_Buffer.empty())
+		{
+			if (!m_IsFailed && !m_Stream.WriteAll(m_Buffer.data(), m_Buffer.size()))
+			{
+				m_IsFailed = true;
+			}
+			m_Buffer.clear();
+		}
+		return !m_IsFailed;
+	}
+
+	void JSONStreamWriter::WriteNewLine(size_t depth)
+	{
+		if (m_Indent >= 0)
+		{
+			m_Buffer += '\n';
+			m_Buffer.append(depth * static_cast<size_t>(m_Indent), m_IndentChar);
+			if (m_Buffer.size() >= m_BufferSize)
+			{
+				DoFlush();
+			}
+		}
+	}
+	void JSONStreamWriter::WriteQuoted(std::string_view utf8)
+	{
+		constexpr char hexDigits[] = "0123456789abcdef";
+
+		DoWrite('"');
+		size_t start = 0;
+		for (size_t i = 0; i < utf8.size(); i++)
+		{
+			const auto c = static_cast<unsigned char>(utf8[i]);
+			if (c >= 0x20 && c != '"' && c != '\\')
+			{
+				continue;
+			}
+
+			m_Buffer.append(utf8.data() + start, i - start);
+			start = i + 1;
+
+			switch (c)
+			{
+				case '"':
+				{
+					m_Buffer += "\\\"";
+					break;
+				}
+				case '\\':
+				{
+					m_Buffer += "\\\\";
+					break;
+				}
+				case '\b':
+				{
+					m_Buffer += "\\b";
+					break;
+				}
+				case '\f':
+				{
+					m_Buffer += "\\f";
+					break;
+				}
+				case '\n':
+				{
+					m_Buffer += "\\n";
+					break;
+				}
+				case '\r':
+				{
+					m_Buffer += "\\r";
+					break;
+				}
+				case '\t':
+				{
+					m_Buffer += "\\t";
+					break;
+				}
+				default:
+				{
+					const char escape[] = {'\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xF]};
+					m_Buffer.append(escape, std::size(escape));
+					break;
+				}
+			};
+		}
+		m_Buffer.append(utf8.data() + start, utf8.size() - start);
+		DoWrite('"');
+	}
+
+	bool JSONStreamWriter::BeginValue()
+	{
+		if (m_IsFailed)
+		{
+			return false;
+		}
+
+		if (m_Stack.empty())
+		{
+			if (m_HasRoot)
+			{
+				m_IsFailed = true;
+				return false;
+			}
+			m_HasRoot = true;
+			return true;
+		}
+
+		Container& container = m_Stack.back();
+		if (container.IsObject)
+		{
+			// The key has already written the separator
+			if (!m_HasKey)
+			{
+				m_IsFailed = true;
+				return false;
+			}
+			m_HasKey = false;
+		}
+		else
+		{
+			if (!container.IsEmpty)
+			{
+				m_Buffer += ',';
+			}
+			container.IsEmpty = false;
+			WriteNewLine(m_Stack.size());
+		}
+		return true;
+	}
+	bool JSONStreamWriter::DoBeginContainer(bool isObject)
+	{
+		if (BeginValue())
+		{
+			DoWrite(isObject ? '{' : '[');
+			m_Stack.push_back({isObject, true});
+			return true;
+		}
+		return false;
+	}
+	bool JSONStreamWriter::DoEndContainer(bool isObject)
+	{
+		if (m_IsFailed || m_Stack.empty() || m_Stack.back().IsObject != isObject || m_HasKey)
+		{
+			m_IsFailed = true;
+			return false;
+		}
+
+		const bool isEmpty = m_Stack.back().IsEmpty;
+		m_Stack.pop_back();
+		if (!isEmpty)
+		{
+			WriteNewLine(m_Stack.size());
+		}
+		DoWrite(isObject ? '}' : ']');
+
+		if (m_Stack.empty())
+		{
+			return DoFlush();
+		}
+		return true;
+	}
+	bool JSONStreamWriter::DoWriteSigned(int64_t value)
+	{
+		if (BeginValue())
+		{
+			char buffer[32] = {};
+			auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+			DoWrite(std::string_view(buffer, result.ptr - buffer));
+
+			return true;
+		}
+		return false;
+	}
+	bool JSONStreamWriter::DoWriteUnsigned(uint64_t value)
+	{
+		if (BeginValue())
+		{
+			char buffer[32] = {};
+			auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+			DoWrite(std::string_view(buffer, result.ptr - buffer));
+
+			return true;
+		}
+		return false;
+	}
+	bool JSONStreamWriter::DoWriteFloat(double value)
+	{
+		if (BeginValue())
+		{
+			// Same as 'nlohmann::json': no representation for infinities and NaNs, integral values keep the fractional part
+			if (!std::isfinite(value))
+			{
+				DoWrite("null");
+				return true;
+			}
+
+			char buffer[64] = {};
+			DoWrite(FormatFloat(value, buffer));
+
+			return true;
+		}
+		return false;
+	}
+
+	JSONStreamWriter::JSONStreamWriter(IOutputStream& stream, int indent, char indentChar, size_t bufferSize)
+		:m_Stream(stream), m_BufferSize(std::max<size_t>(bufferSize, 1)), m_Indent(indent), m_IndentChar(indentChar)
+	{
+		// A little more than the threshold so a single write doesn't need to reallocate
+		m_Buffer.reserve(m_BufferSize + 64);
+	}
+	JSONStreamWriter::~JSONStreamWriter()
+	{
+		DoFlush();
+	}
+
+	bool JSONStreamWriter::Flush()
+	{
+		return DoFlush();
+	}
+
+	bool JSONStreamWriter::Key(std::string_view utf8)
+	{
+		if (m_IsFailed || m_Stack.empty() || !m_Stack.back().IsObject || m_HasKey)
+		{
+			m_IsFailed = true;
+			return false;
+		}
+
+		Container& container = m_Stack.back();
+		if (!container.IsEmpty)
+		{
+			m_Buffer += ',';
+		}
+		container.IsEmpty = false;
+		WriteNewLine(m_Stack.size());
+
+		WriteQuoted(utf8);
+		DoWrite(m_Indent >= 0 ? std::string_view(": ") : std::string_view(":"));
+
+		m_HasKey = true;
+		return true;
+	}
+	bool JSONStreamWriter::Value(std::string_view utf8)
+	{
+		if (BeginValue())
+		{
+			WriteQuoted(utf8);
+			return true;
+		}
+		return false;
+	}
+	bool JSONStreamWriter::Value(bool value)
+	{
+		if (BeginValue())
+		{
+			DoWrite(value ? "true" : "false");
+			return true;
+		}
+		return false;
+	}
+	bool JSONStreamWriter::Value(std::nullptr_t)
+	{
+		if (BeginValue())
+		{
+			DoWrite("null");
+			return true;
+		}
+		return false;
+	}
+
+	bool JSONStreamWriter::WriteValue(const nlohmann::json& value)
+	{
+		using ValueType = nlohmann::json::value_t;
+
+		switch (value.type())
+		{
+			case ValueType::object:
+			{
+				if (!BeginObject())
+				{
+					return false;
+				}
+				for (const auto& [key, item]: value.items())
+				{
+					if (!Key(key) || !WriteValue(item))
+					{
+						return false;
+					}
+				}
+				return EndObject();
+			}
+			case ValueType::array:
+			{
+				if (!BeginArray())
+				{
+					return false;
+				}
+				for (const auto& item: value)
+				{
+					if (!WriteValue(item))
+					{
+						return false;
+					}
+				}
+				return EndArray();
+			}
+			case ValueType::string:
+			{
+				return Value(std::string_view(value.get_ref<const nlohmann::json::string_t&>()));
+			}
+			case ValueType::boolean:
+			{
+				return Value(value.get<bool>());
+			}
+			case ValueType::number_integer:
+			{
+				return DoWriteSigned(value.get<int64_t>());
+			}
+			case ValueType::number_unsigned:
+			{
+				return DoWriteUnsigned(value.get<uint64_t>());
+			}
+			case ValueType::number_float:
+			{
+				return DoWriteFloat(value.get<double>());
+			}
+			case ValueType::binary:
+			{
+				// Same layout 'dump' uses for binary values
+				const auto& binary = value.get_binary();
+				if (!BeginObject() || !Key("bytes") || !BeginArray())
+				{
+					return false;
+				}
+				for (uint8_t byte: binary)
+				{
+					DoWriteUnsigned(byte);
+				}
+				if (!EndArray() || !Key("subtype"))
+				{
+					return false;
+				}
+				if (binary.has_subtype())
+				{
+					DoWriteUnsigned(binary.subtype());
+				}
+				else
+				{
+					Value(nullptr);
+				}
+				return EndObject();
+			}
+		};
+		return Value(nullptr);
+	}
+}
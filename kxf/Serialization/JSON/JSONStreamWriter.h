@@ -0,0 +1,153 @@
+#pragma once
+#include "../Common.h"
+#include "kxf/IO/IStream.h"
+#include <nlohmann/json.hpp>
+
+namespace kxf
+{
+	// Writes JSON to a stream as it's produced through a fixed-size buffer. Formatting follows 'nlohmann::json::dump':
+	// negative indent gives the most compact form, otherwise every element goes to its own line indented by 'indent' characters per level.
+	// Calls which would produce invalid JSON (a value without a key inside an object, a second root value) are rejected.
+	class KX_API JSONStreamWriter final
+	{
+		public:
+			static constexpr size_t DefaultBufferSize = 16 * 1024;
+
+		private:
+			struct Container final
+			{
+				bool IsObject = false;
+				bool IsEmpty = true;
+			};
+
+		private:
+			IOutputStream& m_Stream;
+			std::string m_Buffer;
+			size_t m_BufferSize = 0;
+			int m_Indent = -1;
+			char m_IndentChar = ' ';
+
+			std::vector<Container> m_Stack;
+			bool m_HasKey = false;
+			bool m_HasRoot = false;
+			bool m_IsFailed = false;
+
+		private:
+			void DoWrite(std::string_view data)
+			{
+				m_Buffer.append(data);
+				if (m_Buffer.size() >= m_BufferSize)
+				{
+					DoFlush();
+				}
+			}
+			void DoWrite(char c)
+			{
+				m_Buffer += c;
+				if (m_Buffer.size() >= m_BufferSize)
+				{
+					DoFlush();
+				}
+			}
+			bool DoFlush();
+
+			void WriteNewLine(size_t depth);
+			void WriteQuoted(std::string_view utf8);
+
+			bool BeginValue();
+			bool DoBeginContainer(bool isObject);
+			bool DoEndContainer(bool isObject);
+			bool DoWriteSigned(int64_t value);
+			bool DoWriteUnsigned(uint64_t value);
+			bool DoWriteFloat(double value);
+
+		public:
+			JSONStreamWriter(IOutputStream& stream, int indent = -1, char indentChar = ' ', size_t bufferSize = DefaultBufferSize);
+			JSONStreamWriter(const JSONStreamWriter&) = delete;
+			~JSONStreamWriter();
+
+		public:
+			bool IsFailed() const noexcept
+			{
+				return m_IsFailed;
+			}
+			size_t GetDepth() const noexcept
+			{
+				return m_Stack.size();
+			}
+
+			// Writes out the buffered data, returns false if anything has failed so far
+			bool Flush();
+
+			bool BeginObject()
+			{
+				return DoBeginContainer(true);
+			}
+			bool EndObject()
+			{
+				return DoEndContainer(true);
+			}
+			bool BeginArray()
+			{
+				return DoBeginContainer(false);
+			}
+			bool EndArray()
+			{
+				return DoEndContainer(false);
+			}
+
+			bool Key(std::string_view utf8);
+			bool Key(const String& key)
+			{
+				return Key(key.ToUTF8());
+			}
+			bool Key(const char* utf8)
+			{
+				return Key(std::string_view(utf8));
+			}
+
+			bool Value(std::string_view utf8);
+			bool Value(const String& value)
+			{
+				return Value(value.ToUTF8());
+			}
+			bool Value(const char* utf8)
+			{
+				return Value(std::string_view(utf8));
+			}
+			bool Value(const XChar* value)
+			{
+				return Value(String(value));
+			}
+
+			bool Value(bool value);
+			bool Value(std::nullptr_t);
+
+			template<class T>
+			requires(std::is_integral_v<T> && !std::is_same_v<T, bool>)
+			bool Value(T value)
+			{
+				if constexpr(std::is_signed_v<T>)
+				{
+					return DoWriteSigned(value);
+				}
+				else
+				{
+					return DoWriteUnsigned(value);
+				}
+			}
+
+			template<class T>
+			requires(std::is_floating_point_v<T>)
+			bool Value(T value)
+			{
+				return DoWriteFloat(static_cast<double>(value));
+			}
+
+			// Writes a whole DOM fragment
+			bool WriteValue(const nlohmann::json& value);
+
+		public:
+			JSONStreamWriter& operator=(const JSONStreamWriter&) = delete;
+	};
+}
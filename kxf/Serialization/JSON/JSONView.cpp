@@ -0,0 +1,1012 @@
+#include "KxfPCH.h"
+#include "JSONView.h"
+#include "kxf/IO/MemoryStreamBuffer.h"
+#include "kxf/System/SystemInformation.h"
+#include "Private/UTF8.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#define KXF_JSONVIEW_X86 1
+#endif
+
+namespace
+{
+	// Every input byte gets a bit in each of these masks, 64 bytes at a time
+	struct BlockMasks final
+	{
+		uint64_t Backslash = 0;
+		uint64_t Quote = 0;
+		uint64_t Whitespace = 0;
+		uint64_t Operator = 0;
+		uint64_t Control = 0;
+		uint64_t NonASCII = 0;
+	};
+
+	constexpr size_t g_BlockSize = 64;
+	constexpr uint64_t g_EvenBits = 0x5555555555555555ull;
+
+	constexpr bool IsWhitespace(char c) noexcept
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+	constexpr bool IsDigit(char c) noexcept
+	{
+		return c >= '0' && c <= '9';
+	}
+	constexpr bool IsHexDigit(char c) noexcept
+	{
+		return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+	}
+	constexpr bool IsNumberChar(char c) noexcept
+	{
+		return IsDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+	}
+
+	void ClassifyBlock_Scalar(const char* block, BlockMasks& masks) noexcept
+	{
+		masks = {};
+		for (size_t i = 0; i < g_BlockSize; i++)
+		{
+			const auto c = static_cast<unsigned char>(block[i]);
+			const uint64_t bit = 1ull << i;
+
+			switch (c)
+			{
+				case '\\':
+				{
+					masks.Backslash |= bit;
+					break;
+				}
+				case '"':
+				{
+					masks.Quote |= bit;
+					break;
+				}
+				case ' ':
+				case '\t':
+				case '\n':
+				case '\r':
+				{
+					masks.Whitespace |= bit;
+					break;
+				}
+				case '{':
+				case '}':
+				case '[':
+				case ']':
+				case ':':
+				case ',':
+				{
+					masks.Operator |= bit;
+					break;
+				}
+			};
+			if (c < 0x20)
+			{
+				masks.Control |= bit;
+			}
+			else if (c >= 0x80)
+			{
+				masks.NonASCII |= bit;
+			}
+		}
+	}
+
+	#if KXF_JSONVIEW_X86
+	// '[' and ']' differ from '{' and '}' only in the 0x20 bit, so brackets of both kinds take two comparisons
+	void ClassifyBlock_SSE2(const char* block, BlockMasks& masks) noexcept
+	{
+		masks = {};
+		for (size_t i = 0; i < g_BlockSize; i += sizeof(__m128i))
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+			const __m128i lowered = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+			auto ToMask = [&](__m128i value)
+			{
+				return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(value))) << i;
+			};
+
+			masks.Backslash |= ToMask(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+			masks.Quote |= ToMask(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+			masks.Whitespace |= ToMask(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+													_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')))));
+			masks.Operator |= ToMask(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(lowered, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lowered, _mm_set1_epi8('}'))),
+												  _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')))));
+			masks.Control |= ToMask(_mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1F)), chunk));
+			masks.NonASCII |= ToMask(chunk);
+		}
+	}
+	void ClassifyBlock_AVX2(const char* block, BlockMasks& masks) noexcept
+	{
+		masks = {};
+		for (size_t i = 0; i < g_BlockSize; i += sizeof(__m256i))
+		{
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+			const __m256i lowered = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+			auto ToMask = [&](__m256i value)
+			{
+				return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(value))) << i;
+			};
+
+			masks.Backslash |= ToMask(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+			masks.Quote |= ToMask(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')));
+			masks.Whitespace |= ToMask(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+													   _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')))));
+			masks.Operator |= ToMask(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lowered, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lowered, _mm256_set1_epi8('}'))),
+													 _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')))));
+			masks.Control |= ToMask(_mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1F)), chunk));
+			masks.NonASCII |= ToMask(chunk);
+		}
+	}
+	#endif
+
+	// Bit 'i' of the result is the XOR of bits [0, i] of the input
+	constexpr uint64_t PrefixXOR(uint64_t value) noexcept
+	{
+		value ^= value << 1;
+		value ^= value << 2;
+		value ^= value << 4;
+		value ^= value << 8;
+		value ^= value << 16;
+		value ^= value << 32;
+		return value;
+	}
+
+	// Checks the number against the JSON grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+	bool IsValidNumber(std::string_view number) noexcept
+	{
+		size_t i = 0;
+		auto SkipDigits = [&]()
+		{
+			const size_t start = i;
+			while (i < number.size() && IsDigit(number[i]))
+			{
+				i++;
+			}
+			return i != start;
+		};
+
+		if (i < number.size() && number[i] == '-')
+		{
+			i++;
+		}
+		if (i < number.size() && number[i] == '0')
+		{
+			i++;
+		}
+		else if (!SkipDigits())
+		{
+			return false;
+		}
+
+		if (i < number.size() && number[i] == '.')
+		{
+			i++;
+			if (!SkipDigits())
+			{
+				return false;
+			}
+		}
+		if (i < number.size() && (number[i] == 'e' || number[i] == 'E'))
+		{
+			i++;
+			if (i < number.size() && (number[i] == '+' || number[i] == '-'))
+			{
+				i++;
+			}
+			if (!SkipDigits())
+			{
+				return false;
+			}
+		}
+		return i == number.size();
+	}
+
+	// For a number 'from_chars' has rejected as out of range, tells whether it's too small rather than too large
+	bool IsUnderflow(std::string_view number) noexcept
+	{
+		const size_t exponent = number.find_first_of("eE");
+		return exponent != number.npos && exponent + 1 < number.size() && number[exponent + 1] == '-';
+	}
+
+	uint32_t ParseHex4(const char* text) noexcept
+	{
+		uint32_t value = 0;
+		for (size_t i = 0; i < 4; i++)
+		{
+			const char c = text[i];
+			value <<= 4;
+			if (IsDigit(c))
+			{
+				value |= c - '0';
+			}
+			else
+			{
+				value |= (c|0x20) - 'a' + 10;
+			}
+		}
+		return value;
+	}
+	void AppendUTF8(std::string& buffer, uint32_t c)
+	{
+		if (c < 0x80)
+		{
+			buffer += static_cast<char>(c);
+		}
+		else if (c < 0x800)
+		{
+			buffer += static_cast<char>(0xC0|(c >> 6));
+			buffer += static_cast<char>(0x80|(c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			buffer += static_cast<char>(0xE0|(c >> 12));
+			buffer += static_cast<char>(0x80|((c >> 6) & 0x3F));
+			buffer += static_cast<char>(0x80|(c & 0x3F));
+		}
+		else
+		{
+			buffer += static_cast<char>(0xF0|(c >> 18));
+			buffer += static_cast<char>(0x80|((c >> 12) & 0x3F));
+			buffer += static_cast<char>(0x80|((c >> 6) & 0x3F));
+			buffer += static_cast<char>(0x80|(c & 0x3F));
+		}
+	}
+
+	// Escape sequences are already validated by the index builder, except for surrogate pairing which is resolved here:
+	// an unpaired surrogate becomes U+FFFD.
+	std::string Unescape(std::string_view text)
+	{
+		std::string result;
+		result.reserve(text.size());
+
+		for (size_t i = 0; i < text.size();)
+		{
+			const size_t escape = text.find('\\', i);
+			result.append(text.substr(i, escape - i));
+			if (escape == text.npos)
+			{
+				break;
+			}
+
+			const char c = text[escape + 1];
+			i = escape + 2;
+			switch (c)
+			{
+				case 'b':
+				{
+					result += '\b';
+					break;
+				}
+				case 'f':
+				{
+					result += '\f';
+					break;
+				}
+				case 'n':
+				{
+					result += '\n';
+					break;
+				}
+				case 'r':
+				{
+					result += '\r';
+					break;
+				}
+				case 't':
+				{
+					result += '\t';
+					break;
+				}
+				case 'u':
+				{
+					uint32_t codePoint = ParseHex4(text.data() + i);
+					i += 4;
+
+					if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+					{
+						const uint32_t lowSurrogate = text.size() - i >= 6 && text[i] == '\\' && text[i + 1] == 'u' ? ParseHex4(text.data() + i + 2) : 0;
+						if (lowSurrogate >= 0xDC00 && lowSurrogate <= 0xDFFF)
+						{
+							codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+							i += 6;
+						}
+						else
+						{
+							codePoint = 0xFFFD;
+						}
+					}
+					else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+					{
+						codePoint = 0xFFFD;
+					}
+					AppendUTF8(result, codePoint);
+					break;
+				}
+				default:
+				{
+					result += c;
+					break;
+				}
+			};
+		}
+		return result;
+	}
+}
+
+namespace kxf
+{
+	bool JSONView::SetError(const char* message, size_t offset)
+	{
+		m_Buffer.clear();
+		m_Data = {};
+		m_Tape.clear();
+		m_Links.clear();
+
+		m_ErrorMessage = message;
+		m_ErrorOffset = offset;
+		return false;
+	}
+	bool JSONView::BuildIndex()
+	{
+		#if KXF_JSONVIEW_X86
+		static const bool hasAVX2 = System::HasFeature(ProcessorFeature::AVX2);
+		static const bool hasSSE2 = System::HasFeature(ProcessorFeature::SSE2);
+		#endif
+
+		// State carried over from the previous block
+		uint64_t prevEscaped = 0;
+		uint64_t prevInString = 0;
+		uint64_t prevScalar = 0;
+		JSON::Private::UTF8State utf8State;
+
+		const size_t size = m_Data.size();
+		size_t count = 0;
+		m_Tape.resize(std::min<size_t>(size, 1024 * 1024) + g_BlockSize);
+
+		for (size_t offset = 0; offset < size; offset += g_BlockSize)
+		{
+			// The last block is padded with whitespace which never produces any structural characters
+			const char* block = m_Data.data() + offset;
+			char lastBlock[g_BlockSize];
+			if (size - offset < g_BlockSize)
+			{
+				std::memset(lastBlock, ' ', g_BlockSize);
+				std::memcpy(lastBlock, block, size - offset);
+				block = lastBlock;
+			}
+
+			BlockMasks masks;
+			#if KXF_JSONVIEW_X86
+			if (hasAVX2)
+			{
+				ClassifyBlock_AVX2(block, masks);
+			}
+			else if (hasSSE2)
+			{
+				ClassifyBlock_SSE2(block, masks);
+			}
+			else
+			#endif
+			{
+				ClassifyBlock_Scalar(block, masks);
+			}
+
+			// Blocks of pure ASCII need no UTF-8 validation, which is the case for the most of a typical document
+			if (masks.NonASCII != 0 || utf8State.Remaining != 0)
+			{
+				if (const size_t invalid = JSON::Private::ValidateUTF8(block, g_BlockSize, utf8State); invalid != g_BlockSize)
+				{
+					return SetError("Invalid UTF-8 sequence", offset + invalid);
+				}
+			}
+
+			// Find the escaped characters: a backslash escapes the next character unless it's escaped itself,
+			// runs of backslashes are resolved by the parity of the position they start at.
+			const uint64_t backslash = masks.Backslash & ~prevEscaped;
+			const uint64_t followsEscape = (backslash << 1)|prevEscaped;
+			const uint64_t oddSequenceStarts = backslash & ~g_EvenBits & ~followsEscape;
+			const uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+			prevEscaped = sequencesStartingOnEvenBits < oddSequenceStarts ? 1 : 0;
+			const uint64_t escaped = (g_EvenBits ^ (sequencesStartingOnEvenBits << 1)) & followsEscape;
+
+			// Everything from an opening quote up to, but not including, the closing one is inside a string
+			const uint64_t quote = masks.Quote & ~escaped;
+			const uint64_t inString = PrefixXOR(quote) ^ prevInString;
+			prevInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+			if (const uint64_t control = masks.Control & inString)
+			{
+				return SetError("Control characters must be escaped in strings", offset + std::countr_zero(control));
+			}
+			for (uint64_t mask = escaped & inString; mask != 0; mask &= mask - 1)
+			{
+				const size_t position = offset + std::countr_zero(mask);
+				const char c = position < size ? m_Data[position] : '\0';
+				if (c == 'u')
+				{
+					if (size - position <= 4 || !std::all_of(m_Data.data() + position + 1, m_Data.data() + position + 5, IsHexDigit))
+					{
+						return SetError("Invalid '\\u' escape sequence", position);
+					}
+				}
+				else if (c != '"' && c != '\\' && c != '/' && c != 'b' && c != 'f' && c != 'n' && c != 'r' && c != 't')
+				{
+					return SetError("Invalid escape sequence", position);
+				}
+			}
+
+			// Operators are structural, as are the first characters of strings and scalars. Everything in strings after
+			// the opening quote, closing quote included, isn't.
+			const uint64_t stringTail = inString ^ quote;
+			const uint64_t scalar = ~(masks.Operator|masks.Whitespace);
+			const uint64_t nonQuoteScalar = scalar & ~quote;
+			const uint64_t followsNonQuoteScalar = (nonQuoteScalar << 1)|prevScalar;
+			prevScalar = nonQuoteScalar >> 63;
+
+			uint64_t structurals = (masks.Operator|(scalar & ~followsNonQuoteScalar)) & ~stringTail;
+			if (m_Tape.size() - count < g_BlockSize)
+			{
+				m_Tape.resize(m_Tape.size() * 2);
+			}
+			for (uint32_t* out = m_Tape.data() + count; structurals != 0; structurals &= structurals - 1)
+			{
+				*out++ = static_cast<uint32_t>(offset + std::countr_zero(structurals));
+				count++;
+			}
+		}
+
+		#if KXF_JSONVIEW_X86
+		if (hasAVX2)
+		{
+			_mm256_zeroupper();
+		}
+		#endif
+
+		if (prevInString != 0)
+		{
+			return SetError("Unexpected end of input inside a string", size);
+		}
+		if (utf8State.Remaining != 0)
+		{
+			return SetError("Invalid UTF-8 sequence", size);
+		}
+		if (count == 0)
+		{
+			return SetError("Unexpected end of input", size);
+		}
+
+		m_Tape.resize(count);
+		m_Tape.shrink_to_fit();
+		return true;
+	}
+	bool JSONView::ValidateScalar(uint32_t index)
+	{
+		const size_t start = m_Tape[index];
+		const size_t next = GetTokenEnd(index);
+		const char c = m_Data[start];
+
+		size_t end = start;
+		if (c == '"')
+		{
+			// Whatever is between the string and the next structural character is either the closing quote or whitespace
+			end = next;
+			while (end > start + 1 && IsWhitespace(m_Data[end - 1]))
+			{
+				end--;
+			}
+			if (end <= start + 1 || m_Data[end - 1] != '"')
+			{
+				return SetError("Invalid string", start);
+			}
+			return true;
+		}
+		else if (c == 't' || c == 'f' || c == 'n')
+		{
+			const std::string_view literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+			if (m_Data.substr(start, literal.size()) != literal)
+			{
+				return SetError("Invalid literal", start);
+			}
+			end = start + literal.size();
+		}
+		else
+		{
+			while (end < next && IsNumberChar(m_Data[end]))
+			{
+				end++;
+			}
+			if (!IsValidNumber(m_Data.substr(start, end - start)))
+			{
+				return SetError("Invalid number", start);
+			}
+		}
+
+		for (; end < next; end++)
+		{
+			if (!IsWhitespace(m_Data[end]))
+			{
+				return SetError("Unexpected character after a value", end);
+			}
+		}
+		return true;
+	}
+	bool JSONView::ValidateIndex()
+	{
+		enum class State
+		{
+			Value,
+			FirstValueOrEnd,
+			FirstKeyOrEnd,
+			Key,
+			Colon,
+			CommaOrEnd,
+			Done
+		};
+
+		std::vector<uint32_t> stack;
+		State state = State::Value;
+		m_Links.resize(m_Tape.size());
+
+		auto EndValue = [&]()
+		{
+			state = stack.empty() ? State::Done : State::CommaOrEnd;
+		};
+		auto CloseContainer = [&](uint32_t index, char c)
+		{
+			const char open = GetChar(stack.back());
+			if ((open == '{' && c != '}') || (open == '[' && c != ']'))
+			{
+				return SetError("Mismatched brackets", m_Tape[index]);
+			}
+
+			m_Links[stack.back()] = index;
+			stack.pop_back();
+			EndValue();
+			return true;
+		};
+
+		for (uint32_t i = 0; i < m_Tape.size(); i++)
+		{
+			const char c = GetChar(i);
+			m_Links[i] = 0;
+
+			switch (state)
+			{
+				case State::FirstValueOrEnd:
+				{
+					if (c == ']')
+					{
+						if (!CloseContainer(i, c))
+						{
+							return false;
+						}
+						continue;
+					}
+					[[fallthrough]];
+				}
+				case State::Value:
+				{
+					if (c == '{' || c == '[')
+					{
+						stack.push_back(i);
+						state = c == '{' ? State::FirstKeyOrEnd : State::FirstValueOrEnd;
+					}
+					else if (c == '}' || c == ']' || c == ':' || c == ',')
+					{
+						return SetError("Unexpected character, expected a value", m_Tape[i]);
+					}
+					else if (!ValidateScalar(i))
+					{
+						return false;
+					}
+					else
+					{
+						EndValue();
+					}
+					break;
+				}
+				case State::FirstKeyOrEnd:
+				{
+					if (c == '}')
+					{
+						if (!CloseContainer(i, c))
+						{
+							return false;
+						}
+						continue;
+					}
+					[[fallthrough]];
+				}
+				case State::Key:
+				{
+					if (c != '"')
+					{
+						return SetError("Expected an object key", m_Tape[i]);
+					}
+					if (!ValidateScalar(i))
+					{
+						return false;
+					}
+					state = State::Colon;
+					break;
+				}
+				case State::Colon:
+				{
+					if (c != ':')
+					{
+						return SetError("Expected ':' after an object key", m_Tape[i]);
+					}
+					state = State::Value;
+					break;
+				}
+				case State::CommaOrEnd:
+				{
+					if (c == ',')
+					{
+						state = GetChar(stack.back()) == '{' ? State::Key : State::Value;
+					}
+					else if (c == '}' || c == ']')
+					{
+						if (!CloseContainer(i, c))
+						{
+							return false;
+						}
+					}
+					else
+					{
+						return SetError("Expected ',' or the end of the container", m_Tape[i]);
+					}
+					break;
+				}
+				case State::Done:
+				{
+					return SetError("Unexpected data after the end of the document", m_Tape[i]);
+				}
+			};
+		}
+
+		if (state != State::Done)
+		{
+			return SetError("Unexpected end of input", m_Data.size());
+		}
+		return true;
+	}
+	bool JSONView::DoLoad(std::string_view json)
+	{
+		m_Tape.clear();
+		m_Links.clear();
+		m_ErrorMessage.clear();
+		m_ErrorOffset = 0;
+
+		// Skip UTF-8 BOM if there's one
+		if (json.starts_with("\xEF\xBB\xBF"))
+		{
+			json.remove_prefix(3);
+		}
+		if (json.size() >= std::numeric_limits<uint32_t>::max())
+		{
+			return SetError("The document is too large", 0);
+		}
+
+		m_Data = json;
+		return BuildIndex() && ValidateIndex();
+	}
+
+	std::string_view JSONView::GetRawString(uint32_t index) const noexcept
+	{
+		const size_t start = m_Tape[index] + 1;
+
+		size_t end = GetTokenEnd(index);
+		while (IsWhitespace(m_Data[end - 1]))
+		{
+			end--;
+		}
+		return m_Data.substr(start, end - 1 - start);
+	}
+
+	void JSONView::Clear() noexcept
+	{
+		m_Buffer.clear();
+		m_Data = {};
+		m_Tape.clear();
+		m_Links.clear();
+		m_ErrorMessage.clear();
+		m_ErrorOffset = 0;
+	}
+
+	bool JSONView::Load(const String& json)
+	{
+		return LoadUTF8(json.ToUTF8());
+	}
+	bool JSONView::LoadUTF8(std::string json)
+	{
+		m_Buffer = std::move(json);
+		return DoLoad(m_Buffer);
+	}
+	bool JSONView::Load(std::span<const std::byte> json)
+	{
+		m_Buffer.clear();
+		return DoLoad({reinterpret_cast<const char*>(json.data()), json.size()});
+	}
+	bool JSONView::Load(const MemoryStreamBuffer& buffer)
+	{
+		return Load(std::span<const std::byte>(static_cast<const std::byte*>(buffer.GetBufferStart()), buffer.GetBufferSize()));
+	}
+	bool JSONView::Load(IInputStream& stream)
+	{
+		// Use the stream memory in place if it's available (memory and mapped file streams), otherwise read it all
+		if (auto size = stream.GetSize())
+		{
+			if (auto view = stream.ReadView(size.ToBytes()); !view.empty())
+			{
+				return Load(view);
+			}
+		}
+
+		std::string buffer;
+		char chunk[64 * 1024];
+		while (true)
+		{
+			const DataSize read = stream.Read(chunk, std::size(chunk)).LastRead();
+			if (!read.IsValid() || read.ToBytes() <= 0)
+			{
+				break;
+			}
+			buffer.append(chunk, read.ToBytes<size_t>());
+		}
+		return LoadUTF8(std::move(buffer));
+	}
+}
+
+namespace kxf
+{
+	bool JSONViewNode::IsMember() const noexcept
+	{
+		return m_Index != 0 && m_View->GetChar(m_Index - 1) == ':';
+	}
+	std::optional<std::string_view> JSONViewNode::QueryNumberText() const noexcept
+	{
+		if (GetType() == JSONViewType::Number)
+		{
+			const std::string_view data = m_View->m_Data;
+			const size_t start = m_View->m_Tape[m_Index];
+
+			size_t end = start;
+			while (end < data.size() && IsNumberChar(data[end]))
+			{
+				end++;
+			}
+			return data.substr(start, end - start);
+		}
+		return {};
+	}
+
+	JSONViewType JSONViewNode::GetType() const noexcept
+	{
+		if (m_View)
+		{
+			switch (m_View->GetChar(m_Index))
+			{
+				case '{':
+				{
+					return JSONViewType::Object;
+				}
+				case '[':
+				{
+					return JSONViewType::Array;
+				}
+				case '"':
+				{
+					return JSONViewType::String;
+				}
+				case 't':
+				case 'f':
+				{
+					return JSONViewType::Boolean;
+				}
+				case 'n':
+				{
+					return JSONViewType::Null;
+				}
+			};
+			return JSONViewType::Number;
+		}
+		return JSONViewType::None;
+	}
+	std::string_view JSONViewNode::GetRawJSON() const noexcept
+	{
+		if (m_View)
+		{
+			const size_t start = m_View->m_Tape[m_Index];
+			switch (GetType())
+			{
+				case JSONViewType::Object:
+				case JSONViewType::Array:
+				{
+					return m_View->m_Data.substr(start, m_View->m_Tape[m_View->m_Links[m_Index]] + 1 - start);
+				}
+				case JSONViewType::String:
+				{
+					const std::string_view text = m_View->GetRawString(m_Index);
+					return {text.data() - 1, text.size() + 2};
+				}
+				case JSONViewType::Number:
+				{
+					return *QueryNumberText();
+				}
+				case JSONViewType::Boolean:
+				case JSONViewType::Null:
+				{
+					return m_View->m_Data.substr(start, m_View->m_Data[start] == 'f' ? 5 : 4);
+				}
+			};
+		}
+		return {};
+	}
+
+	size_t JSONViewNode::GetChildrenCount() const noexcept
+	{
+		size_t count = 0;
+		for (JSONViewNode node = GetFirstChild(); node; node = node.GetNextSibling())
+		{
+			count++;
+		}
+		return count;
+	}
+	JSONViewNode JSONViewNode::GetFirstChild() const noexcept
+	{
+		const JSONViewType type = GetType();
+		if ((type == JSONViewType::Object || type == JSONViewType::Array) && m_View->m_Links[m_Index] != m_Index + 1)
+		{
+			// Object members are laid out as key, colon, value
+			return {*m_View, m_Index + (type == JSONViewType::Object ? 3 : 1)};
+		}
+		return {};
+	}
+	JSONViewNode JSONViewNode::GetNextSibling() const noexcept
+	{
+		if (m_View && m_Index != 0)
+		{
+			const uint32_t next = m_View->GetValueEnd(m_Index) + 1;
+			if (m_View->GetChar(next) == ',')
+			{
+				return {*m_View, next + (IsMember() ? 3 : 1)};
+			}
+		}
+		return {};
+	}
+
+	JSONViewNode JSONViewNode::GetChild(std::string_view utf8Name) const
+	{
+		if (IsObject())
+		{
+			for (JSONViewNode node = GetFirstChild(); node; node = node.GetNextSibling())
+			{
+				const std::string_view key = m_View->GetRawString(node.m_Index - 2);
+				if (key.find('\\') == key.npos ? key == utf8Name : Unescape(key) == utf8Name)
+				{
+					return node;
+				}
+			}
+		}
+		return {};
+	}
+	JSONViewNode JSONViewNode::GetItem(size_t index) const noexcept
+	{
+		if (IsArray())
+		{
+			for (JSONViewNode node = GetFirstChild(); node; node = node.GetNextSibling())
+			{
+				if (index-- == 0)
+				{
+					return node;
+				}
+			}
+		}
+		return {};
+	}
+	JSONViewNode JSONViewNode::QueryElement(const String& path) const
+	{
+		JSONViewNode node = *this;
+
+		const std::string utf8 = path.ToUTF8();
+		std::string_view rest = utf8;
+		while (node && !rest.empty())
+		{
+			const size_t separator = rest.find('/');
+			const std::string_view name = rest.substr(0, separator);
+			rest = separator != rest.npos ? rest.substr(separator + 1) : std::string_view();
+
+			if (name.empty())
+			{
+				continue;
+			}
+			else if (node.IsArray())
+			{
+				size_t index = 0;
+				if (auto result = std::from_chars(name.data(), name.data() + name.size(), index); result.ec != std::errc() || result.ptr != name.data() + name.size())
+				{
+					return {};
+				}
+				node = node.GetItem(index);
+			}
+			else
+			{
+				node = node.GetChild(name);
+			}
+		}
+		return node;
+	}
+
+	std::optional<String> JSONViewNode::QueryName() const
+	{
+		if (m_View && IsMember())
+		{
+			const std::string_view key = m_View->GetRawString(m_Index - 2);
+			return key.find('\\') == key.npos ? String::FromUTF8(key) : String::FromUTF8(Unescape(key));
+		}
+		return {};
+	}
+
+	std::optional<std::string> JSONViewNode::QueryValueUTF8() const
+	{
+		switch (GetType())
+		{
+			case JSONViewType::String:
+			{
+				const std::string_view text = m_View->GetRawString(m_Index);
+				return text.find('\\') == text.npos ? std::string(text) : Unescape(text);
+			}
+			case JSONViewType::Number:
+			case JSONViewType::Boolean:
+			{
+				return std::string(GetRawJSON());
+			}
+		};
+		return {};
+	}
+	std::optional<String> JSONViewNode::QueryValue() const
+	{
+		if (GetType() == JSONViewType::String)
+		{
+			// Most strings have no escapes and can be converted without an intermediate copy
+			const std::string_view text = m_View->GetRawString(m_Index);
+			if (text.find('\\') == text.npos)
+			{
+				return String::FromUTF8(text);
+			}
+		}
+
+		if (auto value = QueryValueUTF8())
+		{
+			return String::FromUTF8(*value);
+		}
+		return {};
+	}
+	std::optional<bool> JSONViewNode::QueryValueBool() const noexcept
+	{
+		if (GetType() == JSONViewType::Boolean)
+		{
+			return m_View->GetChar(m_Index) == 't';
+		}
+		return {};
+	}
+	std::optional<double> JSONViewNode::QueryValueFloat() const noexcept
+	{
+		if (auto text = QueryNumberText())
+		{
+			// Values too small to be represented become zero, same as 'nlohmann::json' does it
+			double value = 0;
+			if (auto result = std::from_chars(text->data(), text->data() + text->size(), value); result.ec == std::errc())
+			{
+				return value;
+			}
+			else if (result.ec == std::errc::result_out_of_range && IsUnderflow(*text))
+			{
+				return text->front() == '-' ? -0.0 : 0.0;
+			}
+		}
+		return {};
+	}
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include "../Common.h"
+#include "kxf/IO/IStream.h"
+#include <charconv>
+
+namespace kxf
+{
+	class JSONView;
+	class MemoryStreamBuffer;
+
+	enum class JSONViewType
+	{
+		None = -1,
+
+		Object,
+		Array,
+		String,
+		Number,
+		Boolean,
+		Null
+	};
+}
+
+namespace kxf
+{
+	// Lightweight handle to a value inside a 'JSONView', valid as long as the view itself. Navigation is done directly
+	// over the structural index of the document, nothing is parsed until a value is actually requested.
+	class KX_API JSONViewNode final
+	{
+		friend class JSONView;
+
+		private:
+			const JSONView* m_View = nullptr;
+			uint32_t m_Index = 0;
+
+		private:
+			JSONViewNode(const JSONView& view, uint32_t index) noexcept
+				:m_View(&view), m_Index(index)
+			{
+			}
+
+			bool IsMember() const noexcept;
+			std::optional<std::string_view> QueryNumberText() const noexcept;
+
+		public:
+			JSONViewNode() noexcept = default;
+
+		public:
+			bool IsNull() const noexcept
+			{
+				return m_View == nullptr;
+			}
+			JSONViewType GetType() const noexcept;
+
+			bool IsObject() const noexcept
+			{
+				return GetType() == JSONViewType::Object;
+			}
+			bool IsArray() const noexcept
+			{
+				return GetType() == JSONViewType::Array;
+			}
+			bool IsString() const noexcept
+			{
+				return GetType() == JSONViewType::String;
+			}
+			bool IsNumber() const noexcept
+			{
+				return GetType() == JSONViewType::Number;
+			}
+			bool IsBoolean() const noexcept
+			{
+				return GetType() == JSONViewType::Boolean;
+			}
+			bool IsNullValue() const noexcept
+			{
+				return GetType() == JSONViewType::Null;
+			}
+
+			// Text of the value as it appears in the document, including quotes for strings and the whole body for containers
+			std::string_view GetRawJSON() const noexcept;
+
+			// Navigation
+			size_t GetChildrenCount() const noexcept;
+			bool HasChildren() const noexcept
+			{
+				return !GetFirstChild().IsNull();
+			}
+			JSONViewNode GetFirstChild() const noexcept;
+			JSONViewNode GetNextSibling() const noexcept;
+
+			// Object member by its name, array item by its index
+			JSONViewNode GetChild(std::string_view utf8Name) const;
+			JSONViewNode GetChild(const String& name) const
+			{
+				return GetChild(name.ToUTF8());
+			}
+			JSONViewNode GetItem(size_t index) const noexcept;
+
+			// Path of member names and array indices separated with '/', the same separator 'XDocument' uses
+			JSONViewNode QueryElement(const String& path) const;
+
+			// Name of the object member this value belongs to
+			std::optional<String> QueryName() const;
+			String GetName() const
+			{
+				return QueryName().value_or(NullString);
+			}
+
+		public:
+			// Values. Strings are unescaped on request, numbers and booleans are returned as their text.
+			std::optional<std::string> QueryValueUTF8() const;
+			std::optional<String> QueryValue() const;
+			String GetValue(String defaultValue = {}) const
+			{
+				return QueryValue().value_or(std::move(defaultValue));
+			}
+
+			std::optional<bool> QueryValueBool() const noexcept;
+			bool GetValueBool(bool defaultValue = false) const noexcept
+			{
+				return QueryValueBool().value_or(defaultValue);
+			}
+
+			std::optional<double> QueryValueFloat() const noexcept;
+			double GetValueFloat(double defaultValue = 0.0) const noexcept
+			{
+				return QueryValueFloat().value_or(defaultValue);
+			}
+
+			template<class T = int64_t> requires((std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T>)
+			std::optional<T> QueryValueInt() const noexcept
+			{
+				if constexpr(std::is_enum_v<T>)
+				{
+					if (auto value = QueryValueInt<std::underlying_type_t<T>>())
+					{
+						return static_cast<T>(*value);
+					}
+				}
+				else if (auto text = QueryNumberText())
+				{
+					// Fails for out of range values and for anything with a fraction or an exponent
+					T value = 0;
+					const char* end = text->data() + text->size();
+					if (auto result = std::from_chars(text->data(), end, value); result.ec == std::errc() && result.ptr == end)
+					{
+						return value;
+					}
+				}
+				return {};
+			}
+
+			template<class T = int64_t> requires((std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T>)
+			T GetValueInt(T defaultValue = {}) const noexcept
+			{
+				return QueryValueInt<T>().value_or(defaultValue);
+			}
+
+		public:
+			explicit operator bool() const noexcept
+			{
+				return !IsNull();
+			}
+			bool operator!() const noexcept
+			{
+				return IsNull();
+			}
+
+			bool operator==(const JSONViewNode& other) const noexcept
+			{
+				return m_View == other.m_View && m_Index == other.m_Index;
+			}
+	};
+}
+
+namespace kxf
+{
+	// Read-only JSON document. Loading builds an index of the structural characters with SIMD and validates the grammar
+	// over it, no tree is built and no values are copied or converted until they're requested through 'JSONViewNode'.
+	// The text either is copied into the view or, for spans and memory streams, is used in place and has to outlive it.
+	class KX_API JSONView final
+	{
+		friend class JSONViewNode;
+
+		private:
+			std::string m_Buffer;
+			std::string_view m_Data;
+
+			// Positions of every structural character and of the first character of every string and scalar,
+			// and for every '{' and '[' the index of the matching closing bracket.
+			std::vector<uint32_t> m_Tape;
+			std::vector<uint32_t> m_Links;
+
+			String m_ErrorMessage;
+			size_t m_ErrorOffset = 0;
+
+		private:
+			bool DoLoad(std::string_view json);
+			bool SetError(const char* message, size_t offset);
+
+			bool BuildIndex();
+			bool ValidateIndex();
+			bool ValidateScalar(uint32_t index);
+
+			char GetChar(uint32_t index) const noexcept
+			{
+				return m_Data[m_Tape[index]];
+			}
+			size_t GetTokenEnd(uint32_t index) const noexcept
+			{
+				return index + 1 < m_Tape.size() ? m_Tape[index + 1] : m_Data.size();
+			}
+			uint32_t GetValueEnd(uint32_t index) const noexcept
+			{
+				const char c = GetChar(index);
+				return c == '{' || c == '[' ? m_Links[index] : index;
+			}
+			std::string_view GetRawString(uint32_t index) const noexcept;
+
+		public:
+			JSONView() noexcept = default;
+			JSONView(const String& json)
+			{
+				Load(json);
+			}
+			JSONView(std::span<const std::byte> json)
+			{
+				Load(json);
+			}
+			JSONView(const MemoryStreamBuffer& buffer)
+			{
+				Load(buffer);
+			}
+			JSONView(IInputStream& stream)
+			{
+				Load(stream);
+			}
+			JSONView(const JSONView&) = delete;
+
+		public:
+			bool IsNull() const noexcept
+			{
+				return m_Tape.empty();
+			}
+			void Clear() noexcept;
+
+			bool Load(const String& json);
+			bool LoadUTF8(std::string json);
+			bool Load(std::span<const std::byte> json);
+			bool Load(const MemoryStreamBuffer& buffer);
+			bool Load(IInputStream& stream);
+
+			const String& GetErrorMessage() const noexcept
+			{
+				return m_ErrorMessage;
+			}
+			size_t GetErrorOffset() const noexcept
+			{
+				return m_ErrorOffset;
+			}
+
+			JSONViewNode GetRoot() const noexcept
+			{
+				return !m_Tape.empty() ? JSONViewNode(*this, 0) : JSONViewNode();
+			}
+			JSONViewNode QueryElement(const String& path) const
+			{
+				return GetRoot().QueryElement(path);
+			}
+
+		public:
+			explicit operator bool() const noexcept
+			{
+				return !IsNull();
+			}
+			bool operator!() const noexcept
+			{
+				return IsNull();
+			}
+
+			JSONView& operator=(const JSONView&) = delete;
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "kxf/Serialization/Common.h"
+
+namespace kxf::JSON::Private
+{
+	// Validation state for a UTF-8 sequence crossing block or buffer boundaries: number of continuation bytes still expected and
+	// the allowed range for the next one, narrower than usual right after lead bytes which could start an overlong form,
+	// a surrogate or a code point above U+10FFFF.
+	struct UTF8State final
+	{
+		uint8_t Remaining = 0;
+		uint8_t Lower = 0x80;
+		uint8_t Upper = 0xBF;
+	};
+
+	// Returns the index of the first invalid byte or 'size' if there's none
+	inline size_t ValidateUTF8(const char* data, size_t size, UTF8State& state) noexcept
+	{
+		for (size_t i = 0; i < size; i++)
+		{
+			const auto c = static_cast<uint8_t>(data[i]);
+			if (state.Remaining != 0)
+			{
+				if (c < state.Lower || c > state.Upper)
+				{
+					return i;
+				}
+				state.Remaining--;
+				state.Lower = 0x80;
+				state.Upper = 0xBF;
+			}
+			else if (c >= 0x80)
+			{
+				if (c >= 0xC2 && c <= 0xDF)
+				{
+					state.Remaining = 1;
+				}
+				else if (c >= 0xE0 && c <= 0xEF)
+				{
+					state.Remaining = 2;
+					state.Lower = c == 0xE0 ? 0xA0 : 0x80;
+					state.Upper = c == 0xED ? 0x9F : 0xBF;
+				}
+				else if (c >= 0xF0 && c <= 0xF4)
+				{
+					state.Remaining = 3;
+					state.Lower = c == 0xF0 ? 0x90 : 0x80;
+					state.Upper = c == 0xF4 ? 0x8F : 0xBF;
+				}
+				else
+				{
+					return i;
+				}
+			}
+		}
+		return size;
+	}
+}
@@ -3,10 +3,14 @@
 #include "Private/Utility.h"
 #include "kxf/Network/URI.h"
 #include "kxf/Utility/SoftwareLicenseDB.h"
+#include "kxf/Threading/LockGuard.h"
 
 namespace
 {
 	constexpr char g_Copyright[] = "Copyright© Lee Thomason";
+
+	// Nodes with up to this many child elements are just walked through on every search
+	constexpr size_t g_ChildIndexThreshold = 32;
 }
 
 namespace kxf
@@ -38,9 +42,108 @@ namespace kxf
 	}
 	void XMLDocument::DoUnload()
 	{
+		ResetChildIndex();
 		m_Document.Clear();
 	}
 
+	XMLDocument::ChildElementInfo XMLDocument::FindChildElement(const tinyxml2::XMLNode& node, std::string_view name, size_t index) const
+	{
+		auto SearchIndex = [&](const ChildIndex& childIndex)
+		{
+			ChildElementInfo info;
+			if (auto it = childIndex.find(name); it != childIndex.end())
+			{
+				const auto& elements = it->second;
+				if (index < elements.size())
+				{
+					info.Element = elements[index];
+				}
+				else
+				{
+					info.LastElement = elements.back();
+					info.Count = elements.size();
+				}
+			}
+			return info;
+		};
+
+		if (ReadLockGuard lock(m_ChildIndexLock); !m_ChildIndex.empty())
+		{
+			if (auto it = m_ChildIndex.find(&node); it != m_ChildIndex.end())
+			{
+				return SearchIndex(it->second);
+			}
+		}
+
+		ChildElementInfo info;
+		size_t elementCount = 0;
+		for (tinyxml2::XMLElement* element = const_cast<tinyxml2::XMLNode&>(node).FirstChildElement(); element; element = element->NextSiblingElement())
+		{
+			if (++elementCount > g_ChildIndexThreshold)
+			{
+				// Too many children to walk through them every time, index them all at once instead
+				WriteLockGuard lock(m_ChildIndexLock);
+
+				auto [it, inserted] = m_ChildIndex.try_emplace(&node);
+				if (inserted)
+				{
+					ChildIndex& childIndex = it->second;
+					for (tinyxml2::XMLElement* child = const_cast<tinyxml2::XMLNode&>(node).FirstChildElement(); child; child = child->NextSiblingElement())
+					{
+						const std::string_view childName = child->Name();
+						if (auto childIt = childIndex.find(childName); childIt != childIndex.end())
+						{
+							childIt->second.push_back(child);
+						}
+						else
+						{
+							childIndex.emplace(childName, std::vector<tinyxml2::XMLElement*>{child});
+						}
+					}
+				}
+				return SearchIndex(it->second);
+			}
+
+			if (element->Name() == name)
+			{
+				if (info.Count == index)
+				{
+					return {element};
+				}
+				info.LastElement = element;
+				info.Count++;
+			}
+		}
+		return info;
+	}
+	void XMLDocument::OnChildElementAdded(const tinyxml2::XMLNode& node, tinyxml2::XMLElement& element)
+	{
+		// The element has been inserted after all its same-named siblings, so it can just be appended to the existing index
+		WriteLockGuard lock(m_ChildIndexLock);
+		if (auto it = m_ChildIndex.find(&node); it != m_ChildIndex.end())
+		{
+			const std::string_view name = element.Name();
+			if (auto childIt = it->second.find(name); childIt != it->second.end())
+			{
+				childIt->second.push_back(&element);
+			}
+			else
+			{
+				it->second.emplace(name, std::vector<tinyxml2::XMLElement*>{&element});
+			}
+		}
+	}
+	void XMLDocument::ResetChildIndex(const tinyxml2::XMLNode& node)
+	{
+		WriteLockGuard lock(m_ChildIndexLock);
+		m_ChildIndex.erase(&node);
+	}
+	void XMLDocument::ResetChildIndex()
+	{
+		WriteLockGuard lock(m_ChildIndexLock);
+		m_ChildIndex.clear();
+	}
+
 	RTTI::QueryInfo XMLDocument::DoQueryInterface(const IID& iid) noexcept
 	{
 		if (iid.IsOfType<ILibraryInfo>())
@@ -147,6 +250,13 @@ namespace kxf
 	}
 	bool XMLDocument::Load(IInputStream& stream)
 	{
+		// Parse the stream memory in place if it's available
+		if (auto view = stream.ReadView(std::numeric_limits<size_t>::max()); !view.empty())
+		{
+			DoLoad(reinterpret_cast<const char*>(view.data()), view.size());
+			return !IsNull();
+		}
+
 		wxMemoryBuffer buffer;
 		buffer.SetBufSize(stream.GetSize().ToBytes());
 		stream.ReadAll(buffer.GetData(), buffer.GetBufSize());
@@ -167,6 +277,7 @@ namespace kxf
 	{
 		if (!IsNull() && node)
 		{
+			ResetChildIndex();
 			m_Document.DeleteNode(node.GetNode());
 			return true;
 		}
@@ -4,12 +4,14 @@
 #include "../BinarySerializer.h"
 #include "kxf/Core/ILibraryInfo.h"
 #include "kxf/IO/IStream.h"
+#include "kxf/Threading/ReadWriteLock.h"
 #include "TinyXML2.h"
 #include <wx/stream.h>
 
 namespace kxf
 {
 	class XMLNode;
+	class XMLQuery;
 	class XMLDocument;
 	class XMLAttribute;
 }
@@ -97,6 +99,71 @@ namespace kxf
 	};
 }
 
+namespace kxf
+{
+	// XPath split into element names and indices once, so it can be applied to any number of nodes without parsing it again.
+	// Names are converted to UTF-8 once and compared through the child index of the nodes the query is applied to.
+	class KX_API XMLQuery final
+	{
+		friend class XMLNode;
+
+		private:
+			struct Segment final
+			{
+				String Name;
+				std::string NameUTF8;
+				size_t Index = 0;
+			};
+
+		private:
+			std::vector<Segment> m_Segments;
+
+		public:
+			XMLQuery() = default;
+			XMLQuery(const String& xPath, StringView indexSeparator = kxS("::"));
+
+		public:
+			bool IsNull() const noexcept
+			{
+				return m_Segments.empty();
+			}
+			size_t GetSegmentCount() const noexcept
+			{
+				return m_Segments.size();
+			}
+
+			const String& GetName(size_t segment) const noexcept
+			{
+				return segment < m_Segments.size() ? m_Segments[segment].Name : NullString;
+			}
+			size_t GetIndex(size_t segment) const noexcept
+			{
+				return segment < m_Segments.size() ? m_Segments[segment].Index : 0;
+			}
+
+			// Allows to walk over same-named elements ('items/item::N') without compiling the path for every index
+			bool SetIndex(size_t segment, size_t index) noexcept
+			{
+				if (segment < m_Segments.size())
+				{
+					m_Segments[segment].Index = index;
+					return true;
+				}
+				return false;
+			}
+
+		public:
+			explicit operator bool() const noexcept
+			{
+				return !IsNull();
+			}
+			bool operator!() const noexcept
+			{
+				return IsNull();
+			}
+	};
+}
+
 namespace kxf
 {
 	class KX_API XMLNode: public XDocument::XNode<XMLNode>
@@ -114,7 +181,7 @@ namespace kxf
 			tinyxml2::XMLNode* m_Node = nullptr;
 
 		private:
-			XMLNode ConstructOrQueryElement(const String& xPath, bool allowCreate);
+			XMLNode ConstructOrQueryElement(const XMLQuery& query, bool allowCreate);
 
 		protected:
 			const tinyxml2::XMLNode* GetNode() const
@@ -161,7 +228,12 @@ namespace kxf
 			}
 			String GetXPath() const override;
 			XMLNode QueryElement(const String& xPath) const override;
+			XMLNode QueryElement(const XMLQuery& query) const;
 			XMLNode ConstructElement(const String& xPath) override;
+			XMLNode ConstructElement(const XMLQuery& query);
+
+			// Compiles the path using the index separator of this document
+			XMLQuery CompileQuery(const String& xPath) const;
 
 			String GetXPathIndexSeparator() const override;
 			void SetXPathIndexSeparator(const String& value) override;
@@ -257,11 +329,37 @@ namespace kxf
 	{
 		friend class XMLNode;
 
+		private:
+			// Result of a search for the element with the given name and index among the children of a node.
+			// 'Count' and 'LastElement' (the number of such elements and the last of them) are only filled if it wasn't found.
+			struct ChildElementInfo final
+			{
+				tinyxml2::XMLElement* Element = nullptr;
+				tinyxml2::XMLElement* LastElement = nullptr;
+				size_t Count = 0;
+			};
+			struct ChildNameHash final
+			{
+				using is_transparent = void;
+
+				size_t operator()(std::string_view value) const noexcept
+				{
+					return std::hash<std::string_view>()(value);
+				}
+			};
+
+			// Keyed by the UTF-8 names owned by the index itself, so they go away together with the document
+			using ChildIndex = std::unordered_map<std::string, std::vector<tinyxml2::XMLElement*>, ChildNameHash, std::equal_to<>>;
+
 		private:
 			tinyxml2::XMLDocument m_Document;
 			String m_DeclaredEncoding;
 			String m_XPathIndexSeparator;
 
+			// Element children grouped by name, built on first search for nodes with too many children to be walked every time
+			mutable std::unordered_map<const tinyxml2::XMLNode*, ChildIndex> m_ChildIndex;
+			mutable ReadWriteLock m_ChildIndexLock;
+
 		private:
 			tinyxml2::XMLDocument* GetDocument()
 			{
@@ -273,6 +371,15 @@ namespace kxf
 			void DoLoad(const char* xml, size_t length);
 			void DoUnload();
 
+			ChildElementInfo FindChildElement(const tinyxml2::XMLNode& node, std::string_view name, size_t index) const;
+			void OnChildElementAdded(const tinyxml2::XMLNode& node, tinyxml2::XMLElement& element);
+
+			// Children of the node were added, moved or renamed
+			void ResetChildIndex(const tinyxml2::XMLNode& node);
+
+			// Elements were deleted, their memory can be reused for new ones so nothing in the index can be trusted anymore
+			void ResetChildIndex();
+
 			RTTI::QueryInfo DoQueryInterface(const IID& iid) noexcept override;
 
 		private:
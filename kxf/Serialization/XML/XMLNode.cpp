@@ -1,72 +1,52 @@
 #include "KxfPCH.h"
 #include "XMLDocument.h"
 #include "Private/Utility.h"
-#include "kxf/Core/IEncodingConverter.h"
 
 namespace kxf
 {
-	XMLNode XMLNode::ConstructOrQueryElement(const String& xPath, bool allowCreate)
+	XMLNode XMLNode::ConstructOrQueryElement(const XMLQuery& query, bool allowCreate)
 	{
-		if (!IsNull())
+		if (!IsNull() && !query.IsNull())
 		{
-			tinyxml2::XMLDocument& document = GetDocument().m_Document;
+			XMLDocument& document = GetDocument();
 			tinyxml2::XMLNode* currentNode = GetNode();
-			tinyxml2::XMLNode* previousNode = currentNode;
 
-			size_t itemCount = xPath.SplitBySeparator(GetXPathSeparator(), [&](StringView name)
+			for (const XMLQuery::Segment& segment: query.m_Segments)
 			{
-				// Save previous element
-				if (!currentNode)
-				{
-					return false;
-				}
-				previousNode = currentNode;
+				tinyxml2::XMLNode* parentNode = currentNode;
 
-				// Extract index from name and remove it from path, zero-based
-				// point/x -> 0, point/x::1 -> 1, point/y::0 -> 0, point/z::-7 -> 0
-				auto [elementName, index] = XNode::ExtractIndexFromName(name, StringViewOf(GetDocument().m_XPathIndexSeparator));
-				auto elementNameUTF8 = EncodingConverter_UTF8.ToMultiByte(name);
-
-				// Get level 0
-				currentNode = previousNode->FirstChildElement(elementNameUTF8.data());
-				if (!currentNode)
+				auto info = document.FindChildElement(*parentNode, segment.NameUTF8, segment.Index);
+				if (info.Element)
 				{
-					if (allowCreate)
-					{
-						currentNode = document.NewElement(elementNameUTF8.data());
-						previousNode->InsertEndChild(currentNode);
-					}
-					else
-					{
-						return false;
-					}
+					currentNode = info.Element;
 				}
-
-				// We need to go down by 'index' more elements
-				for (int level = 1; level <= index; level++)
+				else if (allowCreate)
 				{
-					// Get next level
-					currentNode = currentNode->NextSiblingElement(elementNameUTF8.data());
-					if (!currentNode)
+					// Create every missing element up to the requested index after the last existing one with the same name
+					tinyxml2::XMLElement* lastElement = info.LastElement;
+					for (size_t i = info.Count; i <= segment.Index; i++)
 					{
-						if (allowCreate)
+						tinyxml2::XMLElement* element = document.m_Document.NewElement(segment.NameUTF8.c_str());
+						if (lastElement)
 						{
-							currentNode = document.NewElement(elementNameUTF8.data());
-							previousNode->InsertAfterChild(previousNode, currentNode);
+							parentNode->InsertAfterChild(lastElement, element);
 						}
 						else
 						{
-							return false;
+							parentNode->InsertEndChild(element);
 						}
+						document.OnChildElementAdded(*parentNode, *element);
+
+						lastElement = element;
 					}
+					currentNode = lastElement;
+				}
+				else
+				{
+					return {};
 				}
-				return true;
-			});
-
-			if (currentNode && itemCount != 0)
-			{
-				return XMLNode(currentNode, GetDocument());
 			}
+			return XMLNode(currentNode, document);
 		}
 		return {};
 	}
@@ -155,6 +135,11 @@ namespace kxf
 			{
 				if (!value.IsEmpty())
 				{
+					if (node->FirstChildElement())
+					{
+						m_Document->ResetChildIndex();
+					}
+
 					auto utf8 = value.ToUTF8();
 					tinyxml2::XMLText* textNode = m_Document->GetDocument()->NewText(utf8.data());
 
@@ -290,11 +275,28 @@ namespace kxf
 	}
 	XMLNode XMLNode::QueryElement(const String& xPath) const
 	{
-		return const_cast<XMLNode&>(*this).ConstructOrQueryElement(xPath, false);
+		return const_cast<XMLNode&>(*this).ConstructOrQueryElement(CompileQuery(xPath), false);
+	}
+	XMLNode XMLNode::QueryElement(const XMLQuery& query) const
+	{
+		return const_cast<XMLNode&>(*this).ConstructOrQueryElement(query, false);
 	}
 	XMLNode XMLNode::ConstructElement(const String& xPath)
 	{
-		return const_cast<XMLNode&>(*this).ConstructOrQueryElement(xPath, true);
+		return ConstructOrQueryElement(CompileQuery(xPath), true);
+	}
+	XMLNode XMLNode::ConstructElement(const XMLQuery& query)
+	{
+		return ConstructOrQueryElement(query, true);
+	}
+
+	XMLQuery XMLNode::CompileQuery(const String& xPath) const
+	{
+		if (m_Document)
+		{
+			return XMLQuery(xPath, StringViewOf(m_Document->m_XPathIndexSeparator));
+		}
+		return XMLQuery(xPath);
 	}
 
 	String XMLNode::GetXPathIndexSeparator() const
@@ -349,6 +351,11 @@ namespace kxf
 			{
 				auto utf8 = name.ToUTF8();
 				node->SetName(utf8.data());
+
+				if (auto parent = node->Parent())
+				{
+					m_Document->ResetChildIndex(*parent);
+				}
 				return true;
 			}
 		}
@@ -380,6 +387,10 @@ namespace kxf
 	{
 		if (auto node = GetNode())
 		{
+			if (node->FirstChildElement())
+			{
+				m_Document->ResetChildIndex();
+			}
 			node->DeleteChildren();
 			return true;
 		}
@@ -714,8 +725,7 @@ namespace kxf
 			}
 			else
 			{
-				auto utf8 = name.ToUTF8();
-				return XMLNode(node->FirstChildElement(utf8.data()), *m_Document);
+				return XMLNode(m_Document->FindChildElement(*node, name.ToUTF8(), 0).Element, *m_Document);
 			}
 		}
 		return {};
@@ -738,8 +748,7 @@ namespace kxf
 			}
 			else
 			{
-				auto utf8 = name.ToUTF8();
-				return XMLNode(node->LastChildElement(utf8.data()), *m_Document);
+				return XMLNode(m_Document->FindChildElement(*node, name.ToUTF8(), std::numeric_limits<size_t>::max()).LastElement, *m_Document);
 			}
 		}
 		return {};
@@ -772,7 +781,16 @@ namespace kxf
 
 		if (thisTxNode && newTxNode)
 		{
-			return thisTxNode->InsertAfterChild(thisTxNode, newTxNode) != nullptr;
+			// The node is moved if it's already in the tree
+			if (auto parent = newTxNode->Parent())
+			{
+				m_Document->ResetChildIndex(*parent);
+			}
+			if (thisTxNode->InsertAfterChild(thisTxNode, newTxNode))
+			{
+				m_Document->ResetChildIndex(*newTxNode->Parent());
+				return true;
+			}
 		}
 		return false;
 	}
@@ -783,7 +801,16 @@ namespace kxf
 
 		if (thisTxNode && newTxNode)
 		{
-			return thisTxNode->InsertFirstChild(newTxNode) != nullptr;
+			// The node is moved if it's already in the tree
+			if (auto parent = newTxNode->Parent())
+			{
+				m_Document->ResetChildIndex(*parent);
+			}
+			if (thisTxNode->InsertFirstChild(newTxNode))
+			{
+				m_Document->ResetChildIndex(*newTxNode->Parent());
+				return true;
+			}
 		}
 		return false;
 	}
@@ -794,7 +821,20 @@ namespace kxf
 
 		if (thisTxNode && newTxNode)
 		{
-			return thisTxNode->InsertEndChild(newTxNode) != nullptr;
+			// The node is moved if it's already in the tree
+			if (auto parent = newTxNode->Parent())
+			{
+				m_Document->ResetChildIndex(*parent);
+			}
+			if (thisTxNode->InsertEndChild(newTxNode))
+			{
+				// Appending an element keeps the order of its same-named siblings so the index can be updated in place
+				if (auto element = newTxNode->ToElement())
+				{
+					m_Document->OnChildElementAdded(*thisTxNode, *element);
+				}
+				return true;
+			}
 		}
 		return false;
 	}
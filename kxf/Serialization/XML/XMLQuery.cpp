@@ -0,0 +1,26 @@
+#include "KxfPCH.h"
+#include "XMLDocument.h"
+
+namespace kxf
+{
+	XMLQuery::XMLQuery(const String& xPath, StringView indexSeparator)
+	{
+		if (xPath.IsEmpty())
+		{
+			return;
+		}
+
+		// Same separator 'IXNode::GetXPathSeparator' returns
+		xPath.SplitBySeparator(kxS("/"), [&](StringView name)
+		{
+			// Extract index from name and remove it from path, zero-based
+			// point/x -> 0, point/x::1 -> 1, point/y::0 -> 0, point/z::-7 -> 0
+			auto [elementName, index] = XDocument::IXNode::ExtractIndexFromName(name, indexSeparator);
+			String segmentName = elementName;
+			std::string segmentNameUTF8 = segmentName.ToUTF8();
+			m_Segments.emplace_back(Segment{std::move(segmentName), std::move(segmentNameUTF8), static_cast<size_t>(index)});
+
+			return true;
+		});
+	}
+}
@@ -24,6 +24,10 @@
 #include <d2d1_2helper.h>
 #pragma comment(lib, "dxgi.lib")
 
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#endif
+
 #include "UndefWindows.h"
 
 namespace
@@ -42,6 +46,64 @@ namespace
 			versionInfo.ProductType != SystemProductType::Unknown &&
 			versionInfo.ProductSuite != SystemProductSuite::None;
 	}
+
+	uint32_t DetectProcessorFeatures() noexcept
+	{
+		using namespace kxf;
+
+		uint32_t features = 0;
+		auto Add = [&](ProcessorFeature feature, bool isPresent)
+		{
+			if (isPresent)
+			{
+				features |= 1u << static_cast<uint32_t>(feature);
+			}
+		};
+		auto TestBit = [](int value, int bit)
+		{
+			return ((static_cast<uint32_t>(value) >> bit) & 1u) != 0;
+		};
+
+		#if defined(_M_IX86) || defined(_M_X64)
+		int info[4] = {};
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		const int ecx1 = info[2];
+		const int edx1 = info[3];
+
+		// AVX registers are only usable if the OS saves their state on context switches
+		const uint64_t xcr0 = TestBit(ecx1, 27) ? _xgetbv(0) : 0;
+		const bool isYMMEnabled = (xcr0 & 0x06) == 0x06;
+		const bool isZMMEnabled = (xcr0 & 0xE6) == 0xE6;
+
+		Add(ProcessorFeature::SSE2, TestBit(edx1, 26));
+		Add(ProcessorFeature::SSSE3, TestBit(ecx1, 9));
+		Add(ProcessorFeature::SSE4_1, TestBit(ecx1, 19));
+		Add(ProcessorFeature::SSE4_2, TestBit(ecx1, 20));
+		Add(ProcessorFeature::POPCNT, TestBit(ecx1, 23));
+		Add(ProcessorFeature::PCLMULQDQ, TestBit(ecx1, 1));
+		Add(ProcessorFeature::AVX, TestBit(ecx1, 28) && isYMMEnabled);
+
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			const int ebx7 = info[1];
+			const int ecx7 = info[2];
+
+			Add(ProcessorFeature::AVX2, TestBit(ebx7, 5) && isYMMEnabled);
+			Add(ProcessorFeature::BMI1, TestBit(ebx7, 3));
+			Add(ProcessorFeature::BMI2, TestBit(ebx7, 8));
+			Add(ProcessorFeature::AVX512F, TestBit(ebx7, 16) && isZMMEnabled);
+			Add(ProcessorFeature::AVX512BW, TestBit(ebx7, 30) && isZMMEnabled);
+			Add(ProcessorFeature::AVX512VL, TestBit(ebx7, 31) && isZMMEnabled);
+			Add(ProcessorFeature::VPCLMULQDQ, TestBit(ecx7, 10) && isYMMEnabled);
+		}
+		#endif
+
+		return features;
+	}
 }
 
 namespace kxf::System
@@ -480,6 +542,11 @@ namespace kxf::System
 	{
 		return wxSystemSettings::HasFeature(static_cast<wxSystemFeature>(feature));
 	}
+	bool HasFeature(ProcessorFeature feature) noexcept
+	{
+		static const uint32_t features = DetectProcessorFeatures();
+		return (features & (1u << static_cast<uint32_t>(feature))) != 0;
+	}
 	Enumerator<String> EnumStandardSounds()
 	{
 		RegistryKey key(RegistryRootKey::CurrentUser, "AppEvents\\EventLabels", RegistryAccess::Read|RegistryAccess::Enumerate);
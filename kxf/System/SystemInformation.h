@@ -133,6 +133,7 @@ namespace kxf::System
 	KX_API Size GetMetric(SystemSizeMetric index, const wxWindow* window = nullptr) noexcept;
 	KX_API TimeSpan GetMetric(SystemTimeMetric index, const wxWindow* window = nullptr) noexcept;
 	KX_API bool HasFeature(SystemFeature feature) noexcept;
+	KX_API bool HasFeature(ProcessorFeature feature) noexcept;
 	KX_API Enumerator<String> EnumStandardSounds();
 
 	KX_API std::optional<DisplayInfo> GetDisplayInfo() noexcept;
@@ -255,6 +255,23 @@ namespace kxf
 		MinimizeFrame = wxSYS_CAN_ICONIZE_FRAME,
 		TabletPresent = wxSYS_TABLET_PRESENT,
 	};
+	enum class ProcessorFeature
+	{
+		SSE2,
+		SSSE3,
+		SSE4_1,
+		SSE4_2,
+		POPCNT,
+		PCLMULQDQ,
+		AVX,
+		AVX2,
+		BMI1,
+		BMI2,
+		AVX512F,
+		AVX512BW,
+		AVX512VL,
+		VPCLMULQDQ
+	};
 
 	enum class SystemColor
 	{
@@ -0,0 +1,128 @@
+#include "KxfPCH.h"
+#include "Parallel.h"
+#include <mutex>
+
+namespace
+{
+	// How many chunks each thread should get on average, more chunks means better load balancing
+	// when the per-element cost is uneven at the expense of more scheduling overhead.
+	constexpr size_t g_ChunksPerThread = 8;
+
+	class ParallelState final
+	{
+		private:
+			const size_t m_Begin = 0;
+			const size_t m_End = 0;
+			const size_t m_GrainSize = 0;
+			const size_t m_ChunkCount = 0;
+
+			void* m_Context = nullptr;
+			kxf::Parallel::Private::ChunkFunction m_Function = nullptr;
+
+			std::atomic<size_t> m_NextChunk = 0;
+			std::atomic<size_t> m_CompletedChunks = 0;
+			std::atomic<bool> m_IsCancelled = false;
+
+			std::exception_ptr m_Exception;
+			std::mutex m_ExceptionLock;
+
+		public:
+			ParallelState(size_t begin, size_t end, size_t grainSize, void* context, kxf::Parallel::Private::ChunkFunction func) noexcept
+				:m_Begin(begin), m_End(end), m_GrainSize(grainSize), m_ChunkCount((end - begin + grainSize - 1) / grainSize), m_Context(context), m_Function(func)
+			{
+			}
+
+		public:
+			size_t GetChunkCount() const noexcept
+			{
+				return m_ChunkCount;
+			}
+
+			// The user function and its context are only touched after a chunk has been successfully claimed.
+			// The caller doesn't return until all claimed chunks are completed, so helper tasks that start late
+			// never access the (by then destroyed) context.
+			void Work() noexcept
+			{
+				while (true)
+				{
+					const size_t chunk = m_NextChunk.fetch_add(1, std::memory_order_relaxed);
+					if (chunk >= m_ChunkCount)
+					{
+						return;
+					}
+
+					if (!m_IsCancelled.load(std::memory_order_relaxed))
+					{
+						const size_t first = m_Begin + chunk * m_GrainSize;
+						const size_t last = std::min(first + m_GrainSize, m_End);
+
+						try
+						{
+							std::invoke(m_Function, m_Context, first, last);
+						}
+						catch (...)
+						{
+							if (std::unique_lock lock(m_ExceptionLock); !m_Exception)
+							{
+								m_Exception = std::current_exception();
+							}
+							m_IsCancelled = true;
+						}
+					}
+
+					if (m_CompletedChunks.fetch_add(1, std::memory_order_acq_rel) + 1 == m_ChunkCount)
+					{
+						m_CompletedChunks.notify_all();
+					}
+				}
+			}
+			void WaitCompletion()
+			{
+				size_t completed = 0;
+				while ((completed = m_CompletedChunks.load(std::memory_order_acquire)) != m_ChunkCount)
+				{
+					m_CompletedChunks.wait(completed, std::memory_order_acquire);
+				}
+
+				if (m_Exception)
+				{
+					std::rethrow_exception(m_Exception);
+				}
+			}
+	};
+}
+
+namespace kxf::Parallel::Private
+{
+	size_t GetGrainSize(const IThreadPool& pool, size_t count, size_t grainSize) noexcept
+	{
+		if (grainSize != 0)
+		{
+			return grainSize;
+		}
+
+		const size_t chunkCount = std::max<size_t>(pool.GetConcurrency(), 1) * g_ChunksPerThread;
+		return std::max<size_t>((count + chunkCount - 1) / chunkCount, 1);
+	}
+
+	void Execute(IThreadPool& pool, size_t begin, size_t end, size_t grainSize, void* context, ChunkFunction func)
+	{
+		auto state = std::make_shared<ParallelState>(begin, end, std::max<size_t>(grainSize, 1), context, func);
+
+		// The calling thread is one of the participants so it needs one less helper
+		if (pool.IsRunning())
+		{
+			const size_t helperCount = std::min(pool.GetConcurrency(), state->GetChunkCount() - 1);
+			for (size_t i = 0; i < helperCount; i++)
+			{
+				pool.AddTask([state]()
+				{
+					state->Work();
+				});
+			}
+		}
+
+		state->Work();
+		state->WaitCompletion();
+	}
+}
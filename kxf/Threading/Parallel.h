@@ -0,0 +1,146 @@
+#pragma once
+#include "Common.h"
+#include "IThreadPool.h"
+#include <iterator>
+
+namespace kxf::Parallel::Private
+{
+	using ChunkFunction = void(*)(void* context, size_t first, size_t last);
+
+	KX_API size_t GetGrainSize(const IThreadPool& pool, size_t count, size_t grainSize) noexcept;
+	KX_API void Execute(IThreadPool& pool, size_t begin, size_t end, size_t grainSize, void* context, ChunkFunction func);
+}
+
+namespace kxf::Parallel
+{
+	// All the algorithms below split the range into chunks of 'grainSize' elements (chosen automatically when zero)
+	// and process them on the thread pool. The calling thread takes chunks too and returns only when the entire
+	// range has been processed, so it's safe to call these functions from inside the pool's own tasks.
+	// The first exception thrown by the user function cancels the remaining chunks and is rethrown to the caller.
+
+	template<class TFunc>
+	requires(std::is_invocable_v<TFunc, size_t, size_t>)
+	void ForRange(IThreadPool& pool, size_t begin, size_t end, TFunc&& func, size_t grainSize = 0)
+	{
+		if (begin < end)
+		{
+			// Constness of the function is restored on the other side, the context is only passed through
+			void* context = const_cast<void*>(static_cast<const void*>(std::addressof(func)));
+			Private::Execute(pool, begin, end, Private::GetGrainSize(pool, end - begin, grainSize), context, [](void* context, size_t first, size_t last)
+			{
+				std::invoke(*static_cast<std::remove_reference_t<TFunc>*>(context), first, last);
+			});
+		}
+	}
+
+	template<class TFunc>
+	requires(std::is_invocable_v<TFunc, size_t>)
+	void For(IThreadPool& pool, size_t begin, size_t end, TFunc&& func, size_t grainSize = 0)
+	{
+		ForRange(pool, begin, end, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				std::invoke(func, i);
+			}
+		}, grainSize);
+	}
+
+	template<std::random_access_iterator TIterator, class TFunc>
+	requires(std::is_invocable_v<TFunc, std::iter_reference_t<TIterator>>)
+	void ForEach(IThreadPool& pool, TIterator first, TIterator last, TFunc&& func, size_t grainSize = 0)
+	{
+		ForRange(pool, 0, static_cast<size_t>(last - first), [&](size_t chunkFirst, size_t chunkLast)
+		{
+			std::for_each(first + chunkFirst, first + chunkLast, [&](auto&& item)
+			{
+				std::invoke(func, std::forward<decltype(item)>(item));
+			});
+		}, grainSize);
+	}
+
+	template<std::random_access_iterator TInIterator, std::random_access_iterator TOutIterator, class TFunc>
+	requires(std::is_invocable_v<TFunc, std::iter_reference_t<TInIterator>>)
+	TOutIterator Transform(IThreadPool& pool, TInIterator first, TInIterator last, TOutIterator destination, TFunc&& func, size_t grainSize = 0)
+	{
+		const size_t count = static_cast<size_t>(last - first);
+		ForRange(pool, 0, count, [&](size_t chunkFirst, size_t chunkLast)
+		{
+			std::transform(first + chunkFirst, first + chunkLast, destination + chunkFirst, [&](auto&& item) -> decltype(auto)
+			{
+				return std::invoke(func, std::forward<decltype(item)>(item));
+			});
+		}, grainSize);
+
+		return destination + count;
+	}
+
+	// The reduction function must be associative and accept both (T, element) and (T, T) pairs since partial
+	// results of each chunk are combined with the same function, in the order of the input range.
+	template<std::random_access_iterator TIterator, class T, class TReduce = std::plus<>>
+	requires(std::is_invocable_r_v<T, TReduce, T, std::iter_reference_t<TIterator>> && std::is_invocable_r_v<T, TReduce, T, T>)
+	T Reduce(IThreadPool& pool, TIterator first, TIterator last, T init, TReduce&& reduce = {}, size_t grainSize = 0)
+	{
+		const size_t count = static_cast<size_t>(last - first);
+		if (count == 0)
+		{
+			return init;
+		}
+
+		const size_t grain = Private::GetGrainSize(pool, count, grainSize);
+		std::vector<std::optional<T>> partials((count + grain - 1) / grain);
+
+		ForRange(pool, 0, count, [&](size_t chunkFirst, size_t chunkLast)
+		{
+			T value = static_cast<T>(*(first + chunkFirst));
+			for (size_t i = chunkFirst + 1; i < chunkLast; i++)
+			{
+				value = std::invoke(reduce, std::move(value), *(first + i));
+			}
+			partials[chunkFirst / grain] = std::move(value);
+		}, grain);
+
+		for (auto& value: partials)
+		{
+			init = std::invoke(reduce, std::move(init), std::move(*value));
+		}
+		return init;
+	}
+
+	// Sorts equally sized runs in parallel and then merges them pairwise, each merge pass is parallel as well.
+	template<std::random_access_iterator TIterator, class TCompare = std::less<>>
+	void Sort(IThreadPool& pool, TIterator first, TIterator last, TCompare&& compare = {}, size_t grainSize = 0)
+	{
+		constexpr size_t minRunSize = 4096;
+
+		const size_t count = static_cast<size_t>(last - first);
+		const size_t runSize = std::max({minRunSize, grainSize, (count + pool.GetConcurrency() - 1) / std::max<size_t>(pool.GetConcurrency(), 1)});
+		const size_t runCount = (count + runSize - 1) / runSize;
+
+		if (runCount <= 1)
+		{
+			std::sort(first, last, compare);
+			return;
+		}
+
+		For(pool, 0, runCount, [&](size_t run)
+		{
+			std::sort(first + run * runSize, first + std::min(run * runSize + runSize, count), std::ref(compare));
+		}, 1);
+
+		for (size_t width = runSize; width < count; width *= 2)
+		{
+			For(pool, 0, (count + 2 * width - 1) / (2 * width), [&](size_t pair)
+			{
+				const size_t low = pair * 2 * width;
+				const size_t middle = std::min(low + width, count);
+				const size_t high = std::min(low + 2 * width, count);
+
+				if (middle < high)
+				{
+					std::inplace_merge(first + low, first + middle, first + high, std::ref(compare));
+				}
+			}, 1);
+		}
+	}
+}
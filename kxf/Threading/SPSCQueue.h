@@ -0,0 +1,126 @@
+#pragma once
+#include "Common.h"
+
+namespace kxf
+{
+	// Bounded lock-free single-producer single-consumer ring. 'TryPush' and 'TryPop' never block, 'Push' and 'Pop' wait
+	// for free space or for an item respectively. After 'Close' pushing fails and popping only drains what's left.
+	template<class T>
+	requires(std::is_trivially_copyable_v<T>)
+	class SPSCQueue final
+	{
+		private:
+			alignas(64) std::atomic<size_t> m_Head = 0;
+			alignas(64) std::atomic<size_t> m_Tail = 0;
+
+			// Incremented on every state change, blocked side waits for it to change
+			alignas(64) std::atomic<uint32_t> m_Signal = 0;
+			std::atomic<bool> m_Closed = false;
+
+			size_t m_Capacity = 0;
+			std::unique_ptr<T[]> m_Items;
+
+		private:
+			void Signal() noexcept
+			{
+				m_Signal.fetch_add(1, std::memory_order_release);
+				m_Signal.notify_all();
+			}
+
+		public:
+			SPSCQueue(size_t capacity)
+				:m_Capacity(std::bit_ceil(std::max<size_t>(capacity, 1))), m_Items(std::make_unique<T[]>(m_Capacity))
+			{
+			}
+			SPSCQueue(const SPSCQueue&) = delete;
+
+		public:
+			size_t GetCapacity() const noexcept
+			{
+				return m_Capacity;
+			}
+			size_t GetSize() const noexcept
+			{
+				return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire);
+			}
+			bool IsEmpty() const noexcept
+			{
+				return GetSize() == 0;
+			}
+			bool IsClosed() const noexcept
+			{
+				return m_Closed.load(std::memory_order_acquire);
+			}
+
+			bool TryPush(T value) noexcept
+			{
+				const size_t tail = m_Tail.load(std::memory_order_relaxed);
+				if (tail - m_Head.load(std::memory_order_acquire) == m_Capacity || IsClosed())
+				{
+					return false;
+				}
+
+				m_Items[tail & (m_Capacity - 1)] = value;
+				m_Tail.store(tail + 1, std::memory_order_release);
+				Signal();
+
+				return true;
+			}
+			bool TryPop(T& value) noexcept
+			{
+				const size_t head = m_Head.load(std::memory_order_relaxed);
+				if (head == m_Tail.load(std::memory_order_acquire))
+				{
+					return false;
+				}
+
+				value = m_Items[head & (m_Capacity - 1)];
+				m_Head.store(head + 1, std::memory_order_release);
+				Signal();
+
+				return true;
+			}
+
+			bool Push(T value) noexcept
+			{
+				while (true)
+				{
+					const uint32_t signal = m_Signal.load(std::memory_order_acquire);
+					if (TryPush(value))
+					{
+						return true;
+					}
+					else if (IsClosed())
+					{
+						return false;
+					}
+					m_Signal.wait(signal, std::memory_order_acquire);
+				}
+			}
+			bool Pop(T& value) noexcept
+			{
+				while (true)
+				{
+					const uint32_t signal = m_Signal.load(std::memory_order_acquire);
+					if (TryPop(value))
+					{
+						return true;
+					}
+					else if (IsClosed() && IsEmpty())
+					{
+						return false;
+					}
+					m_Signal.wait(signal, std::memory_order_acquire);
+				}
+			}
+
+			void Close() noexcept
+			{
+				m_Closed.store(true, std::memory_order_release);
+				Signal();
+			}
+
+		public:
+			SPSCQueue& operator=(const SPSCQueue&) = delete;
+	};
+}
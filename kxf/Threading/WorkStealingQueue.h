@@ -0,0 +1,153 @@
+#pragma once
+#include "Common.h"
+
+namespace kxf
+{
+	// Chase-Lev work-stealing deque. The owning thread pushes and pops at the bottom end,
+	// any other thread can steal from the top end. Only the owner is allowed to call 'Push' and 'Pop'.
+	template<class T>
+	requires(std::is_trivially_copyable_v<T>)
+	class WorkStealingQueue final
+	{
+		private:
+			class Buffer final
+			{
+				private:
+					int64_t m_Capacity = 0;
+					int64_t m_Mask = 0;
+					std::unique_ptr<std::atomic<T>[]> m_Items;
+
+				public:
+					Buffer(int64_t capacity)
+						:m_Capacity(capacity), m_Mask(capacity - 1), m_Items(std::make_unique<std::atomic<T>[]>(static_cast<size_t>(capacity)))
+					{
+					}
+
+				public:
+					int64_t GetCapacity() const noexcept
+					{
+						return m_Capacity;
+					}
+
+					T Get(int64_t index) const noexcept
+					{
+						return m_Items[index & m_Mask].load(std::memory_order_relaxed);
+					}
+					void Put(int64_t index, T value) noexcept
+					{
+						m_Items[index & m_Mask].store(value, std::memory_order_relaxed);
+					}
+
+					std::unique_ptr<Buffer> Grow(int64_t bottom, int64_t top) const
+					{
+						auto buffer = std::make_unique<Buffer>(m_Capacity * 2);
+						for (int64_t i = top; i != bottom; i++)
+						{
+							buffer->Put(i, Get(i));
+						}
+						return buffer;
+					}
+			};
+
+		private:
+			alignas(64) std::atomic<int64_t> m_Top = 0;
+			alignas(64) std::atomic<int64_t> m_Bottom = 0;
+			alignas(64) std::atomic<Buffer*> m_Buffer = nullptr;
+
+			// Thieves may still be reading from a buffer that has been replaced,
+			// so old buffers are kept alive until the queue itself is destroyed.
+			std::vector<std::unique_ptr<Buffer>> m_Buffers;
+
+		public:
+			WorkStealingQueue(size_t capacity = 256)
+			{
+				auto& buffer = m_Buffers.emplace_back(std::make_unique<Buffer>(static_cast<int64_t>(std::bit_ceil(std::max<size_t>(capacity, 2)))));
+				m_Buffer.store(buffer.get(), std::memory_order_relaxed);
+			}
+			WorkStealingQueue(const WorkStealingQueue&) = delete;
+
+		public:
+			bool IsEmpty() const noexcept
+			{
+				return GetSize() == 0;
+			}
+			size_t GetSize() const noexcept
+			{
+				int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+				int64_t top = m_Top.load(std::memory_order_relaxed);
+
+				return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+			}
+
+			// Owner thread only
+			void Push(T value)
+			{
+				int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+				int64_t top = m_Top.load(std::memory_order_acquire);
+				Buffer* buffer = m_Buffer.load(std::memory_order_relaxed);
+
+				if (bottom - top > buffer->GetCapacity() - 1)
+				{
+					buffer = m_Buffers.emplace_back(buffer->Grow(bottom, top)).get();
+					m_Buffer.store(buffer, std::memory_order_release);
+				}
+
+				buffer->Put(bottom, value);
+				std::atomic_thread_fence(std::memory_order_release);
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			std::optional<T> Pop() noexcept
+			{
+				int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+				Buffer* buffer = m_Buffer.load(std::memory_order_relaxed);
+				m_Bottom.store(bottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				int64_t top = m_Top.load(std::memory_order_relaxed);
+				if (top <= bottom)
+				{
+					T value = buffer->Get(bottom);
+					if (top == bottom)
+					{
+						// Last item, race against thieves
+						bool won = m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+						m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+
+						if (!won)
+						{
+							return {};
+						}
+					}
+					return value;
+				}
+				else
+				{
+					m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+					return {};
+				}
+			}
+
+			// Any thread
+			std::optional<T> Steal() noexcept
+			{
+				int64_t top = m_Top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+				if (top < bottom)
+				{
+					Buffer* buffer = m_Buffer.load(std::memory_order_acquire);
+					T value = buffer->Get(top);
+
+					if (m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					{
+						return value;
+					}
+				}
+				return {};
+			}
+
+		public:
+			WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+	};
+}